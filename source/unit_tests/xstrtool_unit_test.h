@@ -2,12 +2,18 @@
 #define XSTRTOOL_UNIT_TEST_H
 
 #include "source/xstrtool.h"
+#include <algorithm>
 #include <cassert>
 #include <chrono>
 #include <codecvt>
+#include <filesystem>
+#include <fstream>
 #include <locale>
+#include <mutex>
 #include <string>
 #include <string_view>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 namespace xstrtool::unit_test
@@ -34,6 +40,10 @@ namespace xstrtool::unit_test
         std::string s = "HeLLo";
         ToLower(s);
         assert(s == "hello");
+        char Buffer[8];
+        assert(ToLowerInto(Buffer, "HeLLo") == 5 && std::string_view(Buffer) == "hello");
+        assert(ToLowerInto(Buffer, "HELLO WORLD") == 7 && std::string_view(Buffer) == "hello w");
+        assert(ToLowerInto(std::span<char>{}, "HELLO") == 0);
 
         // Wide
         assert(ToLowerCopy(std::wstring_view(L"HELLO")) == L"hello");
@@ -42,6 +52,9 @@ namespace xstrtool::unit_test
         std::wstring ws = L"HeLLo";
         ToLower(ws);
         assert(ws == L"hello");
+        wchar_t WBuffer[8];
+        assert(ToLowerInto(WBuffer, L"HeLLo") == 5 && std::wstring_view(WBuffer) == L"hello");
+        assert(ToLowerInto(WBuffer, L"HELLO WORLD") == 7 && std::wstring_view(WBuffer) == L"hello w");
     }
 
     void TestToUpper()
@@ -53,6 +66,9 @@ namespace xstrtool::unit_test
         std::string s = "HeLLo";
         ToUpper(s);
         assert(s == "HELLO");
+        char Buffer[8];
+        assert(ToUpperInto(Buffer, "HeLLo") == 5 && std::string_view(Buffer) == "HELLO");
+        assert(ToUpperInto(Buffer, "hello world") == 7 && std::string_view(Buffer) == "HELLO W");
 
         // Wide
         assert(ToUpperCopy(std::wstring_view(L"hello")) == L"HELLO");
@@ -61,6 +77,8 @@ namespace xstrtool::unit_test
         std::wstring ws = L"HeLLo";
         ToUpper(ws);
         assert(ws == L"HELLO");
+        wchar_t WBuffer[8];
+        assert(ToUpperInto(WBuffer, L"HeLLo") == 5 && std::wstring_view(WBuffer) == L"HELLO");
     }
 
     void TestCompareI()
@@ -82,6 +100,83 @@ namespace xstrtool::unit_test
         assert(CompareI(L"abc", L"") > 0);
     }
 
+    void TestCompareNaturalI()
+    {
+        // Narrow
+        assert(CompareNaturalI("file2", "file10") < 0 && CompareNaturalI("file10", "file2") > 0);
+        assert(CompareNaturalI("File10", "file9") > 0);
+        assert(CompareNaturalI("IMG_0042.png", "img_42.PNG") > 0);       // Same number, more leading zeros goes last
+        assert(CompareNaturalI("a01b", "a1c") < 0);                      // ... but only when everything else is equal
+        assert(CompareNaturalI("a001", "a01") > 0 && CompareNaturalI("a0", "a00") < 0);
+        assert(CompareNaturalI("v1.10", "v1.9") > 0 && CompareNaturalI("v1.9.2", "v1.9.10") < 0);
+        assert(CompareNaturalI("abc", "ABC") == 0 && CompareNaturalI("abc123", "ABC123") == 0);
+        assert(CompareNaturalI("", "") == 0 && CompareNaturalI("", "a") < 0 && CompareNaturalI("1", "") > 0);
+        assert(CompareNaturalI("file", "file1") < 0 && CompareNaturalI("file1", "file") > 0);
+        assert(CompareNaturalI("a1", "ab") < 0 && CompareNaturalI("a", "B") < 0);
+        assert(CompareNaturalI("x123456789012345678901234567890", "x123456789012345678901234567891") < 0);
+        assert(CompareNaturalI("x99999999999999999999999", "x100000000000000000000000") < 0);
+        assert(CompareNaturalI("12a", "12A") == 0 && CompareNaturalI("120", "13") > 0);
+
+        // The difference is past the first vector blocks and inside a digit run that started in the common prefix
+        const std::string Prefix(100, 'p');
+        assert(CompareNaturalI(Prefix + "12345678902", Prefix + "12345678910") < 0);
+        assert(CompareNaturalI(Prefix + "1234567890123456789012345678901234567890x", Prefix + "123456789012345678901234567890123456789y") > 0);
+
+        std::vector<std::string_view> Files = { "file10.txt", "File1.txt", "file2.txt", "file01.txt", "FILE", "file100", "file20" };
+        std::sort(Files.begin(), Files.end(), [](auto A, auto B) { return CompareNaturalI(A, B) < 0; });
+        assert((Files == std::vector<std::string_view>{ "FILE", "File1.txt", "file01.txt", "file2.txt", "file10.txt", "file20", "file100" }));
+
+        // Wide
+        assert(CompareNaturalI(L"file2", L"FILE10") < 0 && CompareNaturalI(L"file10", L"file2") > 0);
+        assert(CompareNaturalI(L"a01b", L"a1c") < 0 && CompareNaturalI(L"a01", L"A1") > 0);
+        assert(CompareNaturalI(std::wstring(40, L'\u0141') + L"77", std::wstring(40, L'\u0141') + L"707") < 0);
+        assert(CompareNaturalI(L"", L"") == 0 && CompareNaturalI(L"x", L"") > 0);
+    }
+
+    void TestSortI()
+    {
+        // Keys compare like CompareI / CompareNaturalI
+        const std::vector<std::string> Samples = { "", "a", "A", "ab", "aB0", "a\x80", "a\x81", "a\x01", "a\x01b", "a\x00", "Z", "[", "file2", "FILE10",
+                                                   "file010", "file10", "file10a", "file1", "x0", "x00", "x", "x000000000000000000000000000000000001", "1", "9", "10", "a9b", "a09c" };
+        for (const std::string& A : Samples)
+        {
+            for (const std::string& B : Samples)
+            {
+                const auto Sign = [](const int V) { return (V > 0) - (V < 0); };
+                assert(Sign(MakeSortKeyI(A).compare(MakeSortKeyI(B))) == Sign(CompareI(A, B)));
+                assert(Sign(MakeSortKeyNaturalI(A).compare(MakeSortKeyNaturalI(B))) == Sign(CompareNaturalI(A, B)));
+            }
+        }
+
+        std::vector<std::string_view> Files = { "file10.txt", "File1.txt", "file2.txt", "file01.txt", "FILE", "file100", "file20" };
+        SortNaturalI(Files);
+        assert((Files == std::vector<std::string_view>{ "FILE", "File1.txt", "file01.txt", "file2.txt", "file10.txt", "file20", "file100" }));
+        SortI(Files);
+        assert((Files == std::vector<std::string_view>{ "FILE", "file01.txt", "File1.txt", "file10.txt", "file100", "file2.txt", "file20" }));
+
+        // Large enough for the radix levels and the parallel top level, with long shared prefixes and duplicates
+        // (all in one buffer, so the input order is the address order)
+        std::string              Storage;
+        std::vector<std::size_t> Ends;
+        for (std::size_t i = 0; i < 100000; ++i)
+        {
+            Storage += std::string(i % 3 ? "Root/" : "root/") + std::to_string((i * 7919) % 1000) + "/Item" + std::to_string((i * 104729) % 5000);
+            Ends.push_back(Storage.size());
+        }
+        std::vector<std::string_view> Views;
+        for (std::size_t i = 0; i < Ends.size(); ++i) Views.push_back(std::string_view(Storage).substr(i ? Ends[i - 1] : 0, Ends[i] - (i ? Ends[i - 1] : 0)));
+        std::vector<std::string_view> Natural = Views;
+        SortI(Views);
+        SortNaturalI(Natural);
+        for (std::size_t i = 1; i < Views.size(); ++i)
+        {
+            assert(CompareI(Views[i - 1], Views[i]) <= 0 && CompareNaturalI(Natural[i - 1], Natural[i]) <= 0);
+
+            // Stable: equal strings keep their input order
+            if (CompareI(Views[i - 1], Views[i]) == 0) assert(Views[i - 1].data() < Views[i].data());
+        }
+    }
+
     void TestFindI()
     {
         // Narrow
@@ -101,6 +196,254 @@ namespace xstrtool::unit_test
         assert(findI(L"Hello World", L"o", 5) == 7);
     }
 
+    void TestFind()
+    {
+        assert(Find("Hello World", "World") == 6 && Find("Hello World", "world") == std::string::npos);
+        assert(Find("Hello World", "o", 5) == 7 && Find("abc", "") == std::string::npos && Find("", "a") == std::string::npos);
+
+        const Finder Searcher("{{name}}");
+        assert(Searcher.Needle() == "{{name}}" && Searcher.Find("Hi {{NAME}} {{name}}") == 12 && !Searcher.Contains("{{name}"));
+
+        // Both anchors in every block position, with a near miss and a case miss in front
+        for (std::size_t Len = 1; Len < 150; Len += 7)
+        {
+            std::string Needle;
+            for (std::size_t i = 0; i < Len; ++i) Needle += "aXb{1 Q"[i % 7];
+            std::string Miss = Needle;
+            Miss.back() = '#';
+            const Finder F(Needle);
+            for (std::size_t Pos = 0; Pos < 70; ++Pos)
+            {
+                const std::string Hay = std::string(Pos, '.') + Miss + ToUpperCopy(Needle) + Needle + "..";
+                const std::size_t Expected = (ToUpperCopy(Needle) == Needle) ? Pos + Len : Pos + 2 * Len;
+                assert(F.Find(Hay) == Expected && Find(Hay, Needle) == Expected);
+            }
+        }
+
+        // In-place Replace when the replacement is not longer than the needle
+        std::string s = "<b>x</b><b>y</b>";
+        Replace(s, "<b>", "[");
+        assert(s == "[x</b>[y</b>");
+        Replace(s, "</b>", "");
+        assert(s == "[x[y");
+        s = "abcabc";
+        Replace(s, "abc", std::string_view(s).substr(1, 2));
+        assert(s == "bcbc");
+        assert(Split("a::b::::c", "::") == std::vector<std::string_view>({ "a", "b", "", "c" }));
+    }
+
+    void TestFindAll()
+    {
+        std::vector<std::size_t> Positions;
+        for (const std::size_t Pos : FindAllI("aAaA-aa", "aa")) Positions.push_back(Pos);
+        assert(Positions == std::vector<std::size_t>({ 0, 2, 5 }));
+
+        Positions.clear();
+        for (const std::size_t Pos : FindAllI("aAaA-aa", "aa", match_mode::OVERLAPPING)) Positions.push_back(Pos);
+        assert(Positions == std::vector<std::size_t>({ 0, 1, 2, 5 }));
+
+        const MatchRange Range = FindAll("x--x--X", "x");
+        assert(std::ranges::distance(Range) == 2 && *std::ranges::next(Range.begin()) == 3);
+        assert(FindAll("abc", "").begin() == std::default_sentinel && FindAllI("", "a").begin() == std::default_sentinel);
+        assert(*MatchRangeI("..Ab", FinderI("aB"), match_mode::NON_OVERLAPPING).begin() == 2);
+
+        // Popcount of the match masks (one and two byte needles) and verified candidates, in every block position
+        std::string Hay;
+        for (std::size_t i = 0; i < 300; ++i) Hay += "aBab.AbA"[i % 8];
+        for (const std::string_view Needle : { "a", "ab", "aba", "bab.a", "ABABABAB" })
+        {
+            std::size_t Overlapping = 0, NonOverlapping = 0;
+            for (std::size_t i = 0; i + Needle.size() <= Hay.size(); ++i)
+            {
+                if (CompareI(Hay.substr(i, Needle.size()), Needle) == 0) ++Overlapping;
+            }
+            for (std::size_t i = findI(Hay, Needle); i != std::string::npos; i = findI(Hay, Needle, i + Needle.size())) ++NonOverlapping;
+
+            assert(CountI(Hay, Needle, match_mode::OVERLAPPING) == Overlapping && CountI(Hay, Needle) == NonOverlapping);
+            assert(Count(ToLowerCopy(Hay), ToLowerCopy(Needle), match_mode::OVERLAPPING) == Overlapping);
+        }
+        assert(CountI("aaaa", "aa") == 2 && CountI("aaaa", "aa", match_mode::OVERLAPPING) == 3 && CountI("abc", "") == 0);
+
+        // ReplaceICopy writes the result at its final size
+        assert(ReplaceICopy("a-A-a", "a", "xyz") == "xyz-xyz-xyz" && ReplaceICopy("AAAA", "aa", "b") == "bb" && ReplaceCopy("abab", "ab", "") == "");
+    }
+
+    void TestFindAny()
+    {
+        const std::vector<std::string_view> Words = { "he", "she", "his", "hers", "" };
+        const pattern_match M = FindAny("ushers", Words);
+        assert(M.m_Offset == 1 && M.m_PatternId == 1);
+        assert(FindAny("ushers", Words, 2).m_Offset == 2 && FindAny("ushers", Words, 2).m_PatternId == 3);
+        assert(FindAny("USHERS", Words).m_Offset == std::string::npos && FindAnyI("USHERS", Words).m_PatternId == 1);
+        assert(FindAny("abc", std::vector<std::string_view>{ "" }).m_Offset == std::string::npos);
+
+        std::vector<pattern_match> All;
+        MultiFinder(Words).FindAll("ushers", All);
+        assert(All.size() == 3 && All[0].m_Offset == 1 && All[0].m_PatternId == 1 && All[1].m_Offset == 2 && All[1].m_PatternId == 0 && All[2].m_PatternId == 3);
+
+        // Small sets take the Teddy path and large sets the Aho-Corasick one, both must agree with a plain scan
+        std::vector<std::string> Storage;
+        for (int i = 0; i < 200; ++i) Storage.push_back("Key" + std::string(1, static_cast<char>('a' + i % 26)) + std::to_string(i));
+        const std::string Hay = std::string(100, '.') + "x KEYq16 KEYF5 KEYr17 key";
+        for (const std::size_t Count : { std::size_t(3), std::size_t(20), std::size_t(200) })
+        {
+            const std::vector<std::string_view> Patterns(Storage.begin(), Storage.begin() + Count);
+            const MultiFinderI                  Finder(Patterns);
+            assert(Finder.size() == Count && Finder.Pattern(0) == "keya0");
+
+            std::size_t Expected = std::string::npos, ExpectedId = 0;
+            for (std::size_t i = 0; i < Count; ++i)
+            {
+                const std::size_t Pos = findI(Hay, Patterns[i]);
+                if (Pos < Expected) { Expected = Pos; ExpectedId = i; }
+            }
+            const pattern_match Got = Finder.Find(Hay);
+            assert(Got.m_Offset == Expected && (Expected == std::string::npos || Got.m_PatternId == ExpectedId));
+            assert(Finder.Contains(Hay) == (Expected != std::string::npos) && !MultiFinder(Patterns).Contains(Hay));
+        }
+
+        // Every byte value in the patterns
+        std::string Bytes;
+        for (int c = 0; c < 256; ++c) Bytes += static_cast<char>(c);
+        std::vector<std::string_view> Singles;
+        for (std::size_t i = 0; i < Bytes.size(); ++i) Singles.push_back(std::string_view(Bytes).substr(i, 1));
+        assert(FindAny("\xFF\x01", Singles).m_PatternId == 0xFF && FindAnyI("q", Singles).m_PatternId == 'Q');
+    }
+
+    void TestStreamFinder()
+    {
+        // Matches inside a chunk, across one boundary and across several short chunks
+        const std::string_view Chunks[] = { "xxNeed", "LEyyneed", "l", "e", "", "zNEEDLENEEDLE" };
+        std::vector<pattern_match> Matches, All;
+        StreamFinderI Stream("needle");
+        for (const std::string_view Chunk : Chunks)
+        {
+            Stream.Feed(Chunk, Matches);
+            All.insert(All.end(), Matches.begin(), Matches.end());
+        }
+        assert(All.size() == 4 && All[0].m_Offset == 2 && All[1].m_Offset == 10 && All[2].m_Offset == 17 && All[3].m_Offset == 23);
+        assert(Stream.Offset() == 29);
+
+        // A new stream starts at offset 0, the case-sensitive version skips the other cases
+        Stream.Reset();
+        Stream.Feed("neeDLE", Matches);
+        assert(Matches.size() == 1 && Matches[0].m_Offset == 0);
+        StreamFinder Exact("needle");
+        Exact.Feed("xneed", Matches);
+        assert(Matches.empty());
+        Exact.Feed("leNEEDLE", Matches);
+        assert(Matches.size() == 1 && Matches[0].m_Offset == 1);
+
+        // Pattern sets report overlapping matches, byte by byte as well
+        const std::string_view Patterns[] = { "he", "she", "hers", "his" };
+        StreamFinderI Multi(Patterns);
+        All.clear();
+        for (const char C : std::string_view("USHERS his"))
+        {
+            Multi.Feed(std::string_view(&C, 1), Matches);
+            All.insert(All.end(), Matches.begin(), Matches.end());
+        }
+        assert(All.size() == 4);
+        assert(All[0].m_Offset == 1 && All[0].m_PatternId == 1 && All[1].m_Offset == 2 && All[1].m_PatternId == 0);
+        assert(All[2].m_Offset == 2 && All[2].m_PatternId == 2 && All[3].m_Offset == 7 && All[3].m_PatternId == 3);
+
+        StreamFinder Empty;
+        Empty.Feed("abc", Matches);
+        assert(Matches.empty() && Empty.Offset() == 3);
+    }
+
+    void TestSearchFile()
+    {
+        const std::string Path = (std::filesystem::temp_directory_path() / "xstrtool_search_file_test.txt").string();
+        {
+            // Enough lines for several shards, with a few matches in each and windows line ends in some
+            std::ofstream File(Path, std::ios::binary);
+            for (int i = 0; i < 60000; ++i)
+            {
+                File << "line " << i << ((i % 7000 == 3) ? " Disk FULL, disk full" : " nothing to see here, just padding the shards") << ((i % 2) ? "\r\n" : "\n");
+            }
+            File << "last disk full";
+        }
+
+        const file_search_result Result = SearchFile(Path, "DISK FULL");
+        assert(Result.m_bOpened && !Result.m_bStopped && Result.m_Matches.size() == 19);
+        for (std::size_t i = 0; i + 1 < Result.m_Matches.size(); i += 2)
+        {
+            const std::size_t Line = i / 2 * 7000 + 4;
+            assert(Result.m_Matches[i].m_Line == Line && Result.m_Matches[i + 1].m_Line == Line);
+            assert(Result.m_Matches[i].m_Column == Result.m_Matches[i + 1].m_Column - 11);
+            assert(Result.m_Matches[i].m_LineView == "line " + std::to_string(Line - 1) + " Disk FULL, disk full");
+        }
+        assert(Result.m_Matches.back().m_Line == 60001 && Result.m_Matches.back().m_Column == 5 && Result.m_Matches.back().m_LineView == "last disk full");
+
+        // Case, match limit, stop flag and missing files
+        search_options Options;
+        Options.m_bIgnoreCase = false;
+        assert(SearchFile(Path, "disk full", Options).m_Matches.size() == 10);
+        Options.m_MaxMatches = 3;
+        const file_search_result Limited = SearchFile(Path, "disk full", Options);
+        assert(Limited.m_Matches.size() == 3 && Limited.m_Matches[2].m_Line == 14004);
+
+        const std::atomic<bool> bStop{ true };
+        Options.m_pStop = &bStop;
+        assert(SearchFile(Path, "disk full", Options).m_bStopped && SearchFile(Path, "", {}).m_Matches.empty());
+        assert(SearchFile(Path, "disk\nfull").m_Matches.empty());
+
+        std::filesystem::remove(Path);
+        assert(!SearchFile(Path, "disk").m_bOpened);
+    }
+
+    void TestParallelFindI()
+    {
+        // Matches across the block boundaries (every 1 MB of candidates) and the first one wins
+        std::string Hay(3 * 1024 * 1024 + 100, '.');
+        Hay.replace(2 * 1024 * 1024 - 3, 6, "NeEdLe");
+        Hay.replace(1024 * 1024 - 2, 6, "needle");
+        assert(ParallelFindI(Hay, "NEEDLE", 0, 0) == 1024 * 1024 - 2 && ParallelContainsI(Hay, "needle", 0));
+        assert(ParallelFindI(Hay, "needle", 1024 * 1024, 0) == 2 * 1024 * 1024 - 3);
+        assert(ParallelFindI(Hay, "needle", 2 * 1024 * 1024, 0) == std::string::npos && !ParallelContainsI(Hay, "needles", 0));
+
+        // Small haystacks and the edge cases behave like findI/ContainsI
+        assert(ParallelFindI("abcABC", "C", 3) == 5 && ParallelFindI("abc", "") == findI("abc", "") && ParallelContainsI("abc", ""));
+        assert(ParallelFindI(Hay, "x", Hay.size(), 0) == std::string::npos && ParallelFindI(Hay, Hay + ".", 0, 0) == std::string::npos);
+    }
+
+    void TestFinderI()
+    {
+        const FinderI Finder("ERROR:");
+        assert(Finder.Needle() == "error:" && Finder.size() == 6);
+        assert(Finder.Find("[Error: disk] [ERROR: net]") == 1);
+        assert(Finder.Find("[Error: disk] [ERROR: net]", 2) == 15);
+        assert(Finder.Find("error") == std::string::npos && !Finder.Contains("errors: none"));
+        assert(FinderI().Find("abc") == std::string::npos && FinderI().Contains("abc"));
+        assert(FinderI("a").Find("bbbA") == 3 && FinderI("A").Find("bbba", 4) == std::string::npos);
+
+        // Anchors at every offset of every block, with near misses in front
+        for (std::size_t Len = 1; Len < 150; Len += 7)
+        {
+            std::string Needle;
+            for (std::size_t i = 0; i < Len; ++i) Needle += "aXb{1 Q"[i % 7];
+            std::string Miss = Needle;
+            Miss.back() = '#';
+            const FinderI F(Needle);
+            for (std::size_t Pos = 0; Pos < 70; ++Pos)
+            {
+                const std::string Hay = std::string(Pos, '.') + Miss + ToUpperCopy(Needle) + "..";
+                assert(F.Find(Hay) == Pos + Len && findI(Hay, Needle) == Pos + Len);
+                assert(F.Find(Hay, Pos + Len + 1) == std::string::npos);
+            }
+        }
+
+        // Long periodic needles go through the Two-Way search
+        const std::string Period = "abaabAbaab";
+        std::string       Long;
+        while (Long.size() < 100) Long += Period;
+        const std::string Hay = Long.substr(0, 95) + "x" + Long + Long.substr(0, 3);
+        assert(FinderI(Long).Find(Hay) == 96 && findI(Hay, Long) == 96 && FinderI(Long).Find(Hay, 97) == std::string::npos);
+        assert(FinderI(Long + "c").Find(Long + Long) == std::string::npos);
+        assert(ContainsI(Hay, ToUpperCopy(Long)) && ReplaceICopy("aBc-ABC-abc", "abc", "x") == "x-x-x");
+    }
+
     void TestStartsWithI()
     {
         // Narrow
@@ -135,6 +478,33 @@ namespace xstrtool::unit_test
         assert(!EndsWithI(L"abc", L"abcd"));
     }
 
+    void TestStartsWithAnyI()
+    {
+        // The longest prefix wins, whatever its position in the list
+        const std::string_view Routes[] = { "/api/", "/API/v1/", "/static/", "/api/v1/users/", "/api/v1/USERS/", "" };
+        const PrefixSetI       Router(Routes);
+        assert(StartsWithAnyI("/Api/V1/Users/42", Router) == 3 && StartsWithAnyI("/api/v1/user", Router) == 1);
+        assert(StartsWithAnyI("/api", Router) == 5 && StartsWithAnyI("/STATIC/a.png", Router) == 2 && Router.size() == 6);
+        assert(StartsWithAnyI("/api/v2", std::span<const std::string_view>(Routes, 5)) == 0 && StartsWithAnyI("/x", std::span<const std::string_view>(Routes, 5)) == std::string::npos);
+
+        const std::string_view Extensions[] = { ".gz", ".tar.gz", ".TXT", "z" };
+        const SuffixSetI       Classifier(Extensions);
+        assert(EndsWithAnyI("Backup.TAR.GZ", Classifier) == 1 && EndsWithAnyI("notes.gz", Classifier) == 0);
+        assert(EndsWithAnyI("readme.txt", Classifier) == 2 && EndsWithAnyI("quiz", Classifier) == 3 && EndsWithAnyI("", Classifier) == std::string::npos);
+        assert(EndsWithAnyI("a.bin", Extensions) == std::string::npos && PrefixSetI().Match("abc") == std::string::npos);
+
+        // More children than a SIMD block in one node
+        std::vector<std::string> Names;
+        for (char C = '!'; C <= '~'; ++C) Names.push_back(std::string(1, C) + "x");
+        const std::vector<std::string_view> Views(Names.begin(), Names.end());
+        const PrefixSetI                    Wide(Views);
+        for (std::size_t i = 0; i < Names.size(); ++i)
+        {
+            const std::size_t Expected = (Names[i][0] >= 'a' && Names[i][0] <= 'z') ? i - 32 : i;      // The uppercase entry has the lower id
+            assert(Wide.Match(Names[i] + "yz") == Expected && Wide.Match(Names[i].substr(0, 1)) == std::string::npos);
+        }
+    }
+
     void TestContainsI()
     {
         // Narrow
@@ -204,6 +574,193 @@ namespace xstrtool::unit_test
         assert(wv1.size() == 3 && wv1[0] == L"abc" && wv1[1] == L"def" && wv1[2] == L"ghi");
     }
 
+    void TestSplitRange()
+    {
+        // Same parts as Split, including the empty ones
+        const std::string_view Inputs[] = { "a,b,c", "", ",", "a,,b,", ",a", "no delimiter" };
+        for (const std::string_view Input : Inputs)
+        {
+            const std::vector<std::string_view> Parts = Split(Input, ',');
+            assert(std::ranges::equal(SplitRange(Input, ','), Parts));
+        }
+        assert(*SplitRange("GET /index.html HTTP/1.1", ' ').begin() == "GET" && std::ranges::distance(SplitRange("", ',')) == 1);
+
+        // Many parts in one window and parts across windows
+        std::string Log;
+        for (int i = 0; i < 100; ++i) Log += std::string(static_cast<std::size_t>(i % 7) * 20, 'x') + " " + std::to_string(i) + ",";
+        assert(std::ranges::equal(SplitRange(Log, ','), Split(std::string_view(Log), ',')));
+        assert(std::ranges::equal(SplitRange(Log, ' '), Split(std::string_view(Log), ' ')));
+
+        // String delimiters do not overlap and can cross a window
+        assert(std::ranges::equal(SplitRange("abc--def--ghi", "--"), Split("abc--def--ghi", "--")));
+        assert(std::ranges::equal(SplitRange("a---b-", "--"), Split("a---b-", "--")));
+        const std::string Long = std::string(63, 'a') + "::" + std::string(70, 'b') + ":" + "::";
+        assert(std::ranges::equal(SplitRange(Long, "::"), Split(std::string_view(Long), "::")));
+
+        // Usable with std::ranges algorithms and copied iterators
+        const auto Fields = SplitRange("k1=v1;k2=v2;k3=v3", ';');
+        assert(std::ranges::count_if(Fields, [](const std::string_view Field) { return Field.starts_with("k"); }) == 3);
+        assert(std::ranges::find(Fields, "k2=v2") != Fields.end());
+        auto It = Fields.begin();
+        const auto Copy = It++;
+        assert(*Copy == "k1=v1" && *It == "k2=v2" && Copy != It && ++It != Fields.end() && ++It == Fields.end());
+
+        // Wide
+        std::wstring WideLog;
+        for (int i = 0; i < 40; ++i) WideLog += std::wstring(static_cast<std::size_t>(i % 5) * 9, L'w') + L"|";
+        assert(std::ranges::equal(SplitRangeW(WideLog, L'|'), Split(std::wstring_view(WideLog), L'|')));
+        assert(std::ranges::equal(SplitRangeW(L"abc--def--ghi", L"--"), Split(L"abc--def--ghi", L"--")));
+        assert(std::ranges::distance(SplitRangeW(L"", L',')) == 1);
+    }
+
+    void TestSplitInto()
+    {
+        assert(CountSplits("a,b,,c", ',') == 4 && CountSplits("", ',') == 1 && CountSplits("a--b---c", "--") == 3);
+        assert(CountSplits(L"a,b,,c", L',') == 4 && CountSplits(L"a--b---c", L"--") == 3);
+
+        // Sized once with CountSplits, then filled
+        std::string Csv;
+        for (int i = 0; i < 200; ++i) Csv += std::to_string(i * 7) + ((i % 3) ? "," : ",,");
+        std::vector<std::string_view> Scratch(CountSplits(Csv, ','));
+        assert(SplitInto(Scratch, Csv, ',') == Scratch.size() && Scratch == Split(std::string_view(Csv), ','));
+
+        // A span that is too small keeps the first parts and the result tells how many were needed
+        std::string_view Small[3];
+        assert(SplitInto(Small, "a,b,c,d,e", ',') == 5 && Small[0] == "a" && Small[2] == "c");
+        assert(SplitInto(Small, "a::b::c::d", "::") == 4 && Small[2] == "c");
+        assert(SplitInto(Small, "a::b", "::") == 2 && Small[1] == "b");
+        assert(SplitInto(std::span<std::string_view>(), "x,y", ',') == 2);
+
+        // Wide
+        std::wstring_view WideParts[4];
+        assert(SplitInto(WideParts, L"a|b||c", L'|') == 4 && WideParts[2] == L"" && WideParts[3] == L"c");
+        assert(SplitInto(WideParts, L"a<>b<>c<>d<>e", L"<>") == 5 && WideParts[3] == L"d");
+    }
+
+    void TestCharSet()
+    {
+        const CharSet Delims(",;|\t");
+        assert(Delims.Contains(';') && !Delims.Contains('a') && Delims.Contains(L'|') && !Delims.Contains(L'\x10c'));
+        assert(SplitAny("a,b;c||d\te", Delims) == Split("a,b,c,,d,e", ','));
+        assert(SplitAny("", Delims).size() == 1 && SplitAny(";", Delims).size() == 2);
+
+        // Same results as std::string_view, also across SIMD blocks
+        std::string Text;
+        for (int i = 0; i < 300; ++i) Text += static_cast<char>("abc \t,\x80\xff"[i % 8] + (i % 13 == 0));
+        const std::string_view View(Text);
+        const std::string_view Sets[] = { " \t", ",", "\x80\xff", "abcd", "" };
+        for (const std::string_view Chars : Sets)
+        {
+            const CharSet Set(Chars);
+            for (std::size_t Pos : { std::size_t(0), std::size_t(5), std::size_t(70), std::size_t(299), std::size_t(400) })
+            {
+                assert(FindFirstOf(View, Set, Pos) == View.find_first_of(Chars, Pos));
+                assert(FindLastOf(View, Set, Pos) == View.find_last_of(Chars, Pos));
+                assert(Chars.empty() || FindFirstNotOf(View, Set, Pos) == View.find_first_not_of(Chars, Pos));
+            }
+        }
+
+        // Every byte in the set costs the same
+        std::string AllBytes;
+        for (int i = 1; i < 256; ++i) AllBytes += static_cast<char>(i);
+        const CharSet All(AllBytes);
+        assert(FindFirstNotOf(std::string(100, 'x') + '\0' + "y", All) == 100 && FindFirstOf(std::string(70, '\0') + "\xfe", All) == 70);
+
+        // Wide, with characters above U+00FF
+        const std::wstring_view WideText = L"key = value\x2028next\x0120line";
+        const CharSet           WideSet(std::wstring_view(L" =\x2028"));
+        assert(FindFirstOf(WideText, WideSet) == 3 && FindLastOf(WideText, WideSet) == 11 && FindFirstNotOf(WideText, WideSet, 3) == 6);
+        assert(SplitAny(WideText, CharSet(std::wstring_view(L"\x2028\x0120"))).size() == 3 && FindFirstOf(WideText, CharSet(std::wstring_view(L"\x20"))) == 3);
+        assert(SplitAny(std::wstring_view(L"a\tb c"), CharSet(" \t")) == Split(L"a b c", L' '));
+    }
+
+    void TestCsvReader()
+    {
+        const std::string_view Csv = "id,name,notes\r\n"
+                                     "1,\"Smith, John\",\"said \"\"hi\"\"\"\r\n"
+                                     "2,\"multi\nline\",\r\n"
+                                     "\n"
+                                     "3,plain,\"\"";
+        CsvReader                  Reader(Csv);
+        std::span<const csv_field> Record;
+        std::string                Scratch;
+
+        assert(Reader.Next(Record) && Record.size() == 3 && Record[0].m_Raw == "id" && Record[2].m_Raw == "notes");
+
+        // Fields point into the buffer, only the escaped one is unescaped
+        assert(Reader.Next(Record) && Record.size() == 3 && Record[1].m_bQuoted && !Record[1].m_bEscaped);
+        assert(Record[1].Value(Scratch) == "Smith, John" && Record[1].Value(Scratch).data() > Csv.data() && Record[1].Value(Scratch).data() < Csv.data() + Csv.size());
+        assert(Record[2].m_bEscaped && Record[2].m_Raw == "said \"\"hi\"\"" && Record[2].Value(Scratch) == "said \"hi\"");
+
+        // Quoted newlines stay in the field, a blank line is one empty field
+        assert(Reader.Next(Record) && Record.size() == 3 && Record[1].m_Raw == "multi\nline" && Record[2].m_Raw.empty());
+        assert(Reader.Next(Record) && Record.size() == 1 && Record[0].m_Raw.empty());
+        assert(Reader.Next(Record) && Record.size() == 3 && Record[1].m_Raw == "plain" && Record[2].m_bQuoted && Record[2].m_Raw.empty());
+        assert(!Reader.Next(Record) && Reader.Offset() == Csv.size() && !CsvReader("").Next(Record));
+
+        // TSV, records and quoted fields across SIMD windows
+        std::string Tsv;
+        for (int i = 0; i < 200; ++i) Tsv += std::to_string(i) + "\t\"" + std::string(static_cast<std::size_t>(i % 90), 'q') + "\t\n\"\t" + ((i % 7) ? "x" : "\"y\"\"\"") + "\n";
+        CsvReader Rows(Tsv, '\t');
+        int       nRows = 0;
+        while (Rows.Next(Record))
+        {
+            assert(Record.size() == 3 && Record[0].m_Raw == std::to_string(nRows));
+            assert(Record[1].m_Raw == std::string(static_cast<std::size_t>(nRows % 90), 'q') + "\t\n");
+            assert(Record[2].Value(Scratch) == ((nRows % 7) ? "x" : "y\""));
+            ++nRows;
+        }
+        assert(nRows == 200);
+    }
+
+    void TestSplitLinesParallel()
+    {
+        // Gathers the lines (and checks the numbering inside each batch) from any worker
+        const auto Collect = [](const std::string_view Buffer, std::vector<std::pair<std::size_t, std::string_view>>& Lines)
+        {
+            std::mutex Lock;
+            Lines.clear();
+            const std::size_t Count = SplitLinesParallel(Buffer, [&](const line_batch& Batch)
+            {
+                std::scoped_lock Guard(Lock);
+                for (std::size_t i = 0; i < Batch.m_Lines.size(); ++i) Lines.emplace_back(Batch.m_FirstLine + i, Batch.m_Lines[i]);
+            });
+            std::sort(Lines.begin(), Lines.end());
+            return Count;
+        };
+        std::vector<std::pair<std::size_t, std::string_view>> Lines;
+
+        // CRLF, no new line at the end, a final new line does not start a line
+        assert(Collect("one\r\ntwo\n\nfour", Lines) == 4 && Lines.size() == 4);
+        assert(Lines[0].first == 1 && Lines[0].second == "one" && Lines[1].second == "two" && Lines[2].second.empty() && Lines[3].first == 4 && Lines[3].second == "four");
+        assert(Collect("a\r\n", Lines) == 1 && Lines.size() == 1 && Lines[0].second == "a");
+        assert(Collect("\n", Lines) == 1 && Lines.size() == 1 && Lines[0].second.empty());
+        assert(Collect("", Lines) == 0 && Lines.empty());
+
+        // Several chunks, lines crossing the chunk edges (one longer than a chunk) and a CRLF split by an edge
+        std::string Big;
+        for (std::size_t i = 0; Big.size() < 10 * 256 * 1024; ++i)
+        {
+            if (i == 1000) Big.append(700 * 1024, 'x');
+            Big += "line " + std::to_string(i);
+            Big.append(i % 37, '-');
+            Big += (i % 3) ? "\n" : "\r\n";
+        }
+        Big.append(12 * 256 * 1024 - 1 - Big.size(), 'y');
+        Big += "\r\n";
+        Big.append(300 * 1024, 'z');
+        Big += "\nlast";
+
+        const auto Expected = Split(std::string_view(Big), '\n');
+        assert(Collect(Big, Lines) == Expected.size() && Lines.size() == Expected.size());
+        for (std::size_t i = 0; i < Lines.size(); ++i)
+        {
+            std::string_view Line = Expected[i];
+            if (Line.ends_with('\r')) Line.remove_suffix(1);
+            assert(Lines[i].first == i + 1 && Lines[i].second == Line && Lines[i].second.data() == Line.data());
+        }
+    }
+
     void TestJoin()
     {
         // Narrow
@@ -280,6 +837,32 @@ namespace xstrtool::unit_test
         assert(ws == L"path/file.txt");
     }
 
+    void TestGlob()
+    {
+        const Glob Textures("*.tex*");
+        assert(Textures.Match("stone.tex") && Textures.Match("stone.texture") && !Textures.Match("stone.png") && !Textures.Match("maps/stone.tex"));
+        assert(Textures.Match(PathBaseName("maps/stone.tex")) && !Textures.Match("stone.TEX"));
+
+        // "**" matches any number of whole components, including none
+        const Glob Cache("**/cache/*.bin");
+        assert(Cache.Match("cache/x.bin") && Cache.Match("a/b/cache/x.bin") && Cache.Match("a\\cache\\x.bin"));
+        assert(!Cache.Match("a/cache/b/x.bin") && !Cache.Match("a/xcache/x.bin") && !Cache.Match("cache/x.bin.bak"));
+        assert(Glob("src/**/test/**/*.cpp").Match("src/a/test/b/c/t.cpp") && Glob("src/**/test/**/*.cpp").Match("src/test/t.cpp"));
+        assert(!Glob("src/**/test/**/*.cpp").Match("src/a/b/t.cpp") && Glob("**").Match("any/thing") && Glob("a/**").Match("a"));
+
+        // '?', classes, negated classes and a '[' that is never closed
+        assert(Glob("file?.dat").Match("file1.dat") && !Glob("file?.dat").Match("file.dat") && !Glob("file?.dat").Match("file12.dat"));
+        assert(Glob("log[0-9][0-9].txt").Match("log42.txt") && !Glob("log[0-9][0-9].txt").Match("log4x.txt"));
+        assert(Glob("[!.]*").Match("visible") && !Glob("[!.]*").Match(".hidden") && Glob("[]a]").Match("]"));
+        assert(Glob("a[b").Match("a[b") && Glob("*a*b*a*").Match("xxaxbyya") && !Glob("*a*b*a*").Match("xxaxby"));
+        assert(Glob("").Match("") && !Glob("").Match("a") && !Glob().Match("") && !Glob("a/b").Match("a"));
+
+        // Case insensitive, also for classes
+        const GlobI Images("Assets/**/*.[PJ][NP]G");
+        assert(Images.Match("assets/ui/Logo.png") && Images.Match("ASSETS/icon.JpG") && !Images.Match("assets/ui/logo.gif"));
+        assert(GlobI(PathNormalizeCopy(std::string("Data\\..\\Maps\\*.MAP"))).Match("maps/level1.map") && GlobI("[!a-c]x").Match("Dx") && !GlobI("[!a-c]x").Match("Bx"));
+    }
+
     void TestFormatTime()
     {
         auto now = std::chrono::system_clock::now();
@@ -333,6 +916,89 @@ namespace xstrtool::unit_test
         assert(SHA256("") == "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855");
     }
 
+    void TestHashI()
+    {
+        const HashI  H;
+        const EqualI Eq;
+        assert(H("") == H(std::string_view{}));
+        assert(H("Content-Type") == H("content-TYPE") && Eq("Content-Type", "CONTENT-type"));
+        assert(H("abc") != H("abd") && !Eq("abc", "abd") && !Eq("abc", "abcd"));
+        assert(H("a") != H(std::string_view("a\0", 2)));
+        assert(H(L"Content-Type") == H(L"CONTENT-TYPE") && Eq(L"Content-Type", L"content-type"));
+        assert(H(L"\u0141x") != H(L"\u0142x") && !Eq(L"\u0141", L"\u0142"));
+
+        // Long strings, a difference in any position (also in the overlapping last stripe) changes the hash
+        std::string Long;
+        for (int i = 0; i < 100; ++i) Long += static_cast<char>('A' + i % 26);
+        for (std::size_t i = 0; i < Long.size(); ++i)
+        {
+            std::string Diff = Long;
+            Diff[i] = '#';
+            assert(H(Diff) != H(Long) && H(ToLowerCopy(Long)) == H(Long));
+        }
+
+        // Stripes in a different order must not collide
+        const std::string A(32, 'a'), B(32, 'b');
+        assert(H(A + B) != H(B + A));
+
+        // Heterogeneous lookup, the probes never build a std::string
+        std::unordered_map<std::string, int, HashI, EqualI> Map;
+        Map.emplace("Content-Length", 1);
+        Map.emplace("ACCEPT", 2);
+        assert(Map.find(std::string_view("content-length"))->second == 1);
+        assert(Map.find("accept")->second == 2);
+        assert(Map.contains("Accept") && !Map.contains("Accepts"));
+        assert(!Map.emplace("accept", 3).second && Map.size() == 2);
+
+        std::unordered_set<std::wstring, HashI, EqualI> Set{ L"Alpha", L"Beta" };
+        assert(Set.contains(std::wstring_view(L"ALPHA")) && !Set.contains(L"Gamma"));
+    }
+
+    void TestBatch()
+    {
+        assert(CRC32("123456789") == 0xCBF43926);
+
+        // Small batch (runs on the calling thread) and a large one (about 2MB, split across threads)
+        for (const std::size_t Count : { std::size_t{ 7 }, std::size_t{ 40000 } })
+        {
+            std::vector<std::string> Strings(Count);
+            for (std::size_t i = 0; i < Count; ++i)
+            {
+                Strings[i] = std::string(i % 3, ' ') + std::string(i % 97, "Ab\tC,z"[i % 7]) + std::to_string(i) + std::string(i % 5, '\n');
+            }
+            const std::vector<std::string_view> Views(Strings.begin(), Strings.end());
+
+            std::vector<std::size_t>   Hashes(Count), HashesS(Count);
+            std::vector<std::uint32_t> Crcs(Count), CrcsS(Count);
+            BatchHash(Views, Hashes);
+            BatchHash(Strings, HashesS);
+            BatchCRC32(Views, Crcs);
+            BatchCRC32(Strings, CrcsS);
+
+            std::vector<std::string_view> Trimmed(Count);
+            BatchTrim(Views, Trimmed);
+
+            std::vector<std::string> Lowered(Count, "old contents");
+            BatchToLower(Views, Lowered);
+
+            for (std::size_t i = 0; i < Count; ++i)
+            {
+                assert(Hashes[i] == Hash(Strings[i]) && HashesS[i] == Hashes[i]);
+                assert(Crcs[i] == CRC32(Strings[i]) && CrcsS[i] == Crcs[i]);
+                assert(Trimmed[i] == TrimCopy(Strings[i]));
+                assert(Lowered[i] == ToLowerCopy(Strings[i]));
+            }
+
+            std::vector<std::string> InPlace = Strings;
+            BatchTrim(InPlace);
+            BatchToLower(InPlace);
+            for (std::size_t i = 0; i < Count; ++i) assert(InPlace[i] == ToLowerCopy(TrimCopy(Strings[i])));
+        }
+
+        BatchToLower(std::span<std::string>{});
+        BatchHash(std::span<const std::string_view>{}, std::span<std::size_t>{});
+    }
+
     void TestUnicode()
     {
         // ASCII-compatible UTF-8
@@ -352,6 +1018,53 @@ namespace xstrtool::unit_test
         assert(UTF16ToUTF8(L"") == "");
     }
 
+    void TestCaseFoldU8()
+    {
+        // "\xC3\x84RGER" is "ÄRGER", "stra\xC3\x9F" is "straße" (no simple fold for ß)
+        assert(FoldCaseU8Copy("\xC3\x84RGER") == "\xC3\xA4rger");
+        assert(FoldCaseU8Copy("Stra\xC3\x9F" "e") == "stra\xC3\x9F" "e");
+        assert(FoldCaseU8Copy("\xCE\xA3\xCE\x8A\xCF\x82") == "\xCF\x83\xCE\xAF\xCF\x83");    // ΣΊς -> σίσ
+        assert(FoldCaseU8Copy("\xE2\x84\xAA\xC5\xBF") == "ks");                                // Kelvin sign, long s
+        assert(FoldCaseU8Copy("\xC8\xBA") == "\xE2\xB1\xA5");                                 // Ⱥ -> ⱥ grows a byte
+        assert(FoldCaseU8Copy("A\xFF\xC3Z") == "a\xFF\xC3z");                                  // Invalid bytes stay
+        assert(FoldCaseU8Copy("").empty());
+
+        assert(CompareIU8("\xC3\x84RGER", "\xC3\xA4rger") == 0);
+        assert(CompareIU8("\xC3\xA4rger", "\xC3\x84RGERN") < 0);
+        assert(CompareIU8("\xC3\xB6", "\xC3\xA4") > 0);
+        assert(CompareIU8("Kelvin", "\xE2\x84\xAA" "ELVIN") == 0);
+        assert(CompareIU8("abc", "ABD") < 0 && CompareIU8("", "") == 0 && CompareIU8("a", "") > 0);
+
+        assert(FindIU8("Das ist \xC3\x84RGERlich", "\xC3\xA4rger") == 8);
+        assert(FindIU8("Das ist \xC3\x84RGERlich", "LICH") == 14);
+        assert(FindIU8("2 \xE2\x84\xAA", "k") == 2);
+        assert(FindIU8("\xC3\xA4rger", "\xC3\xA4rger", 1) == std::string::npos);
+        assert(FindIU8("abc", "") == std::string::npos && FindIU8("abc", "abcd") == std::string::npos);
+
+        // Overlong forms, surrogates and code points above U+10FFFF are invalid bytes, kept as they are
+        for (const std::string_view Bad : { std::string_view("\xE0\x81\x81"), std::string_view("\xED\xA0\x80"), std::string_view("\xF4\x90\x80\x80"), std::string_view("\xF0\x80\x81\x81") })
+        {
+            assert(FoldCaseU8Copy(Bad) == Bad && CompareIU8(Bad, Bad) == 0);
+            assert(CompareIU8(Bad, "a") != 0 && CompareIU8(Bad, Bad.substr(0, 1)) > 0 && CompareIU8(Bad, "\x80") != 0);
+            assert(FindIU8(std::string("x") + std::string(Bad) + "y", "a") == std::string::npos && FindIU8(std::string("x") + std::string(Bad) + "y", Bad) == 1);
+        }
+        assert(CompareIU8("\xF4\x90\x82\x80", "\x80") != 0 && FoldCaseU8Copy("\xF4\xBF\xBF\xBF") == "\xF4\xBF\xBF\xBF");
+        assert(FoldCaseU8Copy("\xF4\x8F\xBF\xBF\xED\x9F\xBF") == "\xF4\x8F\xBF\xBF\xED\x9F\xBF");                // U+10FFFF and U+D7FF are valid
+
+        // Long inputs so the ASCII runs cross the vector blocks
+        std::string Mixed, Folded;
+        for (int i = 0; i < 40; ++i)
+        {
+            Mixed  += std::string(i, static_cast<char>('A' + i % 26)) + "\xC3\x84" + "\xE2\x84\xAA";
+            Folded += std::string(i, static_cast<char>('a' + i % 26)) + "\xC3\xA4" + "k";
+        }
+        assert(FoldCaseU8Copy(Mixed) == Folded && CompareIU8(Mixed, Folded) == 0);
+        assert(CompareIU8(Mixed + "a", Folded + "B") < 0);
+        assert(FindIU8(Mixed + "Needle \xC3\x84", "needle \xC3\xA4") == Mixed.size());
+        assert(FindIU8(Folded + "NEEDLE", "needle") == Folded.size());
+        assert(FindIU8(Mixed, "\xC3\xA4" "k" "qr") == std::string::npos && FindIU8(Mixed, "\xC3\xA4" "k" "aaaa") != std::string::npos);
+    }
+
     void TestLocale()
     {
         std::wstring ws = L"HELLO";
@@ -362,6 +1075,39 @@ namespace xstrtool::unit_test
         assert(ws == L"HELLO");
         assert(ToLowerLocale(L"HELLO") == L"hello");
         assert(ToUpperLocale(L"hello") == L"HELLO");
+        assert(ToLowerLocale(L"HELLO", std::locale::classic()) == L"hello");
+
+        // Cached mapper against the facet, with ASCII runs of every length between other characters
+        const std::locale   System = std::locale("");
+        const auto&         Ctype  = std::use_facet<std::ctype<wchar_t>>(System);
+        const CaseMapper&   Mapper = CaseMapper::System();
+        std::wstring        Mixed;
+        for (int i = 0; i < 80; ++i)
+        {
+            Mixed += std::wstring(i % 37, static_cast<wchar_t>((i % 2 ? L'a' : L'A') + i % 26));
+            Mixed += L"\u00C9\u00E9\u0141\u03C3"[i % 4];
+        }
+        std::wstring Lower = Mixed, Upper = Mixed;
+        Ctype.tolower(Lower.data(), Lower.data() + Lower.size());
+        Ctype.toupper(Upper.data(), Upper.data() + Upper.size());
+        assert(ToLowerLocale(std::wstring_view(Mixed), Mapper) == Lower && ToUpperLocale(std::wstring_view(Mixed)) == Upper);
+        assert(Mapper.ToLower(L'\u00C9') == Ctype.tolower(L'\u00C9') && Mapper.ToUpper(L'q') == L'Q');
+
+        // A locale that does not map ASCII like ToLower/ToUpper must not take the SIMD path
+        struct dotless_i_ctype : std::ctype<wchar_t>
+        {
+            wchar_t do_tolower(wchar_t C) const override { return C == L'I' ? L'\u0131' : std::ctype<wchar_t>::do_tolower(C); }
+            const wchar_t* do_tolower(wchar_t* pLow, const wchar_t* pHigh) const override
+            {
+                for (; pLow < pHigh; ++pLow) *pLow = do_tolower(*pLow);
+                return pHigh;
+            }
+        };
+        const CaseMapper Turkish{ std::locale(std::locale::classic(), new dotless_i_ctype) };
+        std::wstring     Is(100, L'I');
+        ToLowerLocale(Is, Turkish);
+        assert(Is == std::wstring(100, L'\u0131'));
+        assert(ToLowerLocale(L"TITLE", Turkish) == L"t\u0131tle");
     }
 
     void TestLevenshteinDistance()
@@ -398,6 +1144,27 @@ namespace xstrtool::unit_test
         assert(xstrtool::rfindI(L"", L"a") == std::wstring::npos);
         assert(xstrtool::rfindI(L"abc", L"") == 3);
         assert(xstrtool::rfindI(L"Hello World", L"o", 7) == 7);
+
+        // The last match in every position of the SIMD blocks (and of the tail handled by the smaller tiers)
+        for (std::size_t i = 1; i < 150; ++i)
+        {
+            std::string Hay(160, 'x');
+            Hay.replace(i, 3, "aBa");
+            assert(xstrtool::ReverseFinderI("ABA").Find(Hay) == i && xstrtool::ReverseFinder("aBa").Find(Hay, i) == i);
+            assert(xstrtool::ReverseFinder("aba").Find(Hay) == std::string::npos && xstrtool::ReverseFinderI("aba").Find(Hay, i - 1) == std::string::npos);
+
+            std::wstring WHay(160, L'x');
+            WHay.replace(i, 3, L"aBa");
+            assert(xstrtool::rfindI(WHay, L"ABA") == i && xstrtool::rfindI(WHay, L"aba", i - 1) == std::wstring::npos);
+        }
+
+        // Long (periodic) needles use the reversed Two-Way search
+        const std::string Long = xstrtool::Repeat("Ab", 40);
+        const std::string Hay  = "x" + Long + "Ab" + xstrtool::Repeat("-", 100) + Long + "b";
+        const xstrtool::ReverseFinderI LongFinder(xstrtool::ToUpperCopy(Long));
+        assert(LongFinder.Find(Hay) == 183 && LongFinder.Find(Hay, 182) == 3 && LongFinder.Find(Hay, 2) == 1);
+        assert(LongFinder.Find(Hay, 0) == std::string::npos && xstrtool::ReverseFinder(Long + "b").Find(Hay) == 183);
+        assert(xstrtool::ReverseFinderI().Find(Hay) == std::string::npos && xstrtool::ReverseFinderI(Hay + "x").Contains(Hay) == false);
     }
 
     void TestCopyN()
@@ -417,6 +1184,148 @@ namespace xstrtool::unit_test
         assert(CopyN(L"abc", 0) == L"");
     }
 
+    void TestSimdDispatch()
+    {
+        const simd_tier Supported = GetSupportedSimdTier();
+        const simd_tier Original  = GetSimdTier();
+        assert(Original <= Supported);
+        assert(GetSimdTierName(simd_tier::AVX2) == "avx2");
+
+        // HashI must give the same value on every tier (a container may outlive a tier change)
+        std::vector<std::size_t> HashRef, HashRefW;
+        SetSimdTier(simd_tier::SCALAR);
+        for (std::size_t Len = 0; Len < 140; ++Len)
+        {
+            std::string  Mixed;
+            std::wstring WMixed;
+            for (std::size_t i = 0; i < Len; ++i) Mixed += static_cast<char>("aZ,q M\x80~"[i % 8]);
+            for (std::size_t i = 0; i < Len; ++i) WMixed += L"aZ,q M\u0141\u015A"[i % 8];
+            HashRef.push_back(HashI{}(Mixed));
+            HashRefW.push_back(HashI{}(WMixed));
+        }
+
+        for (int t = 0; t <= static_cast<int>(Supported); ++t)
+        {
+            const simd_tier Tier = static_cast<simd_tier>(t);
+            assert(SetSimdTier(Tier) == Tier && GetSimdTier() == Tier);
+
+            // Short inputs
+            TestToLower();
+            TestToUpper();
+            TestCompareI();
+            TestCompareNaturalI();
+            TestSortI();
+            TestFind();
+            TestFindI();
+            TestFinderI();
+            TestFindAny();
+            TestStreamFinder();
+            TestSearchFile();
+            TestParallelFindI();
+            TestFindAll();
+            TestRFindI();
+            TestStartsWithI();
+            TestEndsWithI();
+            TestStartsWithAnyI();
+            TestGlob();
+            TestContainsI();
+            TestTrim();
+            TestSplit();
+            TestSplitRange();
+            TestSplitInto();
+            TestCharSet();
+            TestCsvReader();
+            TestSplitLinesParallel();
+            TestLocale();
+            TestCaseFoldU8();
+            TestHashI();
+            TestBatch();
+
+            // Inputs that cross the 16/32/64 byte block boundaries
+            for (std::size_t Len = 0; Len < 140; ++Len)
+            {
+                std::string Mixed;
+                for (std::size_t i = 0; i < Len; ++i) Mixed += static_cast<char>("aZ,q M\x80~"[i % 8]);
+
+                std::string Lower = Mixed, Upper = Mixed;
+                ToLower(Lower);
+                ToUpper(Upper);
+                for (std::size_t i = 0; i < Len; ++i)
+                {
+                    assert(Lower[i] == ToLower(Mixed[i]));
+                    assert(Upper[i] == ToUpper(Mixed[i]));
+                }
+                assert(ToLowerCopy(Mixed) == Lower && ToUpperCopy(Mixed) == Upper);
+                std::vector<char> Into(Len + 1, 'x');
+                assert(ToLowerInto(Into, Mixed) == Len && std::string_view(Into.data()) == Lower);
+                assert(CompareI(Lower, Upper) == 0);
+                assert(CompareI(Lower + "a", Upper + "B") < 0);
+                assert(CompareNaturalI(Lower, Upper) == 0 && CompareNaturalI(Lower + "9x", Upper + "10x") < 0);
+                for (std::size_t k = 0; k < Len; ++k)
+                {
+                    // The first difference decides, whatever follows it
+                    std::string Diff = Upper;
+                    Diff[k] = '{';
+                    if (k + 1 < Len) Diff[k + 1] = '!';
+                    const int Expected = (ToLower(Lower[k]) < '{') ? -1 : 1;
+                    assert(CompareI(Lower, Diff) == Expected && CompareI(Diff, Lower) == -Expected);
+                }
+
+                const std::string Padded = std::string(Len, ' ') + "x\ty" + std::string(Len, '\n');
+                assert(TrimLeftCopy(Padded) == std::string_view(Padded).substr(Len));
+                assert(TrimRightCopy(Padded) == std::string_view(Padded).substr(0, Len + 3));
+                assert(TrimCopy(std::string(Len, '\r')).empty());
+
+                std::size_t Commas = 0;
+                for (const char C : Mixed) Commas += (C == ',');
+                assert(Split(Mixed, ',').size() == Commas + 1);
+                assert(Join(Split(Mixed + "x", ','), ",") == Mixed + "x");
+
+                const std::string Hay = Mixed + "NeedleHere" + Mixed;
+                assert(findI(Hay, "needlehere") == Len);
+                assert(rfindI(Hay, "NEEDLEHERE") == Len);
+                assert(findI(Hay, "needlehers") == std::string::npos);
+                assert(HashI{}(Mixed) == HashRef[Len] && HashI{}(Upper) == HashI{}(Lower));
+
+                // Wide strings, including characters whose low byte is an ASCII upper case letter
+                std::wstring WMixed;
+                for (std::size_t i = 0; i < Len; ++i) WMixed += L"aZ,q M\u0141\u015A"[i % 8];
+
+                const std::wstring WLower = ToLowerCopy(WMixed), WUpper = ToUpperCopy(WMixed);
+                assert(CompareI(WLower, WUpper) == 0);
+                assert(CompareI(WLower + L"a", WUpper + L"B") < 0);
+                assert(CompareNaturalI(WLower, WUpper) == 0 && CompareNaturalI(WLower + L"9x", WUpper + L"10x") < 0);
+                for (std::size_t k = 0; k < Len; ++k)
+                {
+                    std::wstring Diff = WUpper;
+                    Diff[k] = L'{';
+                    const int Expected = (ToLower(WLower[k]) < L'{') ? -1 : 1;
+                    assert(CompareI(WLower, Diff) == Expected && CompareI(Diff, WLower) == -Expected);
+                }
+
+                const std::wstring WHay = WMixed + L"NeedleHere" + WMixed;
+                assert(findI(WHay, L"needlehere") == Len);
+                assert(rfindI(WHay, L"NEEDLEHERE") == Len);
+                assert(findI(WHay, L"needlehers") == std::wstring::npos);
+                assert(findI(WMixed + L"x", L"X") == Len && rfindI(L"x" + WMixed, L"X") == 0);
+                assert(StartsWithI(WHay, WUpper + L"nEEDLE") && EndsWithI(WHay, L"HERE" + WLower));
+                assert(HashI{}(WMixed) == HashRefW[Len] && HashI{}(WUpper) == HashI{}(WLower));
+
+                const std::wstring WPadded = std::wstring(Len, L'\t') + L"x y" + std::wstring(Len, L'\r');
+                assert(TrimLeftCopy(WPadded) == std::wstring_view(WPadded).substr(Len));
+                assert(TrimRightCopy(WPadded) == std::wstring_view(WPadded).substr(0, Len + 3));
+                assert(TrimCopy(std::wstring(Len, L' ')).empty());
+
+                std::size_t WCommas = 0;
+                for (const wchar_t C : WMixed) WCommas += (C == L',');
+                assert(Split(WMixed, L',').size() == WCommas + 1);
+                assert(Join(Split(WMixed + L"x", L','), L",") == WMixed + L"x");
+            }
+        }
+
+        SetSimdTier(Original);
+    }
+
     void RunAllTests()
     {
         TestTo();
@@ -424,26 +1333,46 @@ namespace xstrtool::unit_test
         TestToLower();
         TestToUpper();
         TestCompareI();
+        TestCompareNaturalI();
+        TestSortI();
+        TestFind();
         TestFindI();
+        TestFinderI();
+        TestFindAny();
+        TestStreamFinder();
+        TestSearchFile();
+        TestParallelFindI();
+        TestFindAll();
         TestRFindI();
         TestStartsWithI();
         TestEndsWithI();
+        TestStartsWithAnyI();
         TestContainsI();
         TestTrim();
         TestSplit();
+        TestSplitRange();
+        TestSplitInto();
+        TestCharSet();
+        TestCsvReader();
+        TestSplitLinesParallel();
         TestJoin();
         TestReplace();
         TestPath();
+        TestGlob();
         TestFormatTime();
         TestPad();
         TestRepeat();
         TestBase64();
         TestURL();
         TestHash();
+        TestHashI();
+        TestBatch();
         TestUnicode();
         TestLocale();
+        TestCaseFoldU8();
         TestLevenshteinDistance();
         TestStringToDouble();
+        TestSimdDispatch();
     }
 }  // namespace xstrtool::test
 
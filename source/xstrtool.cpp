@@ -6,941 +6,5268 @@
 #include <chrono>
 #include <format>
 #include <immintrin.h>
-#include <intrin.h>  // For MSVC _BitScanForward/_BitScanReverse
+#ifdef _MSC_VER
+    #include <intrin.h>  // For MSVC __cpuidex/_xgetbv
+#else
+    #include <cpuid.h>   // For __cpuid_count
+#endif
 #include <locale>
 #include <vector>
 #include <charconv>  // For std::from_chars
 #include <format>  // For std::format
 #include <chrono>
 #include <array>
+#include <atomic>
+#include <thread>
+#include <bit>       // For std::countr_zero/std::countl_zero
+#include <functional> // For std::less
+#include <cstdlib>   // For std::getenv
+#include <cstring>   // For std::memcpy
+#include <type_traits>
+#include <utility>   // For std::exchange
+#ifdef _WIN32
+    #ifndef WIN32_LEAN_AND_MEAN
+        #define WIN32_LEAN_AND_MEAN
+    #endif
+    #ifndef NOMINMAX
+        #define NOMINMAX
+    #endif
+    #include <windows.h>    // For the file mapping of SearchFile
+#else
+    #include <fcntl.h>      // For open
+    #include <sys/mman.h>   // For mmap
+    #include <sys/stat.h>   // For fstat
+    #include <unistd.h>     // For close
+#endif
+
+// Kernels of the wider SIMD tiers are compiled with their own target so the rest of the
+// library keeps the baseline ISA (MSVC allows any intrinsic without a target flag)
+#if defined(_MSC_VER) && !defined(__clang__)
+    #define XSTRTOOL_TARGET_SSE42
+    #define XSTRTOOL_TARGET_AVX2
+    #define XSTRTOOL_TARGET_AVX512BW
+#else
+    #define XSTRTOOL_TARGET_SSE42    __attribute__((target("sse4.2,popcnt")))
+    #define XSTRTOOL_TARGET_AVX2     __attribute__((target("avx2,bmi,bmi2,popcnt,pclmul")))
+    #define XSTRTOOL_TARGET_AVX512BW __attribute__((target("avx512f,avx512bw,avx2,bmi,bmi2,popcnt,pclmul")))
+#endif
 
 namespace xstrtool
 {
     constexpr bool optimized_sse_v = true;
 
+    //--------------------------------------------------------------------------------
+    // SIMD runtime dispatch
+    //--------------------------------------------------------------------------------
+    // Every dispatched function has one kernel per simd_tier. The kernels of a tier only
+    // use instructions of that tier (or narrower), so on GCC/Clang they are compiled with
+    // the matching target attribute and one binary can run on any x64 CPU.
+    namespace
+    {
+        // Whitespace test shared by all the trim kernels
+        template< typename T_CHAR >
+        constexpr bool IsTrimSpace(const T_CHAR C) noexcept
+        {
+            return C == ' ' || C == '\t' || C == '\n' || C == '\r';
+        }
+
+        template< typename T_CHAR >
+        constexpr bool IsDigit(const T_CHAR C) noexcept
+        {
+            return C >= '0' && C <= '9';
+        }
+
+        // True for the 0-0x7F range (wchar_t is signed on Linux)
+        constexpr bool IsAsciiW(const wchar_t C) noexcept
+        {
+            return static_cast<std::uint32_t>(C) < 0x80;
+        }
+
+        // Mask with the lower N bits set (N <= 64)
+        constexpr std::uint64_t TailMask64(const std::size_t N) noexcept
+        {
+            return N >= 64 ? ~std::uint64_t{ 0 } : ((std::uint64_t{ 1 } << N) - 1);
+        }
+
+        // Case-insensitive hash. The layout is fixed so every tier gives the same value: each 32 byte
+        // stripe of folded characters is mixed into four 64 bit lanes and the last stripe is the last 32
+        // bytes of the string (overlapping the previous one), or zero padded when the string is shorter
+        constexpr std::uint64_t HashISecret_v[4] = { 0xBE4BA423396CFEB8ull, 0x1CAD21F72C81017Cull, 0xDB979083E96DD4DEull, 0x1F67B3B7A4A44072ull };
+
+        inline std::uint64_t HashIFinalize(const std::uint64_t (&Acc)[4], const std::size_t ByteLen) noexcept
+        {
+            std::uint64_t H = ByteLen * 0x9E3779B185EBCA87ull;
+            for (const std::uint64_t A : Acc) H = std::rotl(H ^ (A * 0x9E3779B185EBCA87ull), 31) * 0xC2B2AE3D27D4EB4Full;
+            H ^= H >> 33;
+            H *= 0xFF51AFD7ED558CCDull;
+            H ^= H >> 33;
+            H *= 0xC4CEB9FE1A85EC53ull;
+            return H ^ (H >> 33);
+        }
+
+        // Grows Str to Len characters and lets Write(pData, Len) fill them, without zero-filling
+        // the buffer first when the standard library supports it. When Write returns a size the
+        // string is cut down to it (for outputs that are only bounded by Len)
+        template< typename T_STRING, typename T_WRITE >
+        void ResizeAndOverwrite(T_STRING& Str, const std::size_t Len, T_WRITE&& Write) noexcept
+        {
+            constexpr bool bReturnsSize_v = !std::is_void_v<decltype(Write(Str.data(), Len))>;
+        #if defined(__cpp_lib_string_resize_and_overwrite) && __cpp_lib_string_resize_and_overwrite >= 202110L
+            // The size given to the operation is not used: some libraries give the grown capacity instead of Len
+            Str.resize_and_overwrite(Len, [&](auto* pData, const std::size_t) noexcept -> std::size_t
+            {
+                if constexpr (bReturnsSize_v) return Write(pData, Len);
+                else
+                {
+                    Write(pData, Len);
+                    return Len;
+                }
+            });
+        #else
+            Str.resize(Len);
+            if constexpr (bReturnsSize_v) Str.resize(Write(Str.data(), Len));
+            else                          Write(Str.data(), Len);
+        #endif
+        }
+
+        // Adds one part for each delimiter bit set in Mask (bit 0 is at InputView[Base])
+        template< typename T_CHAR, typename T_MASK >
+        inline void EmitSplitParts(const std::basic_string_view<T_CHAR> InputView, const std::size_t Base, T_MASK Mask, std::size_t& Start, std::vector<std::basic_string_view<T_CHAR>>& Result) noexcept
+        {
+            while (Mask)
+            {
+                const std::size_t Pos = Base + std::countr_zero(Mask);
+                Result.push_back(InputView.substr(Start, Pos - Start));
+                Start = Pos + 1;
+                Mask &= Mask - 1;
+            }
+        }
+
+        // Membership in the tables of a CharSet, only U+0000-U+00FF can be in them
+        template< typename T_CHAR >
+        inline bool InSet(const std::uint8_t* pTables, const T_CHAR C) noexcept
+        {
+            const auto U = static_cast<std::make_unsigned_t<T_CHAR>>(C);
+            return U < 256 && ((pTables[(U >> 7) * 16 + (U & 15)] >> ((U >> 4) & 7)) & 1);
+        }
+
+        // Carry-less prefix XOR: bit i is the XOR of bits 0..i, so the bits from an opening quote up to (not
+        // including) its closing one are set
+        inline std::uint64_t PrefixXor(std::uint64_t X) noexcept
+        {
+            X ^= X << 1;
+            X ^= X << 2;
+            X ^= X << 4;
+            X ^= X << 8;
+            X ^= X << 16;
+            X ^= X << 32;
+            return X;
+        }
+
+        // Keeps the CSV delimiters and newlines that are outside quotes. Inside is all ones when the window starts
+        // inside quotes and is updated for the next window
+        inline std::uint64_t CsvStructural(const std::uint64_t Structural, const std::uint64_t QuoteRuns, std::uint64_t& Inside) noexcept
+        {
+            const std::uint64_t Quoted = QuoteRuns ^ Inside;
+            Inside = static_cast<std::uint64_t>(static_cast<std::int64_t>(Quoted) >> 63);
+            return Structural & ~Quoted;
+        }
+
+        //--------------------------------------------------------------------------------
+        // Scalar kernels, these define the reference behavior of all the other tiers
+        //--------------------------------------------------------------------------------
+        namespace scalar
+        {
+            template< typename T_CHAR >
+            void ToLowerKernel(T_CHAR* pDest, const T_CHAR* pSrc, const std::size_t Len) noexcept
+            {
+                for (std::size_t i = 0; i < Len; ++i) pDest[i] = ToLower(pSrc[i]);
+            }
+
+            template< typename T_CHAR >
+            void ToUpperKernel(T_CHAR* pDest, const T_CHAR* pSrc, const std::size_t Len) noexcept
+            {
+                for (std::size_t i = 0; i < Len; ++i) pDest[i] = ToUpper(pSrc[i]);
+            }
+
+            template< typename T_CHAR >
+            int CompareIKernel(const T_CHAR* pA, const T_CHAR* pB, const std::size_t Len) noexcept
+            {
+                for (std::size_t i = 0; i < Len; ++i)
+                {
+                    const T_CHAR Ca = ToLower(pA[i]), Cb = ToLower(pB[i]);
+                    if (Ca != Cb) return (Ca < Cb) ? -1 : 1;
+                }
+                return 0;
+            }
+
+            template< typename T_CHAR >
+            bool EqualsLowered(const T_CHAR* pHay, const T_CHAR* pLowerNeedle, const std::size_t Len) noexcept
+            {
+                for (std::size_t i = 0; i < Len; ++i)
+                {
+                    if (ToLower(pHay[i]) != pLowerNeedle[i]) return false;
+                }
+                return true;
+            }
+
+            template< typename T_CHAR >
+            std::size_t FindIKernel(const std::basic_string_view<T_CHAR> Haystack, const std::basic_string_view<T_CHAR> LowerNeedle, const std::size_t Pos) noexcept
+            {
+                for (std::size_t i = Pos; i <= Haystack.size() - LowerNeedle.size(); ++i)
+                {
+                    if (EqualsLowered(Haystack.data() + i, LowerNeedle.data(), LowerNeedle.size())) return i;
+                }
+                return std::string::npos;
+            }
+
+            // Only positions where both anchor bytes of the needle match get the full compare.
+            // When ignoring case the needle must be folded already
+            template< bool T_IGNORE_CASE_V >
+            std::size_t FindKernel(const std::string_view Haystack, const std::string_view Needle, const std::size_t Pos, const std::size_t Anchor1, const std::size_t Anchor2) noexcept
+            {
+                const auto  Fold = [](const char C) { return T_IGNORE_CASE_V ? ToLower(C) : C; };
+                const char* pHay = Haystack.data();
+                const char  A1   = Needle[Anchor1];
+                const char  A2   = Needle[Anchor2];
+                for (std::size_t i = Pos; i <= Haystack.size() - Needle.size(); ++i)
+                {
+                    if (Fold(pHay[i + Anchor1]) != A1 || Fold(pHay[i + Anchor2]) != A2) continue;
+                    if (T_IGNORE_CASE_V ? EqualsLowered(pHay + i, Needle.data(), Needle.size()) : std::memcmp(pHay + i, Needle.data(), Needle.size()) == 0) return i;
+                }
+                return std::string::npos;
+            }
+
+            // Counts every (overlapping) match, the needle must be folded when ignoring case
+            template< bool T_IGNORE_CASE_V >
+            std::size_t CountKernel(const std::string_view Haystack, const std::string_view Needle, const std::size_t Pos, const std::size_t Anchor1, const std::size_t Anchor2) noexcept
+            {
+                std::size_t Count = 0;
+                for (std::size_t i = Pos; (i = FindKernel<T_IGNORE_CASE_V>(Haystack, Needle, i, Anchor1, Anchor2)) != std::string::npos; ++i) ++Count;
+                return Count;
+            }
+
+            // FindKernel backwards: the last match at or before Pos (Pos + Needle.size() must fit in the haystack)
+            template< bool T_IGNORE_CASE_V >
+            std::size_t RFindKernel(const std::string_view Haystack, const std::string_view Needle, const std::size_t Pos, const std::size_t Anchor1, const std::size_t Anchor2) noexcept
+            {
+                const auto  Fold = [](const char C) { return T_IGNORE_CASE_V ? ToLower(C) : C; };
+                const char* pHay = Haystack.data();
+                const char  A1   = Needle[Anchor1];
+                const char  A2   = Needle[Anchor2];
+                for (std::size_t i = Pos + 1; i > 0; --i)
+                {
+                    const std::size_t Candidate = i - 1;
+                    if (Fold(pHay[Candidate + Anchor1]) != A1 || Fold(pHay[Candidate + Anchor2]) != A2) continue;
+                    if (T_IGNORE_CASE_V ? EqualsLowered(pHay + Candidate, Needle.data(), Needle.size()) : std::memcmp(pHay + Candidate, Needle.data(), Needle.size()) == 0) return Candidate;
+                }
+                return std::string::npos;
+            }
+
+            // Walks a prefix (or suffix) trie, see BasicAffixSetI. Node n is pNodes[3n, 3n + 3): first child, child
+            // count and entry id (~0u for none); the children of a node are consecutive and pLabels[c] is the folded
+            // byte that leads to node c. Returns the id of the deepest node with an entry
+            std::size_t AffixMatchKernel(const std::uint32_t* pNodes, const char* pLabels, const char* pStr, const std::size_t Len, const bool bSuffix) noexcept
+            {
+                std::size_t          Best  = std::string::npos;
+                const std::uint32_t* pNode = pNodes;
+                for (std::size_t i = 0; ; ++i)
+                {
+                    if (pNode[2] != ~0u) Best = pNode[2];
+                    if (i == Len || pNode[1] == 0) break;
+
+                    const char    C       = ToLower(pStr[bSuffix ? Len - 1 - i : i]);
+                    const char*   pChild  = pLabels + pNode[0];
+                    std::uint32_t k       = 0;
+                    while (k < pNode[1] && pChild[k] != C) ++k;
+                    if (k == pNode[1]) break;
+                    pNode = pNodes + 3 * (pNode[0] + k);
+                }
+                return Best;
+            }
+
+            // Teddy candidate search: the nibble tables give for each of the first FingerprintLen pattern bytes the
+            // buckets that accept a byte (pMasks holds 16 low and 16 high nibble entries per byte), a position where
+            // all the bytes agree on a bucket is a candidate. Returns the first candidate in [Pos, End) and its buckets
+            std::size_t TeddyKernel(const std::uint8_t* pMasks, const std::size_t FingerprintLen, const char* pData, std::size_t Pos, const std::size_t End, std::uint8_t& Buckets) noexcept
+            {
+                for (; Pos < End; ++Pos)
+                {
+                    std::uint8_t Acc = 0xFF;
+                    for (std::size_t k = 0; k < FingerprintLen; ++k)
+                    {
+                        const auto C = static_cast<unsigned char>(pData[Pos + k]);
+                        Acc &= pMasks[k * 32 + (C & 0xF)] & pMasks[k * 32 + 16 + (C >> 4)];
+                    }
+                    if (Acc)
+                    {
+                        Buckets = Acc;
+                        return Pos;
+                    }
+                }
+                return std::string::npos;
+            }
+
+            template< typename T_CHAR >
+            std::size_t RFindIKernel(const std::basic_string_view<T_CHAR> Haystack, const std::basic_string_view<T_CHAR> LowerNeedle, const std::size_t StartPos) noexcept
+            {
+                for (std::size_t i = StartPos + 1; i > 0; --i)
+                {
+                    if (EqualsLowered(Haystack.data() + i - 1, LowerNeedle.data(), LowerNeedle.size())) return i - 1;
+                }
+                return std::string::npos;
+            }
+
+            template< typename T_CHAR >
+            std::size_t TrimLeftKernel(const T_CHAR* pData, const std::size_t Len) noexcept
+            {
+                std::size_t i = 0;
+                while (i < Len && IsTrimSpace(pData[i])) ++i;
+                return i;
+            }
+
+            template< typename T_CHAR >
+            std::size_t TrimRightKernel(const T_CHAR* pData, const std::size_t Len) noexcept
+            {
+                std::size_t i = Len;
+                while (i > 0 && IsTrimSpace(pData[i - 1])) --i;
+                return i;
+            }
+
+            template< typename T_CHAR >
+            void SplitKernel(const std::basic_string_view<T_CHAR> InputView, const T_CHAR Delim, std::vector<std::basic_string_view<T_CHAR>>& Result) noexcept
+            {
+                std::size_t Start = 0;
+                for (std::size_t i = 0; i < InputView.size(); ++i)
+                {
+                    if (InputView[i] == Delim)
+                    {
+                        Result.push_back(InputView.substr(Start, i - Start));
+                        Start = i + 1;
+                    }
+                }
+                Result.push_back(InputView.substr(Start));
+            }
+
+            // Delimiter mask of the first 64-character window at or after Pos that has one (bit 0 is at pData[Pos],
+            // Pos is moved to the window), 0 with Pos = Len when there is none
+            template< typename T_CHAR >
+            std::uint64_t DelimMaskKernel(const T_CHAR* pData, const std::size_t Len, const T_CHAR Delim, std::size_t& Pos) noexcept
+            {
+                for (; Pos < Len; Pos += 64)
+                {
+                    const std::size_t End  = std::min(Pos + 64, Len);
+                    std::uint64_t     Mask = 0;
+                    for (std::size_t i = Pos; i < End; ++i) Mask |= static_cast<std::uint64_t>(pData[i] == Delim) << (i - Pos);
+                    if (Mask) return Mask;
+                }
+                Pos = Len;
+                return 0;
+            }
+
+            // Delimiters and newlines outside quotes of the first 64-byte window at or after Pos that has one (Pos
+            // is moved to the window as in DelimMaskKernel), Inside carries the quote state between windows
+            std::uint64_t CsvMaskKernel(const char* pData, const std::size_t Len, const char Delim, std::size_t& Pos, std::uint64_t& Inside) noexcept
+            {
+                for (; Pos < Len; Pos += 64)
+                {
+                    const std::size_t End        = std::min(Pos + 64, Len);
+                    std::uint64_t     Quotes     = 0;
+                    std::uint64_t     Structural = 0;
+                    for (std::size_t i = Pos; i < End; ++i)
+                    {
+                        Quotes     |= static_cast<std::uint64_t>(pData[i] == '"') << (i - Pos);
+                        Structural |= static_cast<std::uint64_t>(pData[i] == Delim || pData[i] == '\n') << (i - Pos);
+                    }
+                    if (const std::uint64_t Mask = CsvStructural(Structural, PrefixXor(Quotes), Inside); Mask) return Mask;
+                }
+                Pos = Len;
+                return 0;
+            }
+
+            // Mask of the characters in the set (not in the set with bNegate) of the first 64-character window at or
+            // after Pos that has one, the window is the same as in DelimMaskKernel
+            template< typename T_CHAR >
+            std::uint64_t SetMaskKernel(const std::uint8_t* pTables, const T_CHAR* pData, const std::size_t Len, const bool bNegate, std::size_t& Pos) noexcept
+            {
+                for (; Pos < Len; Pos += 64)
+                {
+                    const std::size_t End  = std::min(Pos + 64, Len);
+                    std::uint64_t     Mask = 0;
+                    for (std::size_t i = Pos; i < End; ++i) Mask |= static_cast<std::uint64_t>(InSet(pTables, pData[i]) != bNegate) << (i - Pos);
+                    if (Mask) return Mask;
+                }
+                Pos = Len;
+                return 0;
+            }
+
+            // Last character of the set before End (npos when there is none)
+            template< typename T_CHAR >
+            std::size_t SetRFindKernel(const std::uint8_t* pTables, const T_CHAR* pData, std::size_t End) noexcept
+            {
+                while (End > 0)
+                {
+                    if (InSet(pTables, pData[--End])) return End;
+                }
+                return std::string::npos;
+            }
+
+            // Index of the first pair of characters that differ after ASCII folding (Len when there is none)
+            template< typename T_CHAR >
+            std::size_t MismatchIKernel(const T_CHAR* pA, const T_CHAR* pB, const std::size_t Len) noexcept
+            {
+                std::size_t i = 0;
+                while (i < Len && ToLower(pA[i]) == ToLower(pB[i])) ++i;
+                return i;
+            }
+
+            // Number of leading '0'-'9' characters
+            template< typename T_CHAR >
+            std::size_t DigitSpanKernel(const T_CHAR* pData, const std::size_t Len) noexcept
+            {
+                std::size_t i = 0;
+                while (i < Len && IsDigit(pData[i])) ++i;
+                return i;
+            }
+
+            // Lowers the leading ASCII bytes, returns how many there were (the vector kernels may
+            // write up to Len bytes)
+            std::size_t LowerAsciiKernel(char* pDest, const char* pSrc, const std::size_t Len) noexcept
+            {
+                std::size_t i = 0;
+                for (; i < Len && static_cast<unsigned char>(pSrc[i]) < 0x80; ++i) pDest[i] = ToLower(pSrc[i]);
+                return i;
+            }
+
+            // Index of the first pair of bytes that differ after ASCII folding or where either byte is not ASCII
+            std::size_t MismatchAsciiIKernel(const char* pA, const char* pB, const std::size_t Len) noexcept
+            {
+                std::size_t i = 0;
+                while (i < Len && static_cast<unsigned char>(pA[i] | pB[i]) < 0x80 && ToLower(pA[i]) == ToLower(pB[i])) ++i;
+                return i;
+            }
+
+            // Converts the case of the leading ASCII characters, returns how many were converted
+            template< bool T_TO_UPPER_V >
+            std::size_t CaseAsciiKernel(wchar_t* pDest, const wchar_t* pSrc, const std::size_t Len) noexcept
+            {
+                std::size_t i = 0;
+                for (; i < Len && IsAsciiW(pSrc[i]); ++i) pDest[i] = T_TO_UPPER_V ? ToUpper(pSrc[i]) : ToLower(pSrc[i]);
+                return i;
+            }
+
+            // Mixes one stripe of folded characters (Count <= one stripe, the rest is zero padding)
+            template< typename T_CHAR >
+            inline void HashIStripe(std::uint64_t (&Acc)[4], const T_CHAR* pData, const std::size_t Count) noexcept
+            {
+                T_CHAR Folded[32 / sizeof(T_CHAR)] = {};
+                for (std::size_t i = 0; i < Count; ++i) Folded[i] = ToLower(pData[i]);
+
+                std::uint64_t Data[4];
+                std::memcpy(Data, Folded, sizeof(Data));
+                for (int i = 0; i < 4; ++i)
+                {
+                    const std::uint64_t K = Data[i] ^ HashISecret_v[i];
+                    Acc[i] = std::rotl(Acc[i], 23) + (K & 0xFFFFFFFF) * (K >> 32) + Data[i];
+                }
+            }
+
+            template< typename T_CHAR >
+            std::uint64_t HashIKernel(const T_CHAR* pData, const std::size_t Len) noexcept
+            {
+                constexpr std::size_t Stripe_v = 32 / sizeof(T_CHAR);
+                std::uint64_t         Acc[4]   = { HashISecret_v[0], HashISecret_v[1], HashISecret_v[2], HashISecret_v[3] };
+                std::size_t           i        = 0;
+                for (; i + Stripe_v <= Len; i += Stripe_v) HashIStripe(Acc, pData + i, Stripe_v);
+                if (Len < Stripe_v) HashIStripe(Acc, pData, Len);
+                else if (i < Len)   HashIStripe(Acc, pData + Len - Stripe_v, Stripe_v);
+                return HashIFinalize(Acc, Len * sizeof(T_CHAR));
+            }
+        }
+
+        //--------------------------------------------------------------------------------
+        // SSE2 kernels (16 bytes per step), SSE2 is part of the x64 baseline
+        //--------------------------------------------------------------------------------
+        namespace sse2
+        {
+            // Adds 32 to 'A'-'Z'
+            inline __m128i LowerBlock(const __m128i V) noexcept
+            {
+                const __m128i Mask = _mm_and_si128(_mm_cmpgt_epi8(V, _mm_set1_epi8('A' - 1)), _mm_cmpgt_epi8(_mm_set1_epi8('Z' + 1), V));
+                return _mm_add_epi8(V, _mm_and_si128(Mask, _mm_set1_epi8(32)));
+            }
+
+            // Subtracts 32 from 'a'-'z'
+            inline __m128i UpperBlock(const __m128i V) noexcept
+            {
+                const __m128i Mask = _mm_and_si128(_mm_cmpgt_epi8(V, _mm_set1_epi8('a' - 1)), _mm_cmpgt_epi8(_mm_set1_epi8('z' + 1), V));
+                return _mm_sub_epi8(V, _mm_and_si128(Mask, _mm_set1_epi8(32)));
+            }
+
+            // One bit per whitespace byte
+            inline std::uint32_t SpaceMask(const __m128i V) noexcept
+            {
+                const __m128i Ws = _mm_or_si128( _mm_or_si128(_mm_cmpeq_epi8(V, _mm_set1_epi8(' ')),  _mm_cmpeq_epi8(V, _mm_set1_epi8('\t')))
+                                               , _mm_or_si128(_mm_cmpeq_epi8(V, _mm_set1_epi8('\n')), _mm_cmpeq_epi8(V, _mm_set1_epi8('\r'))));
+                return static_cast<std::uint32_t>(_mm_movemask_epi8(Ws));
+            }
+
+            void ToLowerKernel(char* pDest, const char* pSrc, const std::size_t Len) noexcept
+            {
+                std::size_t i = 0;
+                for (; i + 16 <= Len; i += 16)
+                {
+                    const __m128i V = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pSrc + i));
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(pDest + i), LowerBlock(V));
+                }
+                scalar::ToLowerKernel(pDest + i, pSrc + i, Len - i);
+            }
+
+            void ToUpperKernel(char* pDest, const char* pSrc, const std::size_t Len) noexcept
+            {
+                std::size_t i = 0;
+                for (; i + 16 <= Len; i += 16)
+                {
+                    const __m128i V = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pSrc + i));
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(pDest + i), UpperBlock(V));
+                }
+                scalar::ToUpperKernel(pDest + i, pSrc + i, Len - i);
+            }
+
+            int CompareIKernel(const char* pA, const char* pB, const std::size_t Len) noexcept
+            {
+                std::size_t i = 0;
+                for (; i + 16 <= Len; i += 16)
+                {
+                    const __m128i Va = LowerBlock(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pA + i)));
+                    const __m128i Vb = LowerBlock(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pB + i)));
+                    const auto    Eq = static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(Va, Vb)));
+                    if (Eq != 0xFFFF)
+                    {
+                        const std::size_t j = i + std::countr_zero(~Eq);
+                        const char Ca = ToLower(pA[j]), Cb = ToLower(pB[j]);
+                        return (Ca < Cb) ? -1 : 1;
+                    }
+                }
+                return scalar::CompareIKernel(pA + i, pB + i, Len - i);
+            }
+
+            inline bool EqualsLowered(const char* pHay, const char* pLowerNeedle, const std::size_t Len) noexcept
+            {
+                std::size_t i = 0;
+                for (; i + 16 <= Len; i += 16)
+                {
+                    const __m128i Vh = LowerBlock(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pHay + i)));
+                    const __m128i Vn = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pLowerNeedle + i));
+                    if (_mm_movemask_epi8(_mm_cmpeq_epi8(Vh, Vn)) != 0xFFFF) return false;
+                }
+                return scalar::EqualsLowered(pHay + i, pLowerNeedle + i, Len - i);
+            }
+
+            // A folded needle byte matches (V | Case) == Byte, Case is 32 for the letters so 'A' matches 'a' too
+            inline char AnchorCase(const char C) noexcept
+            {
+                return (C >= 'a' && C <= 'z') ? char(32) : char(0);
+            }
+
+            // Each block tests 16 positions at once: the bytes at both anchor offsets are compared
+            // with the anchors and only the positions where both match are verified
+            template< bool T_IGNORE_CASE_V >
+            std::size_t FindKernel(const std::string_view Haystack, const std::string_view Needle, const std::size_t Pos, const std::size_t Anchor1, const std::size_t Anchor2) noexcept
+            {
+                const char*       pHay   = Haystack.data();
+                const std::size_t End    = Haystack.size() - Needle.size() + 1;
+                const __m128i     VA1    = _mm_set1_epi8(Needle[Anchor1]);
+                const __m128i     VA2    = _mm_set1_epi8(Needle[Anchor2]);
+                const __m128i     VCase1 = T_IGNORE_CASE_V ? _mm_set1_epi8(AnchorCase(Needle[Anchor1])) : _mm_setzero_si128();
+                const __m128i     VCase2 = T_IGNORE_CASE_V ? _mm_set1_epi8(AnchorCase(Needle[Anchor2])) : _mm_setzero_si128();
+                std::size_t       i      = Pos;
+                for (; i + 16 <= End; i += 16)
+                {
+                    const __m128i V1 = _mm_or_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pHay + i + Anchor1)), VCase1);
+                    const __m128i V2 = _mm_or_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pHay + i + Anchor2)), VCase2);
+                    for (auto Mask = static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(V1, VA1), _mm_cmpeq_epi8(V2, VA2)))); Mask; Mask &= Mask - 1)
+                    {
+                        const std::size_t Candidate = i + std::countr_zero(Mask);
+                        if (T_IGNORE_CASE_V ? EqualsLowered(pHay + Candidate, Needle.data(), Needle.size()) : std::memcmp(pHay + Candidate, Needle.data(), Needle.size()) == 0) return Candidate;
+                    }
+                }
+                return (i < End) ? scalar::FindKernel<T_IGNORE_CASE_V>(Haystack, Needle, i, Anchor1, Anchor2) : std::string::npos;
+            }
+
+            // Needles of one or two bytes are fully covered by the anchors, so the candidate mask is the match mask
+            // and only needs a popcount; longer needles count the candidates that verify
+            template< bool T_IGNORE_CASE_V >
+            std::size_t CountKernel(const std::string_view Haystack, const std::string_view Needle, const std::size_t Pos, const std::size_t Anchor1, const std::size_t Anchor2) noexcept
+            {
+                const char*       pHay   = Haystack.data();
+                const std::size_t End    = Haystack.size() - Needle.size() + 1;
+                const bool        bExact = Needle.size() <= 2;
+                const __m128i     VA1    = _mm_set1_epi8(Needle[Anchor1]);
+                const __m128i     VA2    = _mm_set1_epi8(Needle[Anchor2]);
+                const __m128i     VCase1 = T_IGNORE_CASE_V ? _mm_set1_epi8(AnchorCase(Needle[Anchor1])) : _mm_setzero_si128();
+                const __m128i     VCase2 = T_IGNORE_CASE_V ? _mm_set1_epi8(AnchorCase(Needle[Anchor2])) : _mm_setzero_si128();
+                std::size_t       Count  = 0;
+                std::size_t       i      = Pos;
+                for (; i + 16 <= End; i += 16)
+                {
+                    const __m128i V1   = _mm_or_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pHay + i + Anchor1)), VCase1);
+                    const __m128i V2   = _mm_or_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pHay + i + Anchor2)), VCase2);
+                    auto          Mask = static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(V1, VA1), _mm_cmpeq_epi8(V2, VA2))));
+                    if (bExact)
+                    {
+                        Count += std::popcount(Mask);
+                        continue;
+                    }
+                    for (; Mask; Mask &= Mask - 1)
+                    {
+                        const std::size_t Candidate = i + std::countr_zero(Mask);
+                        Count += T_IGNORE_CASE_V ? EqualsLowered(pHay + Candidate, Needle.data(), Needle.size()) : std::memcmp(pHay + Candidate, Needle.data(), Needle.size()) == 0;
+                    }
+                }
+                return (i < End) ? Count + scalar::CountKernel<T_IGNORE_CASE_V>(Haystack, Needle, i, Anchor1, Anchor2) : Count;
+            }
+
+            // FindKernel backwards, 16 positions per block from the end. The candidates of a block are visited
+            // from the highest lane down (leading zero count), so the first one that verifies is the answer
+            template< bool T_IGNORE_CASE_V >
+            std::size_t RFindKernel(const std::string_view Haystack, const std::string_view Needle, const std::size_t Pos, const std::size_t Anchor1, const std::size_t Anchor2) noexcept
+            {
+                const char*       pHay   = Haystack.data();
+                const __m128i     VA1    = _mm_set1_epi8(Needle[Anchor1]);
+                const __m128i     VA2    = _mm_set1_epi8(Needle[Anchor2]);
+                const __m128i     VCase1 = T_IGNORE_CASE_V ? _mm_set1_epi8(AnchorCase(Needle[Anchor1])) : _mm_setzero_si128();
+                const __m128i     VCase2 = T_IGNORE_CASE_V ? _mm_set1_epi8(AnchorCase(Needle[Anchor2])) : _mm_setzero_si128();
+                std::size_t       End    = Pos + 1;                                         // One past the last candidate
+                for (; End >= 16; End -= 16)
+                {
+                    const std::size_t Base = End - 16;
+                    const __m128i     V1   = _mm_or_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pHay + Base + Anchor1)), VCase1);
+                    const __m128i     V2   = _mm_or_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pHay + Base + Anchor2)), VCase2);
+                    for (auto Mask = static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(V1, VA1), _mm_cmpeq_epi8(V2, VA2)))); Mask; )
+                    {
+                        const int         Lane      = 31 - std::countl_zero(Mask);
+                        const std::size_t Candidate = Base + Lane;
+                        if (T_IGNORE_CASE_V ? EqualsLowered(pHay + Candidate, Needle.data(), Needle.size()) : std::memcmp(pHay + Candidate, Needle.data(), Needle.size()) == 0) return Candidate;
+                        Mask ^= 1u << Lane;
+                    }
+                }
+                return (End > 0) ? scalar::RFindKernel<T_IGNORE_CASE_V>(Haystack, Needle, End - 1, Anchor1, Anchor2) : std::string::npos;
+            }
+
+            // AffixMatchKernel with the child labels of a node compared 16 at a time (pLabels is padded so
+            // the last block can be loaded whole)
+            std::size_t AffixMatchKernel(const std::uint32_t* pNodes, const char* pLabels, const char* pStr, const std::size_t Len, const bool bSuffix) noexcept
+            {
+                std::size_t          Best  = std::string::npos;
+                const std::uint32_t* pNode = pNodes;
+                for (std::size_t i = 0; ; ++i)
+                {
+                    if (pNode[2] != ~0u) Best = pNode[2];
+                    if (i == Len || pNode[1] == 0) break;
+
+                    const __m128i   VC    = _mm_set1_epi8(ToLower(pStr[bSuffix ? Len - 1 - i : i]));
+                    std::uint32_t   Child = ~0u;
+                    for (std::uint32_t k = 0; k < pNode[1]; k += 16)
+                    {
+                        auto Mask = static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pLabels + pNode[0] + k)), VC)));
+                        if (pNode[1] - k < 16) Mask &= (1u << (pNode[1] - k)) - 1;
+                        if (Mask)
+                        {
+                            Child = pNode[0] + k + std::countr_zero(Mask);
+                            break;
+                        }
+                    }
+                    if (Child == ~0u) break;
+                    pNode = pNodes + 3 * Child;
+                }
+                return Best;
+            }
+
+            std::size_t TrimLeftKernel(const char* pData, const std::size_t Len) noexcept
+            {
+                std::size_t i = 0;
+                for (; i + 16 <= Len; i += 16)
+                {
+                    const std::uint32_t NonWs = ~SpaceMask(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pData + i))) & 0xFFFF;
+                    if (NonWs) return i + std::countr_zero(NonWs);
+                }
+                return i + scalar::TrimLeftKernel(pData + i, Len - i);
+            }
+
+            std::size_t TrimRightKernel(const char* pData, const std::size_t Len) noexcept
+            {
+                std::size_t i = Len;
+                for (; i >= 16; i -= 16)
+                {
+                    const std::uint32_t NonWs = ~SpaceMask(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pData + i - 16))) & 0xFFFF;
+                    if (NonWs) return i - 16 + (32 - std::countl_zero(NonWs));
+                }
+                return scalar::TrimRightKernel(pData, i);
+            }
+
+            void SplitKernel(const std::string_view InputView, const char Delim, std::vector<std::string_view>& Result) noexcept
+            {
+                const char*       pData = InputView.data();
+                const std::size_t Len   = InputView.size();
+                const __m128i     D     = _mm_set1_epi8(Delim);
+                std::size_t       Start = 0;
+                std::size_t       i     = 0;
+                for (; i + 16 <= Len; i += 16)
+                {
+                    const __m128i V = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pData + i));
+                    EmitSplitParts(InputView, i, static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(V, D))), Start, Result);
+                }
+                for (; i < Len; ++i)
+                {
+                    if (pData[i] == Delim)
+                    {
+                        Result.push_back(InputView.substr(Start, i - Start));
+                        Start = i + 1;
+                    }
+                }
+                Result.push_back(InputView.substr(Start));
+            }
+
+            std::uint64_t DelimMaskKernel(const char* pData, const std::size_t Len, const char Delim, std::size_t& Pos) noexcept
+            {
+                const __m128i D = _mm_set1_epi8(Delim);
+                for (; Pos + 64 <= Len; Pos += 64)
+                {
+                    std::uint64_t Mask = 0;
+                    for (std::size_t i = 0; i < 64; i += 16)
+                    {
+                        const __m128i V = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pData + Pos + i));
+                        Mask |= static_cast<std::uint64_t>(static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(V, D)))) << i;
+                    }
+                    if (Mask) return Mask;
+                }
+                return scalar::DelimMaskKernel(pData, Len, Delim, Pos);
+            }
+
+            std::uint64_t CsvMaskKernel(const char* pData, const std::size_t Len, const char Delim, std::size_t& Pos, std::uint64_t& Inside) noexcept
+            {
+                const __m128i D = _mm_set1_epi8(Delim);
+                const __m128i N = _mm_set1_epi8('\n');
+                const __m128i Q = _mm_set1_epi8('"');
+                for (; Pos + 64 <= Len; Pos += 64)
+                {
+                    std::uint64_t Quotes     = 0;
+                    std::uint64_t Structural = 0;
+                    for (std::size_t i = 0; i < 64; i += 16)
+                    {
+                        const __m128i V = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pData + Pos + i));
+                        Quotes     |= static_cast<std::uint64_t>(static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(V, Q)))) << i;
+                        Structural |= static_cast<std::uint64_t>(static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(V, D), _mm_cmpeq_epi8(V, N))))) << i;
+                    }
+                    if (const std::uint64_t Mask = CsvStructural(Structural, PrefixXor(Quotes), Inside); Mask) return Mask;
+                }
+                return scalar::CsvMaskKernel(pData, Len, Delim, Pos, Inside);
+            }
+
+            std::size_t LowerAsciiKernel(char* pDest, const char* pSrc, const std::size_t Len) noexcept
+            {
+                std::size_t i = 0;
+                for (; i + 16 <= Len; i += 16)
+                {
+                    const __m128i V = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pSrc + i));
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(pDest + i), LowerBlock(V));
+                    if (const auto NonAscii = static_cast<std::uint32_t>(_mm_movemask_epi8(V)); NonAscii) return i + std::countr_zero(NonAscii);
+                }
+                return i + scalar::LowerAsciiKernel(pDest + i, pSrc + i, Len - i);
+            }
+
+            std::size_t MismatchAsciiIKernel(const char* pA, const char* pB, const std::size_t Len) noexcept
+            {
+                std::size_t i = 0;
+                for (; i + 16 <= Len; i += 16)
+                {
+                    const __m128i       Va   = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pA + i));
+                    const __m128i       Vb   = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pB + i));
+                    const std::uint32_t Stop = (~_mm_movemask_epi8(_mm_cmpeq_epi8(LowerBlock(Va), LowerBlock(Vb))) | _mm_movemask_epi8(_mm_or_si128(Va, Vb))) & 0xFFFF;
+                    if (Stop) return i + std::countr_zero(Stop);
+                }
+                return i + scalar::MismatchAsciiIKernel(pA + i, pB + i, Len - i);
+            }
+
+            // One bit per '0'-'9' byte (bytes with the top bit set compare as negative)
+            inline std::uint32_t DigitMask(const __m128i V) noexcept
+            {
+                return static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_and_si128(_mm_cmpgt_epi8(V, _mm_set1_epi8('0' - 1)), _mm_cmpgt_epi8(_mm_set1_epi8('9' + 1), V))));
+            }
+
+            std::size_t MismatchIKernel(const char* pA, const char* pB, const std::size_t Len) noexcept
+            {
+                std::size_t i = 0;
+                for (; i + 16 <= Len; i += 16)
+                {
+                    const __m128i Va = LowerBlock(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pA + i)));
+                    const __m128i Vb = LowerBlock(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pB + i)));
+                    const auto    Eq = static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(Va, Vb)));
+                    if (Eq != 0xFFFF) return i + std::countr_zero(~Eq);
+                }
+                return i + scalar::MismatchIKernel(pA + i, pB + i, Len - i);
+            }
+
+            std::size_t DigitSpanKernel(const char* pData, const std::size_t Len) noexcept
+            {
+                std::size_t i = 0;
+                for (; i + 16 <= Len; i += 16)
+                {
+                    const std::uint32_t NonDigit = ~DigitMask(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pData + i))) & 0xFFFF;
+                    if (NonDigit) return i + std::countr_zero(NonDigit);
+                }
+                return i + scalar::DigitSpanKernel(pData + i, Len - i);
+            }
+
+            //--------------------------------------------------------------------------------
+            // Wide kernels, a wchar_t is a 32 bit lane on Linux and a 16 bit lane on Windows
+            //--------------------------------------------------------------------------------
+            constexpr std::size_t   WideLanes_v = 16 / sizeof(wchar_t);
+            constexpr std::uint32_t WideFull_v  = (1u << WideLanes_v) - 1;
+
+            inline __m128i LoadW(const wchar_t* pData) noexcept
+            {
+                return _mm_loadu_si128(reinterpret_cast<const __m128i*>(pData));
+            }
+
+            inline __m128i Set1W(const wchar_t C) noexcept
+            {
+                if constexpr (sizeof(wchar_t) == 4) return _mm_set1_epi32(static_cast<int>(C));
+                else                                return _mm_set1_epi16(static_cast<short>(C));
+            }
+
+            inline __m128i CmpEqW(const __m128i A, const __m128i B) noexcept
+            {
+                if constexpr (sizeof(wchar_t) == 4) return _mm_cmpeq_epi32(A, B);
+                else                                return _mm_cmpeq_epi16(A, B);
+            }
+
+            inline __m128i CmpGtW(const __m128i A, const __m128i B) noexcept
+            {
+                if constexpr (sizeof(wchar_t) == 4) return _mm_cmpgt_epi32(A, B);
+                else                                return _mm_cmpgt_epi16(A, B);
+            }
+
+            // One bit per lane
+            inline std::uint32_t MoveMaskW(const __m128i Mask) noexcept
+            {
+                if constexpr (sizeof(wchar_t) == 4) return static_cast<std::uint32_t>(_mm_movemask_ps(_mm_castsi128_ps(Mask)));
+                else                                return static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_packs_epi16(Mask, _mm_setzero_si128())));
+            }
+
+            // Adds 32 to L'A'-L'Z', lanes with the top bit set compare as negative and are left alone
+            inline __m128i LowerBlockW(const __m128i V) noexcept
+            {
+                const __m128i Mask = _mm_and_si128(CmpGtW(V, Set1W(L'A' - 1)), CmpGtW(Set1W(L'Z' + 1), V));
+                return _mm_or_si128(V, _mm_and_si128(Mask, Set1W(32)));
+            }
+
+            inline __m128i UpperBlockW(const __m128i V) noexcept
+            {
+                const __m128i Mask = _mm_and_si128(CmpGtW(V, Set1W(L'a' - 1)), CmpGtW(Set1W(L'z' + 1), V));
+                return _mm_andnot_si128(_mm_and_si128(Mask, Set1W(32)), V);
+            }
+
+            inline std::uint32_t SpaceMaskW(const __m128i V) noexcept
+            {
+                const __m128i Ws = _mm_or_si128( _mm_or_si128(CmpEqW(V, Set1W(L' ')),  CmpEqW(V, Set1W(L'\t')))
+                                               , _mm_or_si128(CmpEqW(V, Set1W(L'\n')), CmpEqW(V, Set1W(L'\r'))));
+                return MoveMaskW(Ws);
+            }
+
+            // Stops at the first block that has a non ASCII character
+            template< bool T_TO_UPPER_V >
+            std::size_t CaseAsciiKernel(wchar_t* pDest, const wchar_t* pSrc, const std::size_t Len) noexcept
+            {
+                const __m128i NonAscii = Set1W(static_cast<wchar_t>(~0x7F));
+                std::size_t   i        = 0;
+                for (; i + WideLanes_v <= Len; i += WideLanes_v)
+                {
+                    const __m128i V = LoadW(pSrc + i);
+                    if (_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_and_si128(V, NonAscii), _mm_setzero_si128())) != 0xFFFF) return i;
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(pDest + i), T_TO_UPPER_V ? UpperBlockW(V) : LowerBlockW(V));
+                }
+                return i + scalar::CaseAsciiKernel<T_TO_UPPER_V>(pDest + i, pSrc + i, Len - i);
+            }
+
+            int CompareIKernel(const wchar_t* pA, const wchar_t* pB, const std::size_t Len) noexcept
+            {
+                std::size_t i = 0;
+                for (; i + WideLanes_v <= Len; i += WideLanes_v)
+                {
+                    const std::uint32_t Eq = MoveMaskW(CmpEqW(LowerBlockW(LoadW(pA + i)), LowerBlockW(LoadW(pB + i))));
+                    if (Eq != WideFull_v)
+                    {
+                        const std::size_t j  = i + std::countr_zero(~Eq);
+                        const wchar_t     Ca = ToLower(pA[j]), Cb = ToLower(pB[j]);
+                        return (Ca < Cb) ? -1 : 1;
+                    }
+                }
+                return scalar::CompareIKernel(pA + i, pB + i, Len - i);
+            }
+
+            inline bool EqualsLowered(const wchar_t* pHay, const wchar_t* pLowerNeedle, const std::size_t Len) noexcept
+            {
+                std::size_t i = 0;
+                for (; i + WideLanes_v <= Len; i += WideLanes_v)
+                {
+                    if (MoveMaskW(CmpEqW(LowerBlockW(LoadW(pHay + i)), LoadW(pLowerNeedle + i))) != WideFull_v) return false;
+                }
+                return scalar::EqualsLowered(pHay + i, pLowerNeedle + i, Len - i);
+            }
+
+            // Candidates are the lanes that match the first needle character, they get verified with the rest
+            std::size_t FindIKernel(const std::wstring_view Haystack, const std::wstring_view LowerNeedle, const std::size_t Pos) noexcept
+            {
+                const wchar_t*    pHay   = Haystack.data();
+                const std::size_t End    = Haystack.size() - LowerNeedle.size() + 1;     // One past the last candidate
+                const __m128i     VFirst = Set1W(LowerNeedle[0]);
+                std::size_t       i      = Pos;
+                for (; i + WideLanes_v <= End; i += WideLanes_v)
+                {
+                    for (std::uint32_t Mask = MoveMaskW(CmpEqW(LowerBlockW(LoadW(pHay + i)), VFirst)); Mask; Mask &= Mask - 1)
+                    {
+                        const std::size_t Candidate = i + std::countr_zero(Mask);
+                        if (EqualsLowered(pHay + Candidate + 1, LowerNeedle.data() + 1, LowerNeedle.size() - 1)) return Candidate;
+                    }
+                }
+                for (; i < End; ++i)
+                {
+                    if (EqualsLowered(pHay + i, LowerNeedle.data(), LowerNeedle.size())) return i;
+                }
+                return std::wstring::npos;
+            }
+
+            std::size_t RFindIKernel(const std::wstring_view Haystack, const std::wstring_view LowerNeedle, const std::size_t StartPos) noexcept
+            {
+                const wchar_t*    pHay   = Haystack.data();
+                const std::size_t Last   = LowerNeedle.size() - 1;
+                const __m128i     VFirst = Set1W(LowerNeedle[0]);
+                const __m128i     VLast  = Set1W(LowerNeedle[Last]);
+                std::size_t       End    = StartPos + 1;                                 // One past the last candidate
+                for (; End >= WideLanes_v; End -= WideLanes_v)
+                {
+                    // Both the first and the last character of the needle must match before a candidate is verified
+                    const std::size_t Base = End - WideLanes_v;
+                    for (std::uint32_t Mask = MoveMaskW(CmpEqW(LowerBlockW(LoadW(pHay + Base)), VFirst)) & MoveMaskW(CmpEqW(LowerBlockW(LoadW(pHay + Base + Last)), VLast)); Mask; )
+                    {
+                        const int Lane = std::bit_width(Mask) - 1;
+                        if (EqualsLowered(pHay + Base + Lane + 1, LowerNeedle.data() + 1, Last)) return Base + Lane;
+                        Mask ^= 1u << Lane;
+                    }
+                }
+                for (; End > 0; --End)
+                {
+                    if (EqualsLowered(pHay + End - 1, LowerNeedle.data(), LowerNeedle.size())) return End - 1;
+                }
+                return std::wstring::npos;
+            }
+
+            std::size_t TrimLeftKernel(const wchar_t* pData, const std::size_t Len) noexcept
+            {
+                std::size_t i = 0;
+                for (; i + WideLanes_v <= Len; i += WideLanes_v)
+                {
+                    const std::uint32_t NonWs = ~SpaceMaskW(LoadW(pData + i)) & WideFull_v;
+                    if (NonWs) return i + std::countr_zero(NonWs);
+                }
+                return i + scalar::TrimLeftKernel(pData + i, Len - i);
+            }
+
+            std::size_t TrimRightKernel(const wchar_t* pData, const std::size_t Len) noexcept
+            {
+                std::size_t i = Len;
+                for (; i >= WideLanes_v; i -= WideLanes_v)
+                {
+                    const std::uint32_t NonWs = ~SpaceMaskW(LoadW(pData + i - WideLanes_v)) & WideFull_v;
+                    if (NonWs) return i - WideLanes_v + (32 - std::countl_zero(NonWs));
+                }
+                return scalar::TrimRightKernel(pData, i);
+            }
+
+            void SplitKernel(const std::wstring_view InputView, const wchar_t Delim, std::vector<std::wstring_view>& Result) noexcept
+            {
+                const wchar_t*    pData = InputView.data();
+                const std::size_t Len   = InputView.size();
+                const __m128i     D     = Set1W(Delim);
+                std::size_t       Start = 0;
+                std::size_t       i     = 0;
+                for (; i + WideLanes_v <= Len; i += WideLanes_v)
+                {
+                    EmitSplitParts(InputView, i, MoveMaskW(CmpEqW(LoadW(pData + i), D)), Start, Result);
+                }
+                for (; i < Len; ++i)
+                {
+                    if (pData[i] == Delim)
+                    {
+                        Result.push_back(InputView.substr(Start, i - Start));
+                        Start = i + 1;
+                    }
+                }
+                Result.push_back(InputView.substr(Start));
+            }
+
+            std::uint64_t DelimMaskKernel(const wchar_t* pData, const std::size_t Len, const wchar_t Delim, std::size_t& Pos) noexcept
+            {
+                const __m128i D = Set1W(Delim);
+                for (; Pos + 64 <= Len; Pos += 64)
+                {
+                    std::uint64_t Mask = 0;
+                    for (std::size_t i = 0; i < 64; i += WideLanes_v) Mask |= static_cast<std::uint64_t>(MoveMaskW(CmpEqW(LoadW(pData + Pos + i), D))) << i;
+                    if (Mask) return Mask;
+                }
+                return scalar::DelimMaskKernel(pData, Len, Delim, Pos);
+            }
+
+            inline std::uint32_t DigitMaskW(const __m128i V) noexcept
+            {
+                return MoveMaskW(_mm_and_si128(CmpGtW(V, Set1W(L'0' - 1)), CmpGtW(Set1W(L'9' + 1), V)));
+            }
+
+            std::size_t MismatchIKernel(const wchar_t* pA, const wchar_t* pB, const std::size_t Len) noexcept
+            {
+                std::size_t i = 0;
+                for (; i + WideLanes_v <= Len; i += WideLanes_v)
+                {
+                    const std::uint32_t Eq = MoveMaskW(CmpEqW(LowerBlockW(LoadW(pA + i)), LowerBlockW(LoadW(pB + i))));
+                    if (Eq != WideFull_v) return i + std::countr_zero(~Eq);
+                }
+                return i + scalar::MismatchIKernel(pA + i, pB + i, Len - i);
+            }
+
+            std::size_t DigitSpanKernel(const wchar_t* pData, const std::size_t Len) noexcept
+            {
+                std::size_t i = 0;
+                for (; i + WideLanes_v <= Len; i += WideLanes_v)
+                {
+                    const std::uint32_t NonDigit = ~DigitMaskW(LoadW(pData + i)) & WideFull_v;
+                    if (NonDigit) return i + std::countr_zero(NonDigit);
+                }
+                return i + scalar::DigitSpanKernel(pData + i, Len - i);
+            }
+
+            //--------------------------------------------------------------------------------
+            // Case-insensitive hash (see HashIFinalize), the same kernel for narrow and wide strings
+            //--------------------------------------------------------------------------------
+            template< typename T_CHAR >
+            inline __m128i FoldBlock(const __m128i V) noexcept
+            {
+                if constexpr (sizeof(T_CHAR) == 1) return LowerBlock(V);
+                else                               return LowerBlockW(V);
+            }
+
+            inline __m128i HashIRound(const __m128i Acc, const __m128i Data, const __m128i Secret) noexcept
+            {
+                const __m128i K   = _mm_xor_si128(Data, Secret);
+                const __m128i Rot = _mm_or_si128(_mm_slli_epi64(Acc, 23), _mm_srli_epi64(Acc, 41));
+                return _mm_add_epi64(_mm_add_epi64(Rot, _mm_mul_epu32(K, _mm_srli_epi64(K, 32))), Data);
+            }
+
+            template< typename T_CHAR >
+            inline void HashIStripe(__m128i (&Acc)[2], const T_CHAR* pData, const __m128i (&Secret)[2]) noexcept
+            {
+                Acc[0] = HashIRound(Acc[0], FoldBlock<T_CHAR>(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pData))), Secret[0]);
+                Acc[1] = HashIRound(Acc[1], FoldBlock<T_CHAR>(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pData) + 1)), Secret[1]);
+            }
+
+            template< typename T_CHAR >
+            std::uint64_t HashIKernel(const T_CHAR* pData, const std::size_t Len) noexcept
+            {
+                constexpr std::size_t Stripe_v  = 32 / sizeof(T_CHAR);
+                const __m128i         Secret[2] = { _mm_loadu_si128(reinterpret_cast<const __m128i*>(HashISecret_v)), _mm_loadu_si128(reinterpret_cast<const __m128i*>(HashISecret_v) + 1) };
+                __m128i               Acc[2]    = { Secret[0], Secret[1] };
+                std::size_t           i         = 0;
+                for (; i + Stripe_v <= Len; i += Stripe_v) HashIStripe(Acc, pData + i, Secret);
+                if (Len < Stripe_v)
+                {
+                    T_CHAR Padded[Stripe_v] = {};
+                    if (Len) std::memcpy(Padded, pData, Len * sizeof(T_CHAR));
+                    HashIStripe(Acc, Padded, Secret);
+                }
+                else if (i < Len) HashIStripe(Acc, pData + Len - Stripe_v, Secret);
+
+                std::uint64_t Lanes[4];
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(Lanes), Acc[0]);
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(Lanes) + 1, Acc[1]);
+                return HashIFinalize(Lanes, Len * sizeof(T_CHAR));
+            }
+        }
+
+        //--------------------------------------------------------------------------------
+        // SSE4.2 kernels, PCMPISTRI does the set matching
+        //--------------------------------------------------------------------------------
+        namespace sse42
+        {
+            // PSHUFB looks up the low and high nibble of 16 bytes at once
+            XSTRTOOL_TARGET_SSE42
+            std::size_t TeddyKernel(const std::uint8_t* pMasks, const std::size_t FingerprintLen, const char* pData, std::size_t Pos, const std::size_t End, std::uint8_t& Buckets) noexcept
+            {
+                const __m128i Nibble = _mm_set1_epi8(0xF);
+                __m128i       Low[3], High[3];
+                for (std::size_t k = 0; k < FingerprintLen; ++k)
+                {
+                    Low[k]  = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pMasks + k * 32));
+                    High[k] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pMasks + k * 32 + 16));
+                }
+
+                for (; Pos + 16 <= End; Pos += 16)
+                {
+                    __m128i Acc = _mm_set1_epi8(-1);
+                    for (std::size_t k = 0; k < FingerprintLen; ++k)
+                    {
+                        const __m128i V = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pData + Pos + k));
+                        Acc = _mm_and_si128(Acc, _mm_and_si128( _mm_shuffle_epi8(Low[k],  _mm_and_si128(V, Nibble))
+                                                              , _mm_shuffle_epi8(High[k], _mm_and_si128(_mm_srli_epi16(V, 4), Nibble))));
+                    }
+
+                    if (const auto Mask = static_cast<std::uint32_t>(~_mm_movemask_epi8(_mm_cmpeq_epi8(Acc, _mm_setzero_si128())) & 0xFFFF); Mask)
+                    {
+                        alignas(16) std::uint8_t Lanes[16];
+                        _mm_store_si128(reinterpret_cast<__m128i*>(Lanes), Acc);
+                        Buckets = Lanes[std::countr_zero(Mask)];
+                        return Pos + std::countr_zero(Mask);
+                    }
+                }
+                return scalar::TeddyKernel(pMasks, FingerprintLen, pData, Pos, End, Buckets);
+            }
+
+            XSTRTOOL_TARGET_SSE42
+            std::size_t TrimLeftKernel(const char* pData, const std::size_t Len) noexcept
+            {
+                const __m128i Set = _mm_setr_epi8(' ', '\t', '\n', '\r', 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0);
+                std::size_t   i   = 0;
+                for (; i + 16 <= Len; i += 16)
+                {
+                    const __m128i V     = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pData + i));
+                    const int     Index = _mm_cmpestri(Set, 4, V, 16, _SIDD_UBYTE_OPS | _SIDD_CMP_EQUAL_ANY | _SIDD_NEGATIVE_POLARITY | _SIDD_LEAST_SIGNIFICANT);
+                    if (Index != 16) return i + Index;
+                }
+                return i + scalar::TrimLeftKernel(pData + i, Len - i);
+            }
+
+            XSTRTOOL_TARGET_SSE42
+            std::size_t TrimRightKernel(const char* pData, const std::size_t Len) noexcept
+            {
+                const __m128i Set = _mm_setr_epi8(' ', '\t', '\n', '\r', 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0);
+                std::size_t   i   = Len;
+                for (; i >= 16; i -= 16)
+                {
+                    const __m128i V     = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pData + i - 16));
+                    const int     Index = _mm_cmpestri(Set, 4, V, 16, _SIDD_UBYTE_OPS | _SIDD_CMP_EQUAL_ANY | _SIDD_NEGATIVE_POLARITY | _SIDD_MOST_SIGNIFICANT);
+                    if (Index != 16) return i - 16 + Index + 1;
+                }
+                return scalar::TrimRightKernel(pData, i);
+            }
+
+            // 0xFF for the bytes in the set: the low nibble picks a row of the table of its half (PSHUFB gives 0 for
+            // an index with the top bit set, so each half only sees its own bytes) and the high nibble picks the bit
+            XSTRTOOL_TARGET_SSE42
+            inline __m128i SetMatch(const __m128i Low, const __m128i High, const __m128i V) noexcept
+            {
+                const __m128i Bits = _mm_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128);
+                const __m128i Row  = _mm_or_si128(_mm_shuffle_epi8(Low, V), _mm_shuffle_epi8(High, _mm_xor_si128(V, _mm_set1_epi8(-128))));
+                const __m128i Bit  = _mm_shuffle_epi8(Bits, _mm_and_si128(_mm_srli_epi16(V, 4), _mm_set1_epi8(0xF)));
+                return _mm_cmpeq_epi8(_mm_and_si128(Row, Bit), Bit);
+            }
+
+            // Wide lanes whose low byte is in the set and whose other bytes are 0
+            XSTRTOOL_TARGET_SSE42
+            inline __m128i SetMatchW(const __m128i Low, const __m128i High, const __m128i V) noexcept
+            {
+                const __m128i Byte = sse2::Set1W(static_cast<wchar_t>(0xFF));
+                return _mm_and_si128( sse2::CmpEqW(_mm_and_si128(SetMatch(Low, High, V), Byte), Byte)
+                                    , sse2::CmpEqW(_mm_andnot_si128(Byte, V), _mm_setzero_si128()));
+            }
+
+            XSTRTOOL_TARGET_SSE42
+            std::uint64_t SetMaskKernel(const std::uint8_t* pTables, const char* pData, const std::size_t Len, const bool bNegate, std::size_t& Pos) noexcept
+            {
+                const __m128i       Low  = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pTables));
+                const __m128i       High = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pTables + 16));
+                const std::uint64_t Flip = bNegate ? ~std::uint64_t(0) : 0;
+                for (; Pos + 64 <= Len; Pos += 64)
+                {
+                    std::uint64_t Mask = 0;
+                    for (std::size_t i = 0; i < 64; i += 16)
+                    {
+                        const __m128i V = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pData + Pos + i));
+                        Mask |= static_cast<std::uint64_t>(static_cast<std::uint32_t>(_mm_movemask_epi8(SetMatch(Low, High, V)))) << i;
+                    }
+                    if (Mask ^= Flip) return Mask;
+                }
+                return scalar::SetMaskKernel(pTables, pData, Len, bNegate, Pos);
+            }
+
+            XSTRTOOL_TARGET_SSE42
+            std::size_t SetRFindKernel(const std::uint8_t* pTables, const char* pData, std::size_t End) noexcept
+            {
+                const __m128i Low  = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pTables));
+                const __m128i High = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pTables + 16));
+                for (; End >= 16; End -= 16)
+                {
+                    const __m128i V    = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pData + End - 16));
+                    const auto    Mask = static_cast<std::uint32_t>(_mm_movemask_epi8(SetMatch(Low, High, V)));
+                    if (Mask) return End - 16 + (31 - std::countl_zero(Mask));
+                }
+                return scalar::SetRFindKernel(pTables, pData, End);
+            }
+
+            XSTRTOOL_TARGET_SSE42
+            std::uint64_t SetMaskKernel(const std::uint8_t* pTables, const wchar_t* pData, const std::size_t Len, const bool bNegate, std::size_t& Pos) noexcept
+            {
+                const __m128i       Low  = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pTables));
+                const __m128i       High = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pTables + 16));
+                const std::uint64_t Flip = bNegate ? ~std::uint64_t(0) : 0;
+                for (; Pos + 64 <= Len; Pos += 64)
+                {
+                    std::uint64_t Mask = 0;
+                    for (std::size_t i = 0; i < 64; i += sse2::WideLanes_v) Mask |= static_cast<std::uint64_t>(sse2::MoveMaskW(SetMatchW(Low, High, sse2::LoadW(pData + Pos + i)))) << i;
+                    if (Mask ^= Flip) return Mask;
+                }
+                return scalar::SetMaskKernel(pTables, pData, Len, bNegate, Pos);
+            }
+
+            XSTRTOOL_TARGET_SSE42
+            std::size_t SetRFindKernel(const std::uint8_t* pTables, const wchar_t* pData, std::size_t End) noexcept
+            {
+                const __m128i Low  = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pTables));
+                const __m128i High = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pTables + 16));
+                for (; End >= sse2::WideLanes_v; End -= sse2::WideLanes_v)
+                {
+                    const std::uint32_t Mask = sse2::MoveMaskW(SetMatchW(Low, High, sse2::LoadW(pData + End - sse2::WideLanes_v)));
+                    if (Mask) return End - sse2::WideLanes_v + (31 - std::countl_zero(Mask));
+                }
+                return scalar::SetRFindKernel(pTables, pData, End);
+            }
+        }
+
+        //--------------------------------------------------------------------------------
+        // AVX2 kernels (32 bytes per step)
+        //--------------------------------------------------------------------------------
+        namespace avx2
+        {
+            XSTRTOOL_TARGET_AVX2
+            inline __m256i LowerBlock(const __m256i V) noexcept
+            {
+                const __m256i Mask = _mm256_and_si256(_mm256_cmpgt_epi8(V, _mm256_set1_epi8('A' - 1)), _mm256_cmpgt_epi8(_mm256_set1_epi8('Z' + 1), V));
+                return _mm256_add_epi8(V, _mm256_and_si256(Mask, _mm256_set1_epi8(32)));
+            }
+
+            XSTRTOOL_TARGET_AVX2
+            inline __m256i UpperBlock(const __m256i V) noexcept
+            {
+                const __m256i Mask = _mm256_and_si256(_mm256_cmpgt_epi8(V, _mm256_set1_epi8('a' - 1)), _mm256_cmpgt_epi8(_mm256_set1_epi8('z' + 1), V));
+                return _mm256_sub_epi8(V, _mm256_and_si256(Mask, _mm256_set1_epi8(32)));
+            }
+
+            XSTRTOOL_TARGET_AVX2
+            inline std::uint32_t SpaceMask(const __m256i V) noexcept
+            {
+                const __m256i Ws = _mm256_or_si256( _mm256_or_si256(_mm256_cmpeq_epi8(V, _mm256_set1_epi8(' ')),  _mm256_cmpeq_epi8(V, _mm256_set1_epi8('\t')))
+                                                  , _mm256_or_si256(_mm256_cmpeq_epi8(V, _mm256_set1_epi8('\n')), _mm256_cmpeq_epi8(V, _mm256_set1_epi8('\r'))));
+                return static_cast<std::uint32_t>(_mm256_movemask_epi8(Ws));
+            }
+
+            // Converts the case of a whole string without a scalar remainder: the last block overlaps
+            // the previous one (converting a byte twice is harmless, also when converting in-place)
+            // and inputs shorter than one SSE block go through a stack buffer
+            template< bool T_TO_UPPER_V >
+            XSTRTOOL_TARGET_AVX2
+            void ConvertCase(char* pDest, const char* pSrc, const std::size_t Len) noexcept
+            {
+                if (Len >= 32)
+                {
+                    for (std::size_t i = 0; i + 32 < Len; i += 32)
+                    {
+                        const __m256i V = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pSrc + i));
+                        _mm256_storeu_si256(reinterpret_cast<__m256i*>(pDest + i), T_TO_UPPER_V ? UpperBlock(V) : LowerBlock(V));
+                    }
+                    const __m256i V = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pSrc + Len - 32));
+                    _mm256_storeu_si256(reinterpret_cast<__m256i*>(pDest + Len - 32), T_TO_UPPER_V ? UpperBlock(V) : LowerBlock(V));
+                }
+                else if (Len >= 16)
+                {
+                    const __m128i V0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pSrc));
+                    const __m128i V1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pSrc + Len - 16));
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(pDest), T_TO_UPPER_V ? sse2::UpperBlock(V0) : sse2::LowerBlock(V0));
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(pDest + Len - 16), T_TO_UPPER_V ? sse2::UpperBlock(V1) : sse2::LowerBlock(V1));
+                }
+                else if (Len > 0)
+                {
+                    alignas(16) char Buffer[16] = {};
+                    std::memcpy(Buffer, pSrc, Len);
+                    const __m128i V = _mm_load_si128(reinterpret_cast<const __m128i*>(Buffer));
+                    _mm_store_si128(reinterpret_cast<__m128i*>(Buffer), T_TO_UPPER_V ? sse2::UpperBlock(V) : sse2::LowerBlock(V));
+                    std::memcpy(pDest, Buffer, Len);
+                }
+            }
+
+            XSTRTOOL_TARGET_AVX2
+            void ToLowerKernel(char* pDest, const char* pSrc, const std::size_t Len) noexcept
+            {
+                ConvertCase<false>(pDest, pSrc, Len);
+            }
+
+            XSTRTOOL_TARGET_AVX2
+            void ToUpperKernel(char* pDest, const char* pSrc, const std::size_t Len) noexcept
+            {
+                ConvertCase<true>(pDest, pSrc, Len);
+            }
+
+            // Returns the order of the first differing byte of a block (Eq has one bit per equal byte)
+            inline int CompareFirstDiff(const char* pA, const char* pB, const std::uint32_t Eq) noexcept
+            {
+                const std::size_t j  = std::countr_zero(~Eq);
+                const char        Ca = ToLower(pA[j]), Cb = ToLower(pB[j]);
+                return (Ca < Cb) ? -1 : 1;
+            }
+
+            // Compares one 16 byte block case-insensitively
+            inline int CompareBlock16(const char* pA, const char* pB) noexcept
+            {
+                const __m128i Va = sse2::LowerBlock(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pA)));
+                const __m128i Vb = sse2::LowerBlock(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pB)));
+                const auto    Eq = static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(Va, Vb))) | 0xFFFF0000u;
+                return (Eq == 0xFFFFFFFFu) ? 0 : CompareFirstDiff(pA, pB, Eq);
+            }
+
+            // Same tail strategy as ConvertCase: the bytes covered twice by the overlapping last block
+            // already compared equal, so its first difference is still the first one of the string
+            XSTRTOOL_TARGET_AVX2
+            int CompareIKernel(const char* pA, const char* pB, const std::size_t Len) noexcept
+            {
+                if (Len >= 32)
+                {
+                    for (std::size_t i = 0; ; i += 32)
+                    {
+                        if (i + 32 > Len) i = Len - 32;
+                        const __m256i Va = LowerBlock(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(pA + i)));
+                        const __m256i Vb = LowerBlock(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(pB + i)));
+                        const auto    Eq = static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(Va, Vb)));
+                        if (Eq != 0xFFFFFFFFu) return CompareFirstDiff(pA + i, pB + i, Eq);
+                        if (i + 32 == Len) return 0;
+                    }
+                }
+
+                if (Len >= 16)
+                {
+                    if (const int Diff = CompareBlock16(pA, pB); Diff != 0) return Diff;
+                    return CompareBlock16(pA + Len - 16, pB + Len - 16);
+                }
+
+                if (Len == 0) return 0;
+
+                alignas(16) char BufferA[16] = {};
+                alignas(16) char BufferB[16] = {};
+                std::memcpy(BufferA, pA, Len);
+                std::memcpy(BufferB, pB, Len);
+                return CompareBlock16(BufferA, BufferB);
+            }
+
+            XSTRTOOL_TARGET_AVX2
+            inline bool EqualsLowered(const char* pHay, const char* pLowerNeedle, const std::size_t Len) noexcept
+            {
+                std::size_t i = 0;
+                for (; i + 32 <= Len; i += 32)
+                {
+                    const __m256i Vh = LowerBlock(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(pHay + i)));
+                    const __m256i Vn = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pLowerNeedle + i));
+                    if (static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(Vh, Vn))) != 0xFFFFFFFFu) return false;
+                }
+                return sse2::EqualsLowered(pHay + i, pLowerNeedle + i, Len - i);
+            }
+
+            template< bool T_IGNORE_CASE_V >
+            XSTRTOOL_TARGET_AVX2
+            std::size_t FindKernel(const std::string_view Haystack, const std::string_view Needle, const std::size_t Pos, const std::size_t Anchor1, const std::size_t Anchor2) noexcept
+            {
+                const char*       pHay   = Haystack.data();
+                const std::size_t End    = Haystack.size() - Needle.size() + 1;
+                const __m256i     VA1    = _mm256_set1_epi8(Needle[Anchor1]);
+                const __m256i     VA2    = _mm256_set1_epi8(Needle[Anchor2]);
+                const __m256i     VCase1 = T_IGNORE_CASE_V ? _mm256_set1_epi8(sse2::AnchorCase(Needle[Anchor1])) : _mm256_setzero_si256();
+                const __m256i     VCase2 = T_IGNORE_CASE_V ? _mm256_set1_epi8(sse2::AnchorCase(Needle[Anchor2])) : _mm256_setzero_si256();
+                std::size_t       i      = Pos;
+                for (; i + 32 <= End; i += 32)
+                {
+                    const __m256i V1 = _mm256_or_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(pHay + i + Anchor1)), VCase1);
+                    const __m256i V2 = _mm256_or_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(pHay + i + Anchor2)), VCase2);
+                    for (auto Mask = static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_and_si256(_mm256_cmpeq_epi8(V1, VA1), _mm256_cmpeq_epi8(V2, VA2)))); Mask; Mask &= Mask - 1)
+                    {
+                        const std::size_t Candidate = i + std::countr_zero(Mask);
+                        if (T_IGNORE_CASE_V ? EqualsLowered(pHay + Candidate, Needle.data(), Needle.size()) : std::memcmp(pHay + Candidate, Needle.data(), Needle.size()) == 0) return Candidate;
+                    }
+                }
+                return (i < End) ? sse2::FindKernel<T_IGNORE_CASE_V>(Haystack, Needle, i, Anchor1, Anchor2) : std::string::npos;
+            }
+
+            template< bool T_IGNORE_CASE_V >
+            XSTRTOOL_TARGET_AVX2
+            std::size_t CountKernel(const std::string_view Haystack, const std::string_view Needle, const std::size_t Pos, const std::size_t Anchor1, const std::size_t Anchor2) noexcept
+            {
+                const char*       pHay   = Haystack.data();
+                const std::size_t End    = Haystack.size() - Needle.size() + 1;
+                const bool        bExact = Needle.size() <= 2;
+                const __m256i     VA1    = _mm256_set1_epi8(Needle[Anchor1]);
+                const __m256i     VA2    = _mm256_set1_epi8(Needle[Anchor2]);
+                const __m256i     VCase1 = T_IGNORE_CASE_V ? _mm256_set1_epi8(sse2::AnchorCase(Needle[Anchor1])) : _mm256_setzero_si256();
+                const __m256i     VCase2 = T_IGNORE_CASE_V ? _mm256_set1_epi8(sse2::AnchorCase(Needle[Anchor2])) : _mm256_setzero_si256();
+                std::size_t       Count  = 0;
+                std::size_t       i      = Pos;
+                for (; i + 32 <= End; i += 32)
+                {
+                    const __m256i V1   = _mm256_or_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(pHay + i + Anchor1)), VCase1);
+                    const __m256i V2   = _mm256_or_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(pHay + i + Anchor2)), VCase2);
+                    auto          Mask = static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_and_si256(_mm256_cmpeq_epi8(V1, VA1), _mm256_cmpeq_epi8(V2, VA2))));
+                    if (bExact)
+                    {
+                        Count += std::popcount(Mask);
+                        continue;
+                    }
+                    for (; Mask; Mask &= Mask - 1)
+                    {
+                        const std::size_t Candidate = i + std::countr_zero(Mask);
+                        Count += T_IGNORE_CASE_V ? EqualsLowered(pHay + Candidate, Needle.data(), Needle.size()) : std::memcmp(pHay + Candidate, Needle.data(), Needle.size()) == 0;
+                    }
+                }
+                return (i < End) ? Count + sse2::CountKernel<T_IGNORE_CASE_V>(Haystack, Needle, i, Anchor1, Anchor2) : Count;
+            }
+
+            XSTRTOOL_TARGET_AVX2
+            std::size_t TeddyKernel(const std::uint8_t* pMasks, const std::size_t FingerprintLen, const char* pData, std::size_t Pos, const std::size_t End, std::uint8_t& Buckets) noexcept
+            {
+                const __m256i Nibble = _mm256_set1_epi8(0xF);
+                __m256i       Low[3], High[3];
+                for (std::size_t k = 0; k < FingerprintLen; ++k)
+                {
+                    Low[k]  = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pMasks + k * 32)));
+                    High[k] = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pMasks + k * 32 + 16)));
+                }
+
+                for (; Pos + 32 <= End; Pos += 32)
+                {
+                    __m256i Acc = _mm256_set1_epi8(-1);
+                    for (std::size_t k = 0; k < FingerprintLen; ++k)
+                    {
+                        const __m256i V = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pData + Pos + k));
+                        Acc = _mm256_and_si256(Acc, _mm256_and_si256( _mm256_shuffle_epi8(Low[k],  _mm256_and_si256(V, Nibble))
+                                                                    , _mm256_shuffle_epi8(High[k], _mm256_and_si256(_mm256_srli_epi16(V, 4), Nibble))));
+                    }
+
+                    if (const auto Mask = ~static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(Acc, _mm256_setzero_si256()))); Mask)
+                    {
+                        alignas(32) std::uint8_t Lanes[32];
+                        _mm256_store_si256(reinterpret_cast<__m256i*>(Lanes), Acc);
+                        Buckets = Lanes[std::countr_zero(Mask)];
+                        return Pos + std::countr_zero(Mask);
+                    }
+                }
+                return sse42::TeddyKernel(pMasks, FingerprintLen, pData, Pos, End, Buckets);
+            }
+
+            // FindKernel backwards, 32 positions per block from the end, see sse2::RFindKernel
+            template< bool T_IGNORE_CASE_V >
+            XSTRTOOL_TARGET_AVX2
+            std::size_t RFindKernel(const std::string_view Haystack, const std::string_view Needle, const std::size_t Pos, const std::size_t Anchor1, const std::size_t Anchor2) noexcept
+            {
+                const char*       pHay   = Haystack.data();
+                const __m256i     VA1    = _mm256_set1_epi8(Needle[Anchor1]);
+                const __m256i     VA2    = _mm256_set1_epi8(Needle[Anchor2]);
+                const __m256i     VCase1 = T_IGNORE_CASE_V ? _mm256_set1_epi8(sse2::AnchorCase(Needle[Anchor1])) : _mm256_setzero_si256();
+                const __m256i     VCase2 = T_IGNORE_CASE_V ? _mm256_set1_epi8(sse2::AnchorCase(Needle[Anchor2])) : _mm256_setzero_si256();
+                std::size_t       End    = Pos + 1;                                         // One past the last candidate
+                for (; End >= 32; End -= 32)
+                {
+                    const std::size_t Base = End - 32;
+                    const __m256i     V1   = _mm256_or_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(pHay + Base + Anchor1)), VCase1);
+                    const __m256i     V2   = _mm256_or_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(pHay + Base + Anchor2)), VCase2);
+                    for (auto Mask = static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_and_si256(_mm256_cmpeq_epi8(V1, VA1), _mm256_cmpeq_epi8(V2, VA2)))); Mask; )
+                    {
+                        const int         Lane      = 31 - std::countl_zero(Mask);
+                        const std::size_t Candidate = Base + Lane;
+                        if (T_IGNORE_CASE_V ? EqualsLowered(pHay + Candidate, Needle.data(), Needle.size()) : std::memcmp(pHay + Candidate, Needle.data(), Needle.size()) == 0) return Candidate;
+                        Mask ^= 1u << Lane;
+                    }
+                }
+                return (End > 0) ? sse2::RFindKernel<T_IGNORE_CASE_V>(Haystack, Needle, End - 1, Anchor1, Anchor2) : std::string::npos;
+            }
+
+            XSTRTOOL_TARGET_AVX2
+            std::size_t TrimLeftKernel(const char* pData, const std::size_t Len) noexcept
+            {
+                std::size_t i = 0;
+                for (; i + 32 <= Len; i += 32)
+                {
+                    const std::uint32_t NonWs = ~SpaceMask(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(pData + i)));
+                    if (NonWs) return i + std::countr_zero(NonWs);
+                }
+                return i + sse2::TrimLeftKernel(pData + i, Len - i);
+            }
+
+            XSTRTOOL_TARGET_AVX2
+            std::size_t TrimRightKernel(const char* pData, const std::size_t Len) noexcept
+            {
+                std::size_t i = Len;
+                for (; i >= 32; i -= 32)
+                {
+                    const std::uint32_t NonWs = ~SpaceMask(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(pData + i - 32)));
+                    if (NonWs) return i - 32 + (32 - std::countl_zero(NonWs));
+                }
+                return sse2::TrimRightKernel(pData, i);
+            }
+
+            XSTRTOOL_TARGET_AVX2
+            void SplitKernel(const std::string_view InputView, const char Delim, std::vector<std::string_view>& Result) noexcept
+            {
+                const char*       pData = InputView.data();
+                const std::size_t Len   = InputView.size();
+                const __m256i     D     = _mm256_set1_epi8(Delim);
+                std::size_t       Start = 0;
+                std::size_t       i     = 0;
+                for (; i + 32 <= Len; i += 32)
+                {
+                    const __m256i V = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pData + i));
+                    EmitSplitParts(InputView, i, static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(V, D))), Start, Result);
+                }
+                for (; i < Len; ++i)
+                {
+                    if (pData[i] == Delim)
+                    {
+                        Result.push_back(InputView.substr(Start, i - Start));
+                        Start = i + 1;
+                    }
+                }
+                Result.push_back(InputView.substr(Start));
+            }
+
+            XSTRTOOL_TARGET_AVX2
+            std::uint64_t DelimMaskKernel(const char* pData, const std::size_t Len, const char Delim, std::size_t& Pos) noexcept
+            {
+                const __m256i D = _mm256_set1_epi8(Delim);
+                for (; Pos + 64 <= Len; Pos += 64)
+                {
+                    const __m256i       Lo   = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pData + Pos));
+                    const __m256i       Hi   = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pData + Pos + 32));
+                    const std::uint64_t Mask = static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(Lo, D)))
+                                             | static_cast<std::uint64_t>(static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(Hi, D)))) << 32;
+                    if (Mask) return Mask;
+                }
+                return sse2::DelimMaskKernel(pData, Len, Delim, Pos);
+            }
+
+            // PrefixXor with one carry-less multiply by all ones
+            XSTRTOOL_TARGET_AVX2
+            inline std::uint64_t ClmulPrefixXor(const std::uint64_t X) noexcept
+            {
+                return static_cast<std::uint64_t>(_mm_cvtsi128_si64(_mm_clmulepi64_si128(_mm_cvtsi64_si128(static_cast<long long>(X)), _mm_set1_epi8(-1), 0)));
+            }
+
+            XSTRTOOL_TARGET_AVX2
+            std::uint64_t CsvMaskKernel(const char* pData, const std::size_t Len, const char Delim, std::size_t& Pos, std::uint64_t& Inside) noexcept
+            {
+                const __m256i D = _mm256_set1_epi8(Delim);
+                const __m256i N = _mm256_set1_epi8('\n');
+                const __m256i Q = _mm256_set1_epi8('"');
+                for (; Pos + 64 <= Len; Pos += 64)
+                {
+                    const __m256i       Lo         = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pData + Pos));
+                    const __m256i       Hi         = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pData + Pos + 32));
+                    const std::uint64_t Quotes     = static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(Lo, Q)))
+                                                   | static_cast<std::uint64_t>(static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(Hi, Q)))) << 32;
+                    const std::uint64_t Structural = static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_or_si256(_mm256_cmpeq_epi8(Lo, D), _mm256_cmpeq_epi8(Lo, N))))
+                                                   | static_cast<std::uint64_t>(static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_or_si256(_mm256_cmpeq_epi8(Hi, D), _mm256_cmpeq_epi8(Hi, N))))) << 32;
+                    if (const std::uint64_t Mask = CsvStructural(Structural, ClmulPrefixXor(Quotes), Inside); Mask) return Mask;
+                }
+                return sse2::CsvMaskKernel(pData, Len, Delim, Pos, Inside);
+            }
+
+            // See sse42::SetMatch, PSHUFB works on each 16 byte half so the tables are in both
+            XSTRTOOL_TARGET_AVX2
+            inline __m256i SetMatch(const __m256i Low, const __m256i High, const __m256i V) noexcept
+            {
+                const __m256i Bits = _mm256_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128);
+                const __m256i Row  = _mm256_or_si256(_mm256_shuffle_epi8(Low, V), _mm256_shuffle_epi8(High, _mm256_xor_si256(V, _mm256_set1_epi8(-128))));
+                const __m256i Bit  = _mm256_shuffle_epi8(Bits, _mm256_and_si256(_mm256_srli_epi16(V, 4), _mm256_set1_epi8(0xF)));
+                return _mm256_cmpeq_epi8(_mm256_and_si256(Row, Bit), Bit);
+            }
+
+            XSTRTOOL_TARGET_AVX2
+            std::uint64_t SetMaskKernel(const std::uint8_t* pTables, const char* pData, const std::size_t Len, const bool bNegate, std::size_t& Pos) noexcept
+            {
+                const __m256i       Low  = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pTables)));
+                const __m256i       High = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pTables + 16)));
+                const std::uint64_t Flip = bNegate ? ~std::uint64_t(0) : 0;
+                for (; Pos + 64 <= Len; Pos += 64)
+                {
+                    const __m256i Lo   = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pData + Pos));
+                    const __m256i Hi   = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pData + Pos + 32));
+                    std::uint64_t Mask = static_cast<std::uint32_t>(_mm256_movemask_epi8(SetMatch(Low, High, Lo)))
+                                       | static_cast<std::uint64_t>(static_cast<std::uint32_t>(_mm256_movemask_epi8(SetMatch(Low, High, Hi)))) << 32;
+                    if (Mask ^= Flip) return Mask;
+                }
+                return sse42::SetMaskKernel(pTables, pData, Len, bNegate, Pos);
+            }
+
+            XSTRTOOL_TARGET_AVX2
+            std::size_t SetRFindKernel(const std::uint8_t* pTables, const char* pData, std::size_t End) noexcept
+            {
+                const __m256i Low  = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pTables)));
+                const __m256i High = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pTables + 16)));
+                for (; End >= 32; End -= 32)
+                {
+                    const __m256i V    = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pData + End - 32));
+                    const auto    Mask = static_cast<std::uint32_t>(_mm256_movemask_epi8(SetMatch(Low, High, V)));
+                    if (Mask) return End - 32 + (31 - std::countl_zero(Mask));
+                }
+                return sse42::SetRFindKernel(pTables, pData, End);
+            }
+
+            XSTRTOOL_TARGET_AVX2
+            std::size_t LowerAsciiKernel(char* pDest, const char* pSrc, const std::size_t Len) noexcept
+            {
+                std::size_t i = 0;
+                for (; i + 32 <= Len; i += 32)
+                {
+                    const __m256i V = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pSrc + i));
+                    _mm256_storeu_si256(reinterpret_cast<__m256i*>(pDest + i), LowerBlock(V));
+                    if (const auto NonAscii = static_cast<std::uint32_t>(_mm256_movemask_epi8(V)); NonAscii) return i + std::countr_zero(NonAscii);
+                }
+                return i + sse2::LowerAsciiKernel(pDest + i, pSrc + i, Len - i);
+            }
+
+            XSTRTOOL_TARGET_AVX2
+            std::size_t MismatchAsciiIKernel(const char* pA, const char* pB, const std::size_t Len) noexcept
+            {
+                std::size_t i = 0;
+                for (; i + 32 <= Len; i += 32)
+                {
+                    const __m256i       Va   = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pA + i));
+                    const __m256i       Vb   = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pB + i));
+                    const std::uint32_t Stop = ~static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(LowerBlock(Va), LowerBlock(Vb))))
+                                             |  static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_or_si256(Va, Vb)));
+                    if (Stop) return i + std::countr_zero(Stop);
+                }
+                return i + sse2::MismatchAsciiIKernel(pA + i, pB + i, Len - i);
+            }
+
+            XSTRTOOL_TARGET_AVX2
+            inline std::uint32_t DigitMask(const __m256i V) noexcept
+            {
+                return static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_and_si256(_mm256_cmpgt_epi8(V, _mm256_set1_epi8('0' - 1)), _mm256_cmpgt_epi8(_mm256_set1_epi8('9' + 1), V))));
+            }
+
+            XSTRTOOL_TARGET_AVX2
+            std::size_t MismatchIKernel(const char* pA, const char* pB, const std::size_t Len) noexcept
+            {
+                std::size_t i = 0;
+                for (; i + 32 <= Len; i += 32)
+                {
+                    const __m256i       Va = LowerBlock(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(pA + i)));
+                    const __m256i       Vb = LowerBlock(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(pB + i)));
+                    const std::uint32_t Ne = ~static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(Va, Vb)));
+                    if (Ne) return i + std::countr_zero(Ne);
+                }
+                return i + sse2::MismatchIKernel(pA + i, pB + i, Len - i);
+            }
+
+            XSTRTOOL_TARGET_AVX2
+            std::size_t DigitSpanKernel(const char* pData, const std::size_t Len) noexcept
+            {
+                std::size_t i = 0;
+                for (; i + 32 <= Len; i += 32)
+                {
+                    const std::uint32_t NonDigit = ~DigitMask(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(pData + i)));
+                    if (NonDigit) return i + std::countr_zero(NonDigit);
+                }
+                return i + sse2::DigitSpanKernel(pData + i, Len - i);
+            }
+
+            //--------------------------------------------------------------------------------
+            // Wide kernels (see sse2), the tails are left to the SSE2 kernels
+            //--------------------------------------------------------------------------------
+            constexpr std::size_t   WideLanes_v = 32 / sizeof(wchar_t);
+            constexpr std::uint32_t WideFull_v  = (1u << WideLanes_v) - 1;
+
+            XSTRTOOL_TARGET_AVX2
+            inline __m256i LoadW(const wchar_t* pData) noexcept
+            {
+                return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pData));
+            }
+
+            XSTRTOOL_TARGET_AVX2
+            inline __m256i Set1W(const wchar_t C) noexcept
+            {
+                if constexpr (sizeof(wchar_t) == 4) return _mm256_set1_epi32(static_cast<int>(C));
+                else                                return _mm256_set1_epi16(static_cast<short>(C));
+            }
+
+            XSTRTOOL_TARGET_AVX2
+            inline __m256i CmpEqW(const __m256i A, const __m256i B) noexcept
+            {
+                if constexpr (sizeof(wchar_t) == 4) return _mm256_cmpeq_epi32(A, B);
+                else                                return _mm256_cmpeq_epi16(A, B);
+            }
+
+            XSTRTOOL_TARGET_AVX2
+            inline __m256i CmpGtW(const __m256i A, const __m256i B) noexcept
+            {
+                if constexpr (sizeof(wchar_t) == 4) return _mm256_cmpgt_epi32(A, B);
+                else                                return _mm256_cmpgt_epi16(A, B);
+            }
+
+            // One bit per lane (the 16 bit lanes use PEXT since PACKSSWB would interleave the 128 bit halves)
+            XSTRTOOL_TARGET_AVX2
+            inline std::uint32_t MoveMaskW(const __m256i Mask) noexcept
+            {
+                if constexpr (sizeof(wchar_t) == 4) return static_cast<std::uint32_t>(_mm256_movemask_ps(_mm256_castsi256_ps(Mask)));
+                else                                return _pext_u32(static_cast<std::uint32_t>(_mm256_movemask_epi8(Mask)), 0x55555555u);
+            }
+
+            XSTRTOOL_TARGET_AVX2
+            inline __m256i LowerBlockW(const __m256i V) noexcept
+            {
+                const __m256i Mask = _mm256_and_si256(CmpGtW(V, Set1W(L'A' - 1)), CmpGtW(Set1W(L'Z' + 1), V));
+                return _mm256_or_si256(V, _mm256_and_si256(Mask, Set1W(32)));
+            }
+
+            XSTRTOOL_TARGET_AVX2
+            inline __m256i UpperBlockW(const __m256i V) noexcept
+            {
+                const __m256i Mask = _mm256_and_si256(CmpGtW(V, Set1W(L'a' - 1)), CmpGtW(Set1W(L'z' + 1), V));
+                return _mm256_andnot_si256(_mm256_and_si256(Mask, Set1W(32)), V);
+            }
+
+            XSTRTOOL_TARGET_AVX2
+            inline std::uint32_t SpaceMaskW(const __m256i V) noexcept
+            {
+                const __m256i Ws = _mm256_or_si256( _mm256_or_si256(CmpEqW(V, Set1W(L' ')),  CmpEqW(V, Set1W(L'\t')))
+                                                  , _mm256_or_si256(CmpEqW(V, Set1W(L'\n')), CmpEqW(V, Set1W(L'\r'))));
+                return MoveMaskW(Ws);
+            }
+
+            template< bool T_TO_UPPER_V >
+            XSTRTOOL_TARGET_AVX2
+            std::size_t CaseAsciiKernel(wchar_t* pDest, const wchar_t* pSrc, const std::size_t Len) noexcept
+            {
+                const __m256i NonAscii = Set1W(static_cast<wchar_t>(~0x7F));
+                std::size_t   i        = 0;
+                for (; i + WideLanes_v <= Len; i += WideLanes_v)
+                {
+                    const __m256i V = LoadW(pSrc + i);
+                    if (!_mm256_testz_si256(V, NonAscii)) return i;
+                    _mm256_storeu_si256(reinterpret_cast<__m256i*>(pDest + i), T_TO_UPPER_V ? UpperBlockW(V) : LowerBlockW(V));
+                }
+                return i + sse2::CaseAsciiKernel<T_TO_UPPER_V>(pDest + i, pSrc + i, Len - i);
+            }
+
+            XSTRTOOL_TARGET_AVX2
+            int CompareIKernel(const wchar_t* pA, const wchar_t* pB, const std::size_t Len) noexcept
+            {
+                std::size_t i = 0;
+                for (; i + WideLanes_v <= Len; i += WideLanes_v)
+                {
+                    const std::uint32_t Eq = MoveMaskW(CmpEqW(LowerBlockW(LoadW(pA + i)), LowerBlockW(LoadW(pB + i))));
+                    if (Eq != WideFull_v)
+                    {
+                        const std::size_t j  = i + std::countr_zero(~Eq);
+                        const wchar_t     Ca = ToLower(pA[j]), Cb = ToLower(pB[j]);
+                        return (Ca < Cb) ? -1 : 1;
+                    }
+                }
+                return sse2::CompareIKernel(pA + i, pB + i, Len - i);
+            }
+
+            XSTRTOOL_TARGET_AVX2
+            inline bool EqualsLowered(const wchar_t* pHay, const wchar_t* pLowerNeedle, const std::size_t Len) noexcept
+            {
+                std::size_t i = 0;
+                for (; i + WideLanes_v <= Len; i += WideLanes_v)
+                {
+                    if (MoveMaskW(CmpEqW(LowerBlockW(LoadW(pHay + i)), LoadW(pLowerNeedle + i))) != WideFull_v) return false;
+                }
+                return sse2::EqualsLowered(pHay + i, pLowerNeedle + i, Len - i);
+            }
+
+            XSTRTOOL_TARGET_AVX2
+            std::size_t FindIKernel(const std::wstring_view Haystack, const std::wstring_view LowerNeedle, const std::size_t Pos) noexcept
+            {
+                const wchar_t*    pHay   = Haystack.data();
+                const std::size_t End    = Haystack.size() - LowerNeedle.size() + 1;     // One past the last candidate
+                const __m256i     VFirst = Set1W(LowerNeedle[0]);
+                std::size_t       i      = Pos;
+                for (; i + WideLanes_v <= End; i += WideLanes_v)
+                {
+                    for (std::uint32_t Mask = MoveMaskW(CmpEqW(LowerBlockW(LoadW(pHay + i)), VFirst)); Mask; Mask &= Mask - 1)
+                    {
+                        const std::size_t Candidate = i + std::countr_zero(Mask);
+                        if (EqualsLowered(pHay + Candidate + 1, LowerNeedle.data() + 1, LowerNeedle.size() - 1)) return Candidate;
+                    }
+                }
+                return (i < End) ? sse2::FindIKernel(Haystack, LowerNeedle, i) : std::wstring::npos;
+            }
+
+            XSTRTOOL_TARGET_AVX2
+            std::size_t RFindIKernel(const std::wstring_view Haystack, const std::wstring_view LowerNeedle, const std::size_t StartPos) noexcept
+            {
+                const wchar_t*    pHay   = Haystack.data();
+                const std::size_t Last   = LowerNeedle.size() - 1;
+                const __m256i     VFirst = Set1W(LowerNeedle[0]);
+                const __m256i     VLast  = Set1W(LowerNeedle[Last]);
+                std::size_t       End    = StartPos + 1;                                 // One past the last candidate
+                for (; End >= WideLanes_v; End -= WideLanes_v)
+                {
+                    // Both the first and the last character of the needle must match before a candidate is verified
+                    const std::size_t Base = End - WideLanes_v;
+                    for (std::uint32_t Mask = MoveMaskW(CmpEqW(LowerBlockW(LoadW(pHay + Base)), VFirst)) & MoveMaskW(CmpEqW(LowerBlockW(LoadW(pHay + Base + Last)), VLast)); Mask; )
+                    {
+                        const int Lane = std::bit_width(Mask) - 1;
+                        if (EqualsLowered(pHay + Base + Lane + 1, LowerNeedle.data() + 1, Last)) return Base + Lane;
+                        Mask ^= 1u << Lane;
+                    }
+                }
+                return (End > 0) ? sse2::RFindIKernel(Haystack, LowerNeedle, End - 1) : std::wstring::npos;
+            }
+
+            XSTRTOOL_TARGET_AVX2
+            std::size_t TrimLeftKernel(const wchar_t* pData, const std::size_t Len) noexcept
+            {
+                std::size_t i = 0;
+                for (; i + WideLanes_v <= Len; i += WideLanes_v)
+                {
+                    const std::uint32_t NonWs = ~SpaceMaskW(LoadW(pData + i)) & WideFull_v;
+                    if (NonWs) return i + std::countr_zero(NonWs);
+                }
+                return i + sse2::TrimLeftKernel(pData + i, Len - i);
+            }
+
+            XSTRTOOL_TARGET_AVX2
+            std::size_t TrimRightKernel(const wchar_t* pData, const std::size_t Len) noexcept
+            {
+                std::size_t i = Len;
+                for (; i >= WideLanes_v; i -= WideLanes_v)
+                {
+                    const std::uint32_t NonWs = ~SpaceMaskW(LoadW(pData + i - WideLanes_v)) & WideFull_v;
+                    if (NonWs) return i - WideLanes_v + (32 - std::countl_zero(NonWs));
+                }
+                return sse2::TrimRightKernel(pData, i);
+            }
+
+            XSTRTOOL_TARGET_AVX2
+            void SplitKernel(const std::wstring_view InputView, const wchar_t Delim, std::vector<std::wstring_view>& Result) noexcept
+            {
+                const wchar_t*    pData = InputView.data();
+                const std::size_t Len   = InputView.size();
+                const __m256i     D     = Set1W(Delim);
+                std::size_t       Start = 0;
+                std::size_t       i     = 0;
+                for (; i + WideLanes_v <= Len; i += WideLanes_v)
+                {
+                    EmitSplitParts(InputView, i, MoveMaskW(CmpEqW(LoadW(pData + i), D)), Start, Result);
+                }
+                for (; i < Len; ++i)
+                {
+                    if (pData[i] == Delim)
+                    {
+                        Result.push_back(InputView.substr(Start, i - Start));
+                        Start = i + 1;
+                    }
+                }
+                Result.push_back(InputView.substr(Start));
+            }
+
+            XSTRTOOL_TARGET_AVX2
+            std::uint64_t DelimMaskKernel(const wchar_t* pData, const std::size_t Len, const wchar_t Delim, std::size_t& Pos) noexcept
+            {
+                const __m256i D = Set1W(Delim);
+                for (; Pos + 64 <= Len; Pos += 64)
+                {
+                    std::uint64_t Mask = 0;
+                    for (std::size_t i = 0; i < 64; i += WideLanes_v) Mask |= static_cast<std::uint64_t>(MoveMaskW(CmpEqW(LoadW(pData + Pos + i), D))) << i;
+                    if (Mask) return Mask;
+                }
+                return sse2::DelimMaskKernel(pData, Len, Delim, Pos);
+            }
+
+            // See sse42::SetMatchW
+            XSTRTOOL_TARGET_AVX2
+            inline __m256i SetMatchW(const __m256i Low, const __m256i High, const __m256i V) noexcept
+            {
+                const __m256i Byte = Set1W(static_cast<wchar_t>(0xFF));
+                return _mm256_and_si256( CmpEqW(_mm256_and_si256(SetMatch(Low, High, V), Byte), Byte)
+                                       , CmpEqW(_mm256_andnot_si256(Byte, V), _mm256_setzero_si256()));
+            }
+
+            XSTRTOOL_TARGET_AVX2
+            std::uint64_t SetMaskKernel(const std::uint8_t* pTables, const wchar_t* pData, const std::size_t Len, const bool bNegate, std::size_t& Pos) noexcept
+            {
+                const __m256i       Low  = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pTables)));
+                const __m256i       High = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pTables + 16)));
+                const std::uint64_t Flip = bNegate ? ~std::uint64_t(0) : 0;
+                for (; Pos + 64 <= Len; Pos += 64)
+                {
+                    std::uint64_t Mask = 0;
+                    for (std::size_t i = 0; i < 64; i += WideLanes_v) Mask |= static_cast<std::uint64_t>(MoveMaskW(SetMatchW(Low, High, LoadW(pData + Pos + i)))) << i;
+                    if (Mask ^= Flip) return Mask;
+                }
+                return sse42::SetMaskKernel(pTables, pData, Len, bNegate, Pos);
+            }
+
+            XSTRTOOL_TARGET_AVX2
+            std::size_t SetRFindKernel(const std::uint8_t* pTables, const wchar_t* pData, std::size_t End) noexcept
+            {
+                const __m256i Low  = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pTables)));
+                const __m256i High = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pTables + 16)));
+                for (; End >= WideLanes_v; End -= WideLanes_v)
+                {
+                    const std::uint32_t Mask = MoveMaskW(SetMatchW(Low, High, LoadW(pData + End - WideLanes_v)));
+                    if (Mask) return End - WideLanes_v + (31 - std::countl_zero(Mask));
+                }
+                return sse42::SetRFindKernel(pTables, pData, End);
+            }
+
+            XSTRTOOL_TARGET_AVX2
+            inline std::uint32_t DigitMaskW(const __m256i V) noexcept
+            {
+                return MoveMaskW(_mm256_and_si256(CmpGtW(V, Set1W(L'0' - 1)), CmpGtW(Set1W(L'9' + 1), V)));
+            }
+
+            XSTRTOOL_TARGET_AVX2
+            std::size_t MismatchIKernel(const wchar_t* pA, const wchar_t* pB, const std::size_t Len) noexcept
+            {
+                std::size_t i = 0;
+                for (; i + WideLanes_v <= Len; i += WideLanes_v)
+                {
+                    const std::uint32_t Eq = MoveMaskW(CmpEqW(LowerBlockW(LoadW(pA + i)), LowerBlockW(LoadW(pB + i))));
+                    if (Eq != WideFull_v) return i + std::countr_zero(~Eq);
+                }
+                return i + sse2::MismatchIKernel(pA + i, pB + i, Len - i);
+            }
+
+            XSTRTOOL_TARGET_AVX2
+            std::size_t DigitSpanKernel(const wchar_t* pData, const std::size_t Len) noexcept
+            {
+                std::size_t i = 0;
+                for (; i + WideLanes_v <= Len; i += WideLanes_v)
+                {
+                    const std::uint32_t NonDigit = ~DigitMaskW(LoadW(pData + i)) & WideFull_v;
+                    if (NonDigit) return i + std::countr_zero(NonDigit);
+                }
+                return i + sse2::DigitSpanKernel(pData + i, Len - i);
+            }
+
+            //--------------------------------------------------------------------------------
+            // Case-insensitive hash (see HashIFinalize), one stripe per step
+            //--------------------------------------------------------------------------------
+            template< typename T_CHAR >
+            XSTRTOOL_TARGET_AVX2
+            inline __m256i FoldBlock(const __m256i V) noexcept
+            {
+                if constexpr (sizeof(T_CHAR) == 1) return LowerBlock(V);
+                else                               return LowerBlockW(V);
+            }
+
+            XSTRTOOL_TARGET_AVX2
+            inline __m256i HashIRound(const __m256i Acc, const __m256i Data, const __m256i Secret) noexcept
+            {
+                const __m256i K   = _mm256_xor_si256(Data, Secret);
+                const __m256i Rot = _mm256_or_si256(_mm256_slli_epi64(Acc, 23), _mm256_srli_epi64(Acc, 41));
+                return _mm256_add_epi64(_mm256_add_epi64(Rot, _mm256_mul_epu32(K, _mm256_srli_epi64(K, 32))), Data);
+            }
+
+            template< typename T_CHAR >
+            XSTRTOOL_TARGET_AVX2
+            std::uint64_t HashIKernel(const T_CHAR* pData, const std::size_t Len) noexcept
+            {
+                constexpr std::size_t Stripe_v = 32 / sizeof(T_CHAR);
+                const __m256i         Secret   = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(HashISecret_v));
+                __m256i               Acc      = Secret;
+                std::size_t           i        = 0;
+                for (; i + Stripe_v <= Len; i += Stripe_v) Acc = HashIRound(Acc, FoldBlock<T_CHAR>(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(pData + i))), Secret);
+                if (Len < Stripe_v)
+                {
+                    T_CHAR Padded[Stripe_v] = {};
+                    if (Len) std::memcpy(Padded, pData, Len * sizeof(T_CHAR));
+                    Acc = HashIRound(Acc, FoldBlock<T_CHAR>(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(Padded))), Secret);
+                }
+                else if (i < Len)
+                {
+                    Acc = HashIRound(Acc, FoldBlock<T_CHAR>(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(pData + Len - Stripe_v))), Secret);
+                }
+
+                std::uint64_t Lanes[4];
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(Lanes), Acc);
+                return HashIFinalize(Lanes, Len * sizeof(T_CHAR));
+            }
+        }
+
+        //--------------------------------------------------------------------------------
+        // AVX-512BW kernels (64 bytes per step, the tail is handled with masked loads)
+        //--------------------------------------------------------------------------------
+        namespace avx512
+        {
+            XSTRTOOL_TARGET_AVX512BW
+            inline __m512i LowerBlock(const __m512i V) noexcept
+            {
+                const __mmask64 IsUpper = _mm512_cmplt_epu8_mask(_mm512_sub_epi8(V, _mm512_set1_epi8('A')), _mm512_set1_epi8(26));
+                return _mm512_mask_add_epi8(V, IsUpper, V, _mm512_set1_epi8(32));
+            }
+
+            XSTRTOOL_TARGET_AVX512BW
+            inline __mmask64 SpaceMask(const __m512i V) noexcept
+            {
+                return _mm512_cmpeq_epi8_mask(V, _mm512_set1_epi8(' '))
+                     | _mm512_cmpeq_epi8_mask(V, _mm512_set1_epi8('\t'))
+                     | _mm512_cmpeq_epi8_mask(V, _mm512_set1_epi8('\n'))
+                     | _mm512_cmpeq_epi8_mask(V, _mm512_set1_epi8('\r'));
+            }
+
+            XSTRTOOL_TARGET_AVX512BW
+            inline __m512i UpperBlock(const __m512i V) noexcept
+            {
+                const __mmask64 IsLower = _mm512_cmplt_epu8_mask(_mm512_sub_epi8(V, _mm512_set1_epi8('a')), _mm512_set1_epi8(26));
+                return _mm512_mask_sub_epi8(V, IsLower, V, _mm512_set1_epi8(32));
+            }
+
+            XSTRTOOL_TARGET_AVX512BW
+            void ToLowerKernel(char* pDest, const char* pSrc, const std::size_t Len) noexcept
+            {
+                for (std::size_t i = 0; i < Len; i += 64)
+                {
+                    const __mmask64 M = TailMask64(Len - i);
+                    _mm512_mask_storeu_epi8(pDest + i, M, LowerBlock(_mm512_maskz_loadu_epi8(M, pSrc + i)));
+                }
+            }
+
+            XSTRTOOL_TARGET_AVX512BW
+            void ToUpperKernel(char* pDest, const char* pSrc, const std::size_t Len) noexcept
+            {
+                for (std::size_t i = 0; i < Len; i += 64)
+                {
+                    const __mmask64 M = TailMask64(Len - i);
+                    _mm512_mask_storeu_epi8(pDest + i, M, UpperBlock(_mm512_maskz_loadu_epi8(M, pSrc + i)));
+                }
+            }
+
+            XSTRTOOL_TARGET_AVX512BW
+            int CompareIKernel(const char* pA, const char* pB, const std::size_t Len) noexcept
+            {
+                for (std::size_t i = 0; i < Len; i += 64)
+                {
+                    const __mmask64 M  = TailMask64(Len - i);
+                    const __m512i   Va = LowerBlock(_mm512_maskz_loadu_epi8(M, pA + i));
+                    const __m512i   Vb = LowerBlock(_mm512_maskz_loadu_epi8(M, pB + i));
+                    const __mmask64 Ne = _mm512_mask_cmpneq_epi8_mask(M, Va, Vb);
+                    if (Ne)
+                    {
+                        const std::size_t j  = i + std::countr_zero(static_cast<std::uint64_t>(Ne));
+                        const char        Ca = ToLower(pA[j]), Cb = ToLower(pB[j]);
+                        return (Ca < Cb) ? -1 : 1;
+                    }
+                }
+                return 0;
+            }
+
+            XSTRTOOL_TARGET_AVX512BW
+            inline bool EqualsLowered(const char* pHay, const char* pLowerNeedle, const std::size_t Len) noexcept
+            {
+                for (std::size_t i = 0; i < Len; i += 64)
+                {
+                    const __mmask64 M  = TailMask64(Len - i);
+                    const __m512i   Vh = LowerBlock(_mm512_maskz_loadu_epi8(M, pHay + i));
+                    const __m512i   Vn = _mm512_maskz_loadu_epi8(M, pLowerNeedle + i);
+                    if (_mm512_mask_cmpneq_epi8_mask(M, Vh, Vn)) return false;
+                }
+                return true;
+            }
+
+            template< bool T_IGNORE_CASE_V >
+            XSTRTOOL_TARGET_AVX512BW
+            std::size_t FindKernel(const std::string_view Haystack, const std::string_view Needle, const std::size_t Pos, const std::size_t Anchor1, const std::size_t Anchor2) noexcept
+            {
+                const char*       pHay   = Haystack.data();
+                const std::size_t End    = Haystack.size() - Needle.size() + 1;
+                const __m512i     VA1    = _mm512_set1_epi8(Needle[Anchor1]);
+                const __m512i     VA2    = _mm512_set1_epi8(Needle[Anchor2]);
+                const __m512i     VCase1 = T_IGNORE_CASE_V ? _mm512_set1_epi8(sse2::AnchorCase(Needle[Anchor1])) : _mm512_setzero_si512();
+                const __m512i     VCase2 = T_IGNORE_CASE_V ? _mm512_set1_epi8(sse2::AnchorCase(Needle[Anchor2])) : _mm512_setzero_si512();
+                for (std::size_t i = Pos; i < End; i += 64)
+                {
+                    const __mmask64 M  = TailMask64(End - i);
+                    const __m512i   V1 = _mm512_or_si512(_mm512_maskz_loadu_epi8(M, pHay + i + Anchor1), VCase1);
+                    const __m512i   V2 = _mm512_or_si512(_mm512_maskz_loadu_epi8(M, pHay + i + Anchor2), VCase2);
+                    for (auto Mask = static_cast<std::uint64_t>(_mm512_mask_cmpeq_epi8_mask(_mm512_mask_cmpeq_epi8_mask(M, V1, VA1), V2, VA2)); Mask; Mask &= Mask - 1)
+                    {
+                        const std::size_t Candidate = i + std::countr_zero(Mask);
+                        if (T_IGNORE_CASE_V ? EqualsLowered(pHay + Candidate, Needle.data(), Needle.size()) : std::memcmp(pHay + Candidate, Needle.data(), Needle.size()) == 0) return Candidate;
+                    }
+                }
+                return std::string::npos;
+            }
+
+            template< bool T_IGNORE_CASE_V >
+            XSTRTOOL_TARGET_AVX512BW
+            std::size_t CountKernel(const std::string_view Haystack, const std::string_view Needle, const std::size_t Pos, const std::size_t Anchor1, const std::size_t Anchor2) noexcept
+            {
+                const char*       pHay   = Haystack.data();
+                const std::size_t End    = Haystack.size() - Needle.size() + 1;
+                const bool        bExact = Needle.size() <= 2;
+                const __m512i     VA1    = _mm512_set1_epi8(Needle[Anchor1]);
+                const __m512i     VA2    = _mm512_set1_epi8(Needle[Anchor2]);
+                const __m512i     VCase1 = T_IGNORE_CASE_V ? _mm512_set1_epi8(sse2::AnchorCase(Needle[Anchor1])) : _mm512_setzero_si512();
+                const __m512i     VCase2 = T_IGNORE_CASE_V ? _mm512_set1_epi8(sse2::AnchorCase(Needle[Anchor2])) : _mm512_setzero_si512();
+                std::size_t       Count  = 0;
+                for (std::size_t i = Pos; i < End; i += 64)
+                {
+                    const __mmask64 M    = TailMask64(End - i);
+                    const __m512i   V1   = _mm512_or_si512(_mm512_maskz_loadu_epi8(M, pHay + i + Anchor1), VCase1);
+                    const __m512i   V2   = _mm512_or_si512(_mm512_maskz_loadu_epi8(M, pHay + i + Anchor2), VCase2);
+                    auto            Mask = static_cast<std::uint64_t>(_mm512_mask_cmpeq_epi8_mask(_mm512_mask_cmpeq_epi8_mask(M, V1, VA1), V2, VA2));
+                    if (bExact)
+                    {
+                        Count += std::popcount(Mask);
+                        continue;
+                    }
+                    for (; Mask; Mask &= Mask - 1)
+                    {
+                        const std::size_t Candidate = i + std::countr_zero(Mask);
+                        Count += T_IGNORE_CASE_V ? EqualsLowered(pHay + Candidate, Needle.data(), Needle.size()) : std::memcmp(pHay + Candidate, Needle.data(), Needle.size()) == 0;
+                    }
+                }
+                return Count;
+            }
+
+            XSTRTOOL_TARGET_AVX512BW
+            std::size_t TeddyKernel(const std::uint8_t* pMasks, const std::size_t FingerprintLen, const char* pData, std::size_t Pos, const std::size_t End, std::uint8_t& Buckets) noexcept
+            {
+                const __m512i Nibble = _mm512_set1_epi8(0xF);
+                __m512i       Low[3], High[3];
+                for (std::size_t k = 0; k < FingerprintLen; ++k)
+                {
+                    Low[k]  = _mm512_maskz_broadcast_i32x4(0xFFFF, _mm_loadu_si128(reinterpret_cast<const __m128i*>(pMasks + k * 32)));
+                    High[k] = _mm512_maskz_broadcast_i32x4(0xFFFF, _mm_loadu_si128(reinterpret_cast<const __m128i*>(pMasks + k * 32 + 16)));
+                }
+
+                for (; Pos < End; Pos += 64)
+                {
+                    const __mmask64 M   = TailMask64(End - Pos);
+                    __m512i         Acc = _mm512_set1_epi8(-1);
+                    for (std::size_t k = 0; k < FingerprintLen; ++k)
+                    {
+                        const __m512i V = _mm512_maskz_loadu_epi8(M, pData + Pos + k);
+                        Acc = _mm512_and_si512(Acc, _mm512_and_si512( _mm512_shuffle_epi8(Low[k],  _mm512_and_si512(V, Nibble))
+                                                                    , _mm512_shuffle_epi8(High[k], _mm512_and_si512(_mm512_maskz_srli_epi16(~__mmask32(0), V, 4), Nibble))));
+                    }
+
+                    if (const auto Mask = static_cast<std::uint64_t>(_mm512_mask_test_epi8_mask(M, Acc, Acc)); Mask)
+                    {
+                        alignas(64) std::uint8_t Lanes[64];
+                        _mm512_store_si512(Lanes, Acc);
+                        Buckets = Lanes[std::countr_zero(Mask)];
+                        return Pos + std::countr_zero(Mask);
+                    }
+                }
+                return std::string::npos;
+            }
+
+            template< bool T_IGNORE_CASE_V >
+            XSTRTOOL_TARGET_AVX512BW
+            std::size_t RFindKernel(const std::string_view Haystack, const std::string_view Needle, const std::size_t Pos, const std::size_t Anchor1, const std::size_t Anchor2) noexcept
+            {
+                const char*       pHay   = Haystack.data();
+                const __m512i     VA1    = _mm512_set1_epi8(Needle[Anchor1]);
+                const __m512i     VA2    = _mm512_set1_epi8(Needle[Anchor2]);
+                const __m512i     VCase1 = T_IGNORE_CASE_V ? _mm512_set1_epi8(sse2::AnchorCase(Needle[Anchor1])) : _mm512_setzero_si512();
+                const __m512i     VCase2 = T_IGNORE_CASE_V ? _mm512_set1_epi8(sse2::AnchorCase(Needle[Anchor2])) : _mm512_setzero_si512();
+                for (std::size_t End = Pos + 1; End > 0; )
+                {
+                    const std::size_t Base = End > 64 ? End - 64 : 0;
+                    const __mmask64   M    = TailMask64(End - Base);
+                    const __m512i     V1   = _mm512_or_si512(_mm512_maskz_loadu_epi8(M, pHay + Base + Anchor1), VCase1);
+                    const __m512i     V2   = _mm512_or_si512(_mm512_maskz_loadu_epi8(M, pHay + Base + Anchor2), VCase2);
+                    for (auto Mask = static_cast<std::uint64_t>(_mm512_mask_cmpeq_epi8_mask(_mm512_mask_cmpeq_epi8_mask(M, V1, VA1), V2, VA2)); Mask; )
+                    {
+                        const int         Lane      = 63 - std::countl_zero(Mask);
+                        const std::size_t Candidate = Base + Lane;
+                        if (T_IGNORE_CASE_V ? EqualsLowered(pHay + Candidate, Needle.data(), Needle.size()) : std::memcmp(pHay + Candidate, Needle.data(), Needle.size()) == 0) return Candidate;
+                        Mask ^= std::uint64_t(1) << Lane;
+                    }
+                    End = Base;
+                }
+                return std::string::npos;
+            }
+
+            XSTRTOOL_TARGET_AVX512BW
+            std::size_t TrimLeftKernel(const char* pData, const std::size_t Len) noexcept
+            {
+                for (std::size_t i = 0; i < Len; i += 64)
+                {
+                    const __mmask64 M     = TailMask64(Len - i);
+                    const __mmask64 NonWs = ~SpaceMask(_mm512_maskz_loadu_epi8(M, pData + i)) & M;
+                    if (NonWs) return i + std::countr_zero(NonWs);
+                }
+                return Len;
+            }
+
+            XSTRTOOL_TARGET_AVX512BW
+            std::size_t TrimRightKernel(const char* pData, const std::size_t Len) noexcept
+            {
+                for (std::size_t i = Len; i > 0; )
+                {
+                    const std::size_t Base  = i > 64 ? i - 64 : 0;
+                    const __mmask64   M     = TailMask64(i - Base);
+                    const __mmask64   NonWs = ~SpaceMask(_mm512_maskz_loadu_epi8(M, pData + Base)) & M;
+                    if (NonWs) return Base + (64 - std::countl_zero(NonWs));
+                    i = Base;
+                }
+                return 0;
+            }
+
+            XSTRTOOL_TARGET_AVX512BW
+            void SplitKernel(const std::string_view InputView, const char Delim, std::vector<std::string_view>& Result) noexcept
+            {
+                const char*       pData = InputView.data();
+                const std::size_t Len   = InputView.size();
+                const __m512i     D     = _mm512_set1_epi8(Delim);
+                std::size_t       Start = 0;
+                for (std::size_t i = 0; i < Len; i += 64)
+                {
+                    const __mmask64 M = TailMask64(Len - i);
+                    const __m512i   V = _mm512_maskz_loadu_epi8(M, pData + i);
+                    EmitSplitParts(InputView, i, static_cast<std::uint64_t>(_mm512_mask_cmpeq_epi8_mask(M, V, D)), Start, Result);
+                }
+                Result.push_back(InputView.substr(Start));
+            }
+
+            XSTRTOOL_TARGET_AVX512BW
+            std::uint64_t DelimMaskKernel(const char* pData, const std::size_t Len, const char Delim, std::size_t& Pos) noexcept
+            {
+                const __m512i D = _mm512_set1_epi8(Delim);
+                for (; Pos < Len; Pos += 64)
+                {
+                    const __mmask64     M    = TailMask64(Len - Pos);
+                    const std::uint64_t Mask = _mm512_mask_cmpeq_epi8_mask(M, _mm512_maskz_loadu_epi8(M, pData + Pos), D);
+                    if (Mask) return Mask;
+                }
+                Pos = Len;
+                return 0;
+            }
+
+            XSTRTOOL_TARGET_AVX512BW
+            std::uint64_t CsvMaskKernel(const char* pData, const std::size_t Len, const char Delim, std::size_t& Pos, std::uint64_t& Inside) noexcept
+            {
+                const __m512i D = _mm512_set1_epi8(Delim);
+                const __m512i N = _mm512_set1_epi8('\n');
+                const __m512i Q = _mm512_set1_epi8('"');
+                for (; Pos < Len; Pos += 64)
+                {
+                    const __mmask64     M          = TailMask64(Len - Pos);
+                    const __m512i       V          = _mm512_maskz_loadu_epi8(M, pData + Pos);
+                    const std::uint64_t Quotes     = _mm512_mask_cmpeq_epi8_mask(M, V, Q);
+                    const std::uint64_t Structural = _mm512_mask_cmpeq_epi8_mask(M, V, D) | _mm512_mask_cmpeq_epi8_mask(M, V, N);
+                    if (const std::uint64_t Mask = CsvStructural(Structural, avx2::ClmulPrefixXor(Quotes), Inside); Mask) return Mask;
+                }
+                Pos = Len;
+                return 0;
+            }
+
+            // See sse42::SetMatch, PSHUFB works on each 16 byte lane so the tables are in all of them
+            XSTRTOOL_TARGET_AVX512BW
+            inline std::uint64_t SetMatch(const __m512i Low, const __m512i High, const __m512i V) noexcept
+            {
+                const __m512i Bits = _mm512_maskz_broadcast_i32x4(0xFFFF, _mm_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128));
+                const __m512i Row  = _mm512_or_si512(_mm512_shuffle_epi8(Low, V), _mm512_shuffle_epi8(High, _mm512_xor_si512(V, _mm512_set1_epi8(-128))));
+                const __m512i Bit  = _mm512_shuffle_epi8(Bits, _mm512_and_si512(_mm512_srli_epi16(V, 4), _mm512_set1_epi8(0xF)));
+                return _mm512_test_epi8_mask(Row, Bit);
+            }
+
+            XSTRTOOL_TARGET_AVX512BW
+            std::uint64_t SetMaskKernel(const std::uint8_t* pTables, const char* pData, const std::size_t Len, const bool bNegate, std::size_t& Pos) noexcept
+            {
+                const __m512i Low  = _mm512_maskz_broadcast_i32x4(0xFFFF, _mm_loadu_si128(reinterpret_cast<const __m128i*>(pTables)));
+                const __m512i High = _mm512_maskz_broadcast_i32x4(0xFFFF, _mm_loadu_si128(reinterpret_cast<const __m128i*>(pTables + 16)));
+                for (; Pos < Len; Pos += 64)
+                {
+                    const std::uint64_t M     = TailMask64(Len - Pos);
+                    const std::uint64_t Match = SetMatch(Low, High, _mm512_maskz_loadu_epi8(M, pData + Pos));
+                    if (const std::uint64_t Mask = (bNegate ? ~Match : Match) & M; Mask) return Mask;
+                }
+                Pos = Len;
+                return 0;
+            }
+
+            XSTRTOOL_TARGET_AVX512BW
+            std::size_t SetRFindKernel(const std::uint8_t* pTables, const char* pData, std::size_t End) noexcept
+            {
+                const __m512i Low  = _mm512_maskz_broadcast_i32x4(0xFFFF, _mm_loadu_si128(reinterpret_cast<const __m128i*>(pTables)));
+                const __m512i High = _mm512_maskz_broadcast_i32x4(0xFFFF, _mm_loadu_si128(reinterpret_cast<const __m128i*>(pTables + 16)));
+                while (End > 0)
+                {
+                    const std::size_t   Base = (End > 64) ? End - 64 : 0;
+                    const std::uint64_t M    = TailMask64(End - Base);
+                    const std::uint64_t Mask = SetMatch(Low, High, _mm512_maskz_loadu_epi8(M, pData + Base)) & M;
+                    if (Mask) return Base + (63 - std::countl_zero(Mask));
+                    End = Base;
+                }
+                return std::string::npos;
+            }
+
+            XSTRTOOL_TARGET_AVX512BW
+            std::size_t LowerAsciiKernel(char* pDest, const char* pSrc, const std::size_t Len) noexcept
+            {
+                for (std::size_t i = 0; i < Len; i += 64)
+                {
+                    __mmask64       M        = TailMask64(Len - i);
+                    const __m512i   V        = _mm512_maskz_loadu_epi8(M, pSrc + i);
+                    const __mmask64 NonAscii = _mm512_movepi8_mask(V) & M;
+                    if (NonAscii) M &= ~NonAscii & (NonAscii - 1);
+                    _mm512_mask_storeu_epi8(pDest + i, M, LowerBlock(V));
+                    if (NonAscii) return i + std::countr_zero(static_cast<std::uint64_t>(NonAscii));
+                }
+                return Len;
+            }
+
+            XSTRTOOL_TARGET_AVX512BW
+            std::size_t MismatchAsciiIKernel(const char* pA, const char* pB, const std::size_t Len) noexcept
+            {
+                for (std::size_t i = 0; i < Len; i += 64)
+                {
+                    const __mmask64 M    = TailMask64(Len - i);
+                    const __m512i   Va   = _mm512_maskz_loadu_epi8(M, pA + i);
+                    const __m512i   Vb   = _mm512_maskz_loadu_epi8(M, pB + i);
+                    const __mmask64 Stop = _mm512_mask_cmpneq_epi8_mask(M, LowerBlock(Va), LowerBlock(Vb)) | (_mm512_movepi8_mask(_mm512_or_si512(Va, Vb)) & M);
+                    if (Stop) return i + std::countr_zero(static_cast<std::uint64_t>(Stop));
+                }
+                return Len;
+            }
+
+            XSTRTOOL_TARGET_AVX512BW
+            std::size_t MismatchIKernel(const char* pA, const char* pB, const std::size_t Len) noexcept
+            {
+                for (std::size_t i = 0; i < Len; i += 64)
+                {
+                    const __mmask64 M  = TailMask64(Len - i);
+                    const __mmask64 Ne = _mm512_mask_cmpneq_epi8_mask(M, LowerBlock(_mm512_maskz_loadu_epi8(M, pA + i)), LowerBlock(_mm512_maskz_loadu_epi8(M, pB + i)));
+                    if (Ne) return i + std::countr_zero(static_cast<std::uint64_t>(Ne));
+                }
+                return Len;
+            }
+
+            XSTRTOOL_TARGET_AVX512BW
+            std::size_t DigitSpanKernel(const char* pData, const std::size_t Len) noexcept
+            {
+                for (std::size_t i = 0; i < Len; i += 64)
+                {
+                    const __mmask64 M        = TailMask64(Len - i);
+                    const __m512i   V        = _mm512_maskz_loadu_epi8(M, pData + i);
+                    const __mmask64 NonDigit = M & ~_mm512_cmplt_epu8_mask(_mm512_sub_epi8(V, _mm512_set1_epi8('0')), _mm512_set1_epi8(10));
+                    if (NonDigit) return i + std::countr_zero(static_cast<std::uint64_t>(NonDigit));
+                }
+                return Len;
+            }
+
+            //--------------------------------------------------------------------------------
+            // Wide kernels (see sse2), lane masks are kept in a std::uint32_t for both lane sizes
+            //--------------------------------------------------------------------------------
+            constexpr std::size_t WideLanes_v = 64 / sizeof(wchar_t);
+
+            // Mask with one bit for each of the (up to WideLanes_v) remaining characters
+            constexpr std::uint32_t WideTailMask(const std::size_t N) noexcept
+            {
+                return static_cast<std::uint32_t>(TailMask64(std::min(N, WideLanes_v)));
+            }
+
+            XSTRTOOL_TARGET_AVX512BW
+            inline __m512i LoadW(const std::uint32_t M, const wchar_t* pData) noexcept
+            {
+                if constexpr (sizeof(wchar_t) == 4) return _mm512_maskz_loadu_epi32(static_cast<__mmask16>(M), pData);
+                else                                return _mm512_maskz_loadu_epi16(static_cast<__mmask32>(M), pData);
+            }
+
+            XSTRTOOL_TARGET_AVX512BW
+            inline __m512i Set1W(const wchar_t C) noexcept
+            {
+                if constexpr (sizeof(wchar_t) == 4) return _mm512_set1_epi32(static_cast<int>(C));
+                else                                return _mm512_set1_epi16(static_cast<short>(C));
+            }
+
+            XSTRTOOL_TARGET_AVX512BW
+            inline std::uint32_t CmpEqW(const std::uint32_t M, const __m512i A, const __m512i B) noexcept
+            {
+                if constexpr (sizeof(wchar_t) == 4) return _mm512_mask_cmpeq_epi32_mask(static_cast<__mmask16>(M), A, B);
+                else                                return _mm512_mask_cmpeq_epi16_mask(static_cast<__mmask32>(M), A, B);
+            }
+
+            XSTRTOOL_TARGET_AVX512BW
+            inline std::uint32_t CmpNeW(const std::uint32_t M, const __m512i A, const __m512i B) noexcept
+            {
+                if constexpr (sizeof(wchar_t) == 4) return _mm512_mask_cmpneq_epi32_mask(static_cast<__mmask16>(M), A, B);
+                else                                return _mm512_mask_cmpneq_epi16_mask(static_cast<__mmask32>(M), A, B);
+            }
+
+            XSTRTOOL_TARGET_AVX512BW
+            inline __m512i LowerBlockW(const __m512i V) noexcept
+            {
+                if constexpr (sizeof(wchar_t) == 4)
+                {
+                    const __mmask16 IsUpper = _mm512_cmplt_epu32_mask(_mm512_sub_epi32(V, Set1W(L'A')), Set1W(26));
+                    return _mm512_mask_add_epi32(V, IsUpper, V, Set1W(32));
+                }
+                else
+                {
+                    const __mmask32 IsUpper = _mm512_cmplt_epu16_mask(_mm512_sub_epi16(V, Set1W(L'A')), Set1W(26));
+                    return _mm512_mask_add_epi16(V, IsUpper, V, Set1W(32));
+                }
+            }
+
+            XSTRTOOL_TARGET_AVX512BW
+            inline __m512i UpperBlockW(const __m512i V) noexcept
+            {
+                if constexpr (sizeof(wchar_t) == 4)
+                {
+                    const __mmask16 IsLower = _mm512_cmplt_epu32_mask(_mm512_sub_epi32(V, Set1W(L'a')), Set1W(26));
+                    return _mm512_mask_sub_epi32(V, IsLower, V, Set1W(32));
+                }
+                else
+                {
+                    const __mmask32 IsLower = _mm512_cmplt_epu16_mask(_mm512_sub_epi16(V, Set1W(L'a')), Set1W(26));
+                    return _mm512_mask_sub_epi16(V, IsLower, V, Set1W(32));
+                }
+            }
+
+            XSTRTOOL_TARGET_AVX512BW
+            inline void StoreW(wchar_t* pData, const std::uint32_t M, const __m512i V) noexcept
+            {
+                if constexpr (sizeof(wchar_t) == 4) _mm512_mask_storeu_epi32(pData, static_cast<__mmask16>(M), V);
+                else                                _mm512_mask_storeu_epi16(pData, static_cast<__mmask32>(M), V);
+            }
+
+            XSTRTOOL_TARGET_AVX512BW
+            inline std::uint32_t SpaceMaskW(const std::uint32_t M, const __m512i V) noexcept
+            {
+                return CmpEqW(M, V, Set1W(L' '))
+                     | CmpEqW(M, V, Set1W(L'\t'))
+                     | CmpEqW(M, V, Set1W(L'\n'))
+                     | CmpEqW(M, V, Set1W(L'\r'));
+            }
+
+            // Converts up to the first non ASCII character exactly, the masks take care of the tails
+            template< bool T_TO_UPPER_V >
+            XSTRTOOL_TARGET_AVX512BW
+            std::size_t CaseAsciiKernel(wchar_t* pDest, const wchar_t* pSrc, const std::size_t Len) noexcept
+            {
+                const __m512i NonAscii = Set1W(static_cast<wchar_t>(~0x7F));
+                for (std::size_t i = 0; i < Len; i += WideLanes_v)
+                {
+                    std::uint32_t       M     = WideTailMask(Len - i);
+                    const __m512i       V     = LoadW(M, pSrc + i);
+                    const std::uint32_t Stop  = CmpNeW(M, _mm512_and_si512(V, NonAscii), _mm512_setzero_si512());
+                    if (Stop) M &= (Stop & (0u - Stop)) - 1;
+                    StoreW(pDest + i, M, T_TO_UPPER_V ? UpperBlockW(V) : LowerBlockW(V));
+                    if (Stop) return i + std::countr_zero(Stop);
+                }
+                return Len;
+            }
+
+            XSTRTOOL_TARGET_AVX512BW
+            int CompareIKernel(const wchar_t* pA, const wchar_t* pB, const std::size_t Len) noexcept
+            {
+                for (std::size_t i = 0; i < Len; i += WideLanes_v)
+                {
+                    const std::uint32_t M  = WideTailMask(Len - i);
+                    const std::uint32_t Ne = CmpNeW(M, LowerBlockW(LoadW(M, pA + i)), LowerBlockW(LoadW(M, pB + i)));
+                    if (Ne)
+                    {
+                        const std::size_t j  = i + std::countr_zero(Ne);
+                        const wchar_t     Ca = ToLower(pA[j]), Cb = ToLower(pB[j]);
+                        return (Ca < Cb) ? -1 : 1;
+                    }
+                }
+                return 0;
+            }
+
+            XSTRTOOL_TARGET_AVX512BW
+            inline bool EqualsLowered(const wchar_t* pHay, const wchar_t* pLowerNeedle, const std::size_t Len) noexcept
+            {
+                for (std::size_t i = 0; i < Len; i += WideLanes_v)
+                {
+                    const std::uint32_t M = WideTailMask(Len - i);
+                    if (CmpNeW(M, LowerBlockW(LoadW(M, pHay + i)), LoadW(M, pLowerNeedle + i))) return false;
+                }
+                return true;
+            }
+
+            XSTRTOOL_TARGET_AVX512BW
+            std::size_t FindIKernel(const std::wstring_view Haystack, const std::wstring_view LowerNeedle, const std::size_t Pos) noexcept
+            {
+                const wchar_t*    pHay   = Haystack.data();
+                const std::size_t End    = Haystack.size() - LowerNeedle.size() + 1;     // One past the last candidate
+                const __m512i     VFirst = Set1W(LowerNeedle[0]);
+                for (std::size_t i = Pos; i < End; i += WideLanes_v)
+                {
+                    const std::uint32_t M = WideTailMask(End - i);
+                    for (std::uint32_t Mask = CmpEqW(M, LowerBlockW(LoadW(M, pHay + i)), VFirst); Mask; Mask &= Mask - 1)
+                    {
+                        const std::size_t Candidate = i + std::countr_zero(Mask);
+                        if (EqualsLowered(pHay + Candidate + 1, LowerNeedle.data() + 1, LowerNeedle.size() - 1)) return Candidate;
+                    }
+                }
+                return std::wstring::npos;
+            }
+
+            XSTRTOOL_TARGET_AVX512BW
+            std::size_t RFindIKernel(const std::wstring_view Haystack, const std::wstring_view LowerNeedle, const std::size_t StartPos) noexcept
+            {
+                const wchar_t*    pHay   = Haystack.data();
+                const std::size_t Last   = LowerNeedle.size() - 1;
+                const __m512i     VFirst = Set1W(LowerNeedle[0]);
+                const __m512i     VLast  = Set1W(LowerNeedle[Last]);
+                for (std::size_t End = StartPos + 1; End > 0; )
+                {
+                    const std::size_t   Base = End > WideLanes_v ? End - WideLanes_v : 0;
+                    const std::uint32_t M    = WideTailMask(End - Base);
+                    for (std::uint32_t Mask = CmpEqW(M, LowerBlockW(LoadW(M, pHay + Base)), VFirst) & CmpEqW(M, LowerBlockW(LoadW(M, pHay + Base + Last)), VLast); Mask; )
+                    {
+                        const int Lane = std::bit_width(Mask) - 1;
+                        if (EqualsLowered(pHay + Base + Lane + 1, LowerNeedle.data() + 1, Last)) return Base + Lane;
+                        Mask ^= 1u << Lane;
+                    }
+                    End = Base;
+                }
+                return std::wstring::npos;
+            }
+
+            XSTRTOOL_TARGET_AVX512BW
+            std::size_t TrimLeftKernel(const wchar_t* pData, const std::size_t Len) noexcept
+            {
+                for (std::size_t i = 0; i < Len; i += WideLanes_v)
+                {
+                    const std::uint32_t M     = WideTailMask(Len - i);
+                    const std::uint32_t NonWs = ~SpaceMaskW(M, LoadW(M, pData + i)) & M;
+                    if (NonWs) return i + std::countr_zero(NonWs);
+                }
+                return Len;
+            }
+
+            XSTRTOOL_TARGET_AVX512BW
+            std::size_t TrimRightKernel(const wchar_t* pData, const std::size_t Len) noexcept
+            {
+                for (std::size_t i = Len; i > 0; )
+                {
+                    const std::size_t   Base  = i > WideLanes_v ? i - WideLanes_v : 0;
+                    const std::uint32_t M     = WideTailMask(i - Base);
+                    const std::uint32_t NonWs = ~SpaceMaskW(M, LoadW(M, pData + Base)) & M;
+                    if (NonWs) return Base + (32 - std::countl_zero(NonWs));
+                    i = Base;
+                }
+                return 0;
+            }
+
+            XSTRTOOL_TARGET_AVX512BW
+            void SplitKernel(const std::wstring_view InputView, const wchar_t Delim, std::vector<std::wstring_view>& Result) noexcept
+            {
+                const wchar_t*    pData = InputView.data();
+                const std::size_t Len   = InputView.size();
+                const __m512i     D     = Set1W(Delim);
+                std::size_t       Start = 0;
+                for (std::size_t i = 0; i < Len; i += WideLanes_v)
+                {
+                    const std::uint32_t M = WideTailMask(Len - i);
+                    EmitSplitParts(InputView, i, CmpEqW(M, LoadW(M, pData + i), D), Start, Result);
+                }
+                Result.push_back(InputView.substr(Start));
+            }
+
+            XSTRTOOL_TARGET_AVX512BW
+            std::uint64_t DelimMaskKernel(const wchar_t* pData, const std::size_t Len, const wchar_t Delim, std::size_t& Pos) noexcept
+            {
+                const __m512i D = Set1W(Delim);
+                for (; Pos < Len; Pos += 64)
+                {
+                    std::uint64_t Mask = 0;
+                    for (std::size_t i = 0; i < 64 && Pos + i < Len; i += WideLanes_v)
+                    {
+                        const std::uint32_t M = WideTailMask(Len - Pos - i);
+                        Mask |= static_cast<std::uint64_t>(CmpEqW(M, LoadW(M, pData + Pos + i), D)) << i;
+                    }
+                    if (Mask) return Mask;
+                }
+                Pos = Len;
+                return 0;
+            }
+
+            // See sse42::SetMatchW, the lanes of M only
+            XSTRTOOL_TARGET_AVX512BW
+            inline std::uint32_t SetMatchW(const std::uint32_t M, const __m512i Low, const __m512i High, const __m512i V) noexcept
+            {
+                const __m512i Byte = Set1W(static_cast<wchar_t>(0xFF));
+                const __m512i Rest = Set1W(static_cast<wchar_t>(~0xFF));
+                return CmpEqW(M, _mm512_and_si512(_mm512_movm_epi8(SetMatch(Low, High, V)), Byte), Byte) & CmpEqW(M, _mm512_and_si512(Rest, V), _mm512_setzero_si512());
+            }
+
+            XSTRTOOL_TARGET_AVX512BW
+            std::uint64_t SetMaskKernel(const std::uint8_t* pTables, const wchar_t* pData, const std::size_t Len, const bool bNegate, std::size_t& Pos) noexcept
+            {
+                const __m512i Low  = _mm512_maskz_broadcast_i32x4(0xFFFF, _mm_loadu_si128(reinterpret_cast<const __m128i*>(pTables)));
+                const __m512i High = _mm512_maskz_broadcast_i32x4(0xFFFF, _mm_loadu_si128(reinterpret_cast<const __m128i*>(pTables + 16)));
+                for (; Pos < Len; Pos += 64)
+                {
+                    std::uint64_t Mask = 0;
+                    for (std::size_t i = 0; i < 64 && Pos + i < Len; i += WideLanes_v)
+                    {
+                        const std::uint32_t M     = WideTailMask(Len - Pos - i);
+                        const std::uint32_t Match = SetMatchW(M, Low, High, LoadW(M, pData + Pos + i));
+                        Mask |= static_cast<std::uint64_t>((bNegate ? ~Match : Match) & M) << i;
+                    }
+                    if (Mask) return Mask;
+                }
+                Pos = Len;
+                return 0;
+            }
+
+            XSTRTOOL_TARGET_AVX512BW
+            std::size_t SetRFindKernel(const std::uint8_t* pTables, const wchar_t* pData, std::size_t End) noexcept
+            {
+                const __m512i Low  = _mm512_maskz_broadcast_i32x4(0xFFFF, _mm_loadu_si128(reinterpret_cast<const __m128i*>(pTables)));
+                const __m512i High = _mm512_maskz_broadcast_i32x4(0xFFFF, _mm_loadu_si128(reinterpret_cast<const __m128i*>(pTables + 16)));
+                while (End > 0)
+                {
+                    const std::size_t   Base = (End > WideLanes_v) ? End - WideLanes_v : 0;
+                    const std::uint32_t M    = WideTailMask(End - Base);
+                    const std::uint32_t Mask = SetMatchW(M, Low, High, LoadW(M, pData + Base));
+                    if (Mask) return Base + (31 - std::countl_zero(Mask));
+                    End = Base;
+                }
+                return std::string::npos;
+            }
+
+            XSTRTOOL_TARGET_AVX512BW
+            inline std::uint32_t DigitMaskW(const std::uint32_t M, const __m512i V) noexcept
+            {
+                if constexpr (sizeof(wchar_t) == 4) return _mm512_mask_cmplt_epu32_mask(static_cast<__mmask16>(M), _mm512_sub_epi32(V, Set1W(L'0')), Set1W(10));
+                else                                return _mm512_mask_cmplt_epu16_mask(static_cast<__mmask32>(M), _mm512_sub_epi16(V, Set1W(L'0')), Set1W(10));
+            }
+
+            XSTRTOOL_TARGET_AVX512BW
+            std::size_t MismatchIKernel(const wchar_t* pA, const wchar_t* pB, const std::size_t Len) noexcept
+            {
+                for (std::size_t i = 0; i < Len; i += WideLanes_v)
+                {
+                    const std::uint32_t M  = WideTailMask(Len - i);
+                    const std::uint32_t Ne = CmpNeW(M, LowerBlockW(LoadW(M, pA + i)), LowerBlockW(LoadW(M, pB + i)));
+                    if (Ne) return i + std::countr_zero(Ne);
+                }
+                return Len;
+            }
+
+            XSTRTOOL_TARGET_AVX512BW
+            std::size_t DigitSpanKernel(const wchar_t* pData, const std::size_t Len) noexcept
+            {
+                for (std::size_t i = 0; i < Len; i += WideLanes_v)
+                {
+                    const std::uint32_t M        = WideTailMask(Len - i);
+                    const std::uint32_t NonDigit = M & ~DigitMaskW(M, LoadW(M, pData + i));
+                    if (NonDigit) return i + std::countr_zero(NonDigit);
+                }
+                return Len;
+            }
+
+            //--------------------------------------------------------------------------------
+            // Case-insensitive hash, the AVX2 stripe loop with a masked load for short strings
+            //--------------------------------------------------------------------------------
+            // Only the low four 64 bit lanes are used
+            XSTRTOOL_TARGET_AVX512BW
+            inline __m512i HashIRound(const __m512i Acc, const __m512i Data, const __m512i Secret) noexcept
+            {
+                const __m512i K = _mm512_xor_si512(Data, Secret);
+                return _mm512_add_epi64(_mm512_add_epi64(_mm512_maskz_rol_epi64(0x0F, Acc, 23), _mm512_maskz_mul_epu32(0x0F, K, _mm512_maskz_srli_epi64(0x0F, K, 32))), Data);
+            }
+
+            template< typename T_CHAR >
+            XSTRTOOL_TARGET_AVX512BW
+            std::uint64_t HashIKernel(const T_CHAR* pData, const std::size_t Len) noexcept
+            {
+                if (Len * sizeof(T_CHAR) >= 32) return avx2::HashIKernel(pData, Len);
+
+                const __m512i Secret = _mm512_maskz_loadu_epi64(0x0F, HashISecret_v);
+                const __m512i Data   = _mm512_maskz_loadu_epi8(TailMask64(Len * sizeof(T_CHAR)), pData);
+                std::uint64_t Lanes[4];
+                _mm512_mask_storeu_epi64(Lanes, 0x0F, HashIRound(Secret, (sizeof(T_CHAR) == 1) ? LowerBlock(Data) : LowerBlockW(Data), Secret));
+                return HashIFinalize(Lanes, Len * sizeof(T_CHAR));
+            }
+        }
+
+        //--------------------------------------------------------------------------------
+        // Kernel tables
+        //--------------------------------------------------------------------------------
+        struct kernel_table
+        {
+            void          (*m_pToLower)        (char* pDest, const char* pSrc, const std::size_t Len) noexcept;     // pDest may be pSrc
+            void          (*m_pToUpper)        (char* pDest, const char* pSrc, const std::size_t Len) noexcept;     // pDest may be pSrc
+            int           (*m_pCompareI)       (const char* pA, const char* pB, const std::size_t Len) noexcept;
+            std::size_t   (*m_pFind)           (const std::string_view Haystack, const std::string_view Needle, const std::size_t Pos, const std::size_t Anchor1, const std::size_t Anchor2) noexcept;
+            std::size_t   (*m_pFindI)          (const std::string_view Haystack, const std::string_view LowerNeedle, const std::size_t Pos, const std::size_t Anchor1, const std::size_t Anchor2) noexcept;
+            std::size_t   (*m_pCount)          (const std::string_view Haystack, const std::string_view Needle, const std::size_t Pos, const std::size_t Anchor1, const std::size_t Anchor2) noexcept;
+            std::size_t   (*m_pCountI)         (const std::string_view Haystack, const std::string_view LowerNeedle, const std::size_t Pos, const std::size_t Anchor1, const std::size_t Anchor2) noexcept;
+            std::size_t   (*m_pTeddy)          (const std::uint8_t* pMasks, const std::size_t FingerprintLen, const char* pData, std::size_t Pos, const std::size_t End, std::uint8_t& Buckets) noexcept;
+            std::size_t   (*m_pRFind)          (const std::string_view Haystack, const std::string_view Needle, const std::size_t Pos, const std::size_t Anchor1, const std::size_t Anchor2) noexcept;
+            std::size_t   (*m_pRFindI)         (const std::string_view Haystack, const std::string_view LowerNeedle, const std::size_t Pos, const std::size_t Anchor1, const std::size_t Anchor2) noexcept;
+            std::size_t   (*m_pAffixMatch)     (const std::uint32_t* pNodes, const char* pLabels, const char* pStr, const std::size_t Len, const bool bSuffix) noexcept;
+            std::size_t   (*m_pTrimLeft)       (const char* pData, const std::size_t Len) noexcept;
+            std::size_t   (*m_pTrimRight)      (const char* pData, const std::size_t Len) noexcept;
+            void          (*m_pSplit)          (const std::string_view InputView, const char Delim, std::vector<std::string_view>& Result) noexcept;
+            std::uint64_t (*m_pDelimMask)      (const char* pData, const std::size_t Len, const char Delim, std::size_t& Pos) noexcept;
+            std::uint64_t (*m_pSetMask)        (const std::uint8_t* pTables, const char* pData, const std::size_t Len, const bool bNegate, std::size_t& Pos) noexcept;
+            std::size_t   (*m_pSetRFind)       (const std::uint8_t* pTables, const char* pData, const std::size_t End) noexcept;
+            std::uint64_t (*m_pCsvMask)        (const char* pData, const std::size_t Len, const char Delim, std::size_t& Pos, std::uint64_t& Inside) noexcept;
+            std::size_t   (*m_pLowerAscii)     (char* pDest, const char* pSrc, const std::size_t Len) noexcept;       // Only the leading ASCII run, returns its length
+            std::size_t   (*m_pMismatchAsciiI) (const char* pA, const char* pB, const std::size_t Len) noexcept;
+            std::size_t   (*m_pMismatchI)      (const char* pA, const char* pB, const std::size_t Len) noexcept;      // Len when there is no difference
+            std::size_t   (*m_pDigitSpan)      (const char* pData, const std::size_t Len) noexcept;
+            std::uint64_t (*m_pHashI)          (const char* pData, const std::size_t Len) noexcept;                 // Same value on every tier
+
+            int           (*m_pCompareIW)      (const wchar_t* pA, const wchar_t* pB, const std::size_t Len) noexcept;
+            std::size_t   (*m_pFindIW)         (const std::wstring_view Haystack, const std::wstring_view LowerNeedle, const std::size_t Pos) noexcept;
+            std::size_t   (*m_pRFindIW)        (const std::wstring_view Haystack, const std::wstring_view LowerNeedle, const std::size_t StartPos) noexcept;
+            std::size_t   (*m_pTrimLeftW)      (const wchar_t* pData, const std::size_t Len) noexcept;
+            std::size_t   (*m_pTrimRightW)     (const wchar_t* pData, const std::size_t Len) noexcept;
+            void          (*m_pSplitW)         (const std::wstring_view InputView, const wchar_t Delim, std::vector<std::wstring_view>& Result) noexcept;
+            std::uint64_t (*m_pDelimMaskW)     (const wchar_t* pData, const std::size_t Len, const wchar_t Delim, std::size_t& Pos) noexcept;
+            std::uint64_t (*m_pSetMaskW)       (const std::uint8_t* pTables, const wchar_t* pData, const std::size_t Len, const bool bNegate, std::size_t& Pos) noexcept;
+            std::size_t   (*m_pSetRFindW)      (const std::uint8_t* pTables, const wchar_t* pData, const std::size_t End) noexcept;
+            std::size_t   (*m_pLowerAsciiW)    (wchar_t* pDest, const wchar_t* pSrc, const std::size_t Len) noexcept;   // Only the leading ASCII run, returns its length
+            std::size_t   (*m_pUpperAsciiW)    (wchar_t* pDest, const wchar_t* pSrc, const std::size_t Len) noexcept;   // Only the leading ASCII run, returns its length
+            std::size_t   (*m_pMismatchIW)     (const wchar_t* pA, const wchar_t* pB, const std::size_t Len) noexcept;  // Len when there is no difference
+            std::size_t   (*m_pDigitSpanW)     (const wchar_t* pData, const std::size_t Len) noexcept;
+            std::uint64_t (*m_pHashIW)         (const wchar_t* pData, const std::size_t Len) noexcept;              // Same value on every tier
+        };
+
+        // Indexed by simd_tier
+        constexpr std::array<kernel_table, static_cast<std::size_t>(simd_tier::COUNT)> KernelTables_v =
+        {{
+            // SCALAR
+            {   .m_pToLower        = scalar::ToLowerKernel<char>
+            ,   .m_pToUpper        = scalar::ToUpperKernel<char>
+            ,   .m_pCompareI       = scalar::CompareIKernel<char>
+            ,   .m_pFind           = scalar::FindKernel<false>
+            ,   .m_pFindI          = scalar::FindKernel<true>
+            ,   .m_pCount          = scalar::CountKernel<false>
+            ,   .m_pCountI         = scalar::CountKernel<true>
+            ,   .m_pTeddy          = scalar::TeddyKernel
+            ,   .m_pRFind          = scalar::RFindKernel<false>
+            ,   .m_pRFindI         = scalar::RFindKernel<true>
+            ,   .m_pAffixMatch     = scalar::AffixMatchKernel
+            ,   .m_pTrimLeft       = scalar::TrimLeftKernel<char>
+            ,   .m_pTrimRight      = scalar::TrimRightKernel<char>
+            ,   .m_pSplit          = scalar::SplitKernel<char>
+            ,   .m_pDelimMask      = scalar::DelimMaskKernel<char>
+            ,   .m_pSetMask        = scalar::SetMaskKernel<char>
+            ,   .m_pSetRFind       = scalar::SetRFindKernel<char>
+            ,   .m_pCsvMask        = scalar::CsvMaskKernel
+            ,   .m_pLowerAscii     = scalar::LowerAsciiKernel
+            ,   .m_pMismatchAsciiI = scalar::MismatchAsciiIKernel
+            ,   .m_pMismatchI      = scalar::MismatchIKernel<char>
+            ,   .m_pDigitSpan      = scalar::DigitSpanKernel<char>
+            ,   .m_pHashI          = scalar::HashIKernel<char>
+            ,   .m_pCompareIW      = scalar::CompareIKernel<wchar_t>
+            ,   .m_pFindIW         = scalar::FindIKernel<wchar_t>
+            ,   .m_pRFindIW        = scalar::RFindIKernel<wchar_t>
+            ,   .m_pTrimLeftW      = scalar::TrimLeftKernel<wchar_t>
+            ,   .m_pTrimRightW     = scalar::TrimRightKernel<wchar_t>
+            ,   .m_pSplitW         = scalar::SplitKernel<wchar_t>
+            ,   .m_pDelimMaskW     = scalar::DelimMaskKernel<wchar_t>
+            ,   .m_pSetMaskW       = scalar::SetMaskKernel<wchar_t>
+            ,   .m_pSetRFindW      = scalar::SetRFindKernel<wchar_t>
+            ,   .m_pLowerAsciiW    = scalar::CaseAsciiKernel<false>
+            ,   .m_pUpperAsciiW    = scalar::CaseAsciiKernel<true>
+            ,   .m_pMismatchIW     = scalar::MismatchIKernel<wchar_t>
+            ,   .m_pDigitSpanW     = scalar::DigitSpanKernel<wchar_t>
+            ,   .m_pHashIW         = scalar::HashIKernel<wchar_t>
+            }
+            // SSE2
+        ,   {   .m_pToLower        = sse2::ToLowerKernel
+            ,   .m_pToUpper        = sse2::ToUpperKernel
+            ,   .m_pCompareI       = sse2::CompareIKernel
+            ,   .m_pFind           = sse2::FindKernel<false>
+            ,   .m_pFindI          = sse2::FindKernel<true>
+            ,   .m_pCount          = sse2::CountKernel<false>
+            ,   .m_pCountI         = sse2::CountKernel<true>
+            ,   .m_pTeddy          = scalar::TeddyKernel
+            ,   .m_pRFind          = sse2::RFindKernel<false>
+            ,   .m_pRFindI         = sse2::RFindKernel<true>
+            ,   .m_pAffixMatch     = sse2::AffixMatchKernel
+            ,   .m_pTrimLeft       = sse2::TrimLeftKernel
+            ,   .m_pTrimRight      = sse2::TrimRightKernel
+            ,   .m_pSplit          = sse2::SplitKernel
+            ,   .m_pDelimMask      = sse2::DelimMaskKernel
+            ,   .m_pSetMask        = scalar::SetMaskKernel<char>
+            ,   .m_pSetRFind       = scalar::SetRFindKernel<char>
+            ,   .m_pCsvMask        = sse2::CsvMaskKernel
+            ,   .m_pLowerAscii     = sse2::LowerAsciiKernel
+            ,   .m_pMismatchAsciiI = sse2::MismatchAsciiIKernel
+            ,   .m_pMismatchI      = sse2::MismatchIKernel
+            ,   .m_pDigitSpan      = sse2::DigitSpanKernel
+            ,   .m_pHashI          = sse2::HashIKernel<char>
+            ,   .m_pCompareIW      = sse2::CompareIKernel
+            ,   .m_pFindIW         = sse2::FindIKernel
+            ,   .m_pRFindIW        = sse2::RFindIKernel
+            ,   .m_pTrimLeftW      = sse2::TrimLeftKernel
+            ,   .m_pTrimRightW     = sse2::TrimRightKernel
+            ,   .m_pSplitW         = sse2::SplitKernel
+            ,   .m_pDelimMaskW     = sse2::DelimMaskKernel
+            ,   .m_pSetMaskW       = scalar::SetMaskKernel<wchar_t>
+            ,   .m_pSetRFindW      = scalar::SetRFindKernel<wchar_t>
+            ,   .m_pLowerAsciiW    = sse2::CaseAsciiKernel<false>
+            ,   .m_pUpperAsciiW    = sse2::CaseAsciiKernel<true>
+            ,   .m_pMismatchIW     = sse2::MismatchIKernel
+            ,   .m_pDigitSpanW     = sse2::DigitSpanKernel
+            ,   .m_pHashIW         = sse2::HashIKernel<wchar_t>
+            }
+            // SSE42
+        ,   {   .m_pToLower        = sse2::ToLowerKernel
+            ,   .m_pToUpper        = sse2::ToUpperKernel
+            ,   .m_pCompareI       = sse2::CompareIKernel
+            ,   .m_pFind           = sse2::FindKernel<false>
+            ,   .m_pFindI          = sse2::FindKernel<true>
+            ,   .m_pCount          = sse2::CountKernel<false>
+            ,   .m_pCountI         = sse2::CountKernel<true>
+            ,   .m_pTeddy          = sse42::TeddyKernel
+            ,   .m_pRFind          = sse2::RFindKernel<false>
+            ,   .m_pRFindI         = sse2::RFindKernel<true>
+            ,   .m_pAffixMatch     = sse2::AffixMatchKernel
+            ,   .m_pTrimLeft       = sse42::TrimLeftKernel
+            ,   .m_pTrimRight      = sse42::TrimRightKernel
+            ,   .m_pSplit          = sse2::SplitKernel
+            ,   .m_pDelimMask      = sse2::DelimMaskKernel
+            ,   .m_pSetMask        = sse42::SetMaskKernel
+            ,   .m_pSetRFind       = sse42::SetRFindKernel
+            ,   .m_pCsvMask        = sse2::CsvMaskKernel
+            ,   .m_pLowerAscii     = sse2::LowerAsciiKernel
+            ,   .m_pMismatchAsciiI = sse2::MismatchAsciiIKernel
+            ,   .m_pMismatchI      = sse2::MismatchIKernel
+            ,   .m_pDigitSpan      = sse2::DigitSpanKernel
+            ,   .m_pHashI          = sse2::HashIKernel<char>
+            ,   .m_pCompareIW      = sse2::CompareIKernel
+            ,   .m_pFindIW         = sse2::FindIKernel
+            ,   .m_pRFindIW        = sse2::RFindIKernel
+            ,   .m_pTrimLeftW      = sse2::TrimLeftKernel
+            ,   .m_pTrimRightW     = sse2::TrimRightKernel
+            ,   .m_pSplitW         = sse2::SplitKernel
+            ,   .m_pDelimMaskW     = sse2::DelimMaskKernel
+            ,   .m_pSetMaskW       = sse42::SetMaskKernel
+            ,   .m_pSetRFindW      = sse42::SetRFindKernel
+            ,   .m_pLowerAsciiW    = sse2::CaseAsciiKernel<false>
+            ,   .m_pUpperAsciiW    = sse2::CaseAsciiKernel<true>
+            ,   .m_pMismatchIW     = sse2::MismatchIKernel
+            ,   .m_pDigitSpanW     = sse2::DigitSpanKernel
+            ,   .m_pHashIW         = sse2::HashIKernel<wchar_t>
+            }
+            // AVX2
+        ,   {   .m_pToLower        = avx2::ToLowerKernel
+            ,   .m_pToUpper        = avx2::ToUpperKernel
+            ,   .m_pCompareI       = avx2::CompareIKernel
+            ,   .m_pFind           = avx2::FindKernel<false>
+            ,   .m_pFindI          = avx2::FindKernel<true>
+            ,   .m_pCount          = avx2::CountKernel<false>
+            ,   .m_pCountI         = avx2::CountKernel<true>
+            ,   .m_pTeddy          = avx2::TeddyKernel
+            ,   .m_pRFind          = avx2::RFindKernel<false>
+            ,   .m_pRFindI         = avx2::RFindKernel<true>
+            ,   .m_pAffixMatch     = sse2::AffixMatchKernel
+            ,   .m_pTrimLeft       = avx2::TrimLeftKernel
+            ,   .m_pTrimRight      = avx2::TrimRightKernel
+            ,   .m_pSplit          = avx2::SplitKernel
+            ,   .m_pDelimMask      = avx2::DelimMaskKernel
+            ,   .m_pSetMask        = avx2::SetMaskKernel
+            ,   .m_pSetRFind       = avx2::SetRFindKernel
+            ,   .m_pCsvMask        = avx2::CsvMaskKernel
+            ,   .m_pLowerAscii     = avx2::LowerAsciiKernel
+            ,   .m_pMismatchAsciiI = avx2::MismatchAsciiIKernel
+            ,   .m_pMismatchI      = avx2::MismatchIKernel
+            ,   .m_pDigitSpan      = avx2::DigitSpanKernel
+            ,   .m_pHashI          = avx2::HashIKernel<char>
+            ,   .m_pCompareIW      = avx2::CompareIKernel
+            ,   .m_pFindIW         = avx2::FindIKernel
+            ,   .m_pRFindIW        = avx2::RFindIKernel
+            ,   .m_pTrimLeftW      = avx2::TrimLeftKernel
+            ,   .m_pTrimRightW     = avx2::TrimRightKernel
+            ,   .m_pSplitW         = avx2::SplitKernel
+            ,   .m_pDelimMaskW     = avx2::DelimMaskKernel
+            ,   .m_pSetMaskW       = avx2::SetMaskKernel
+            ,   .m_pSetRFindW      = avx2::SetRFindKernel
+            ,   .m_pLowerAsciiW    = avx2::CaseAsciiKernel<false>
+            ,   .m_pUpperAsciiW    = avx2::CaseAsciiKernel<true>
+            ,   .m_pMismatchIW     = avx2::MismatchIKernel
+            ,   .m_pDigitSpanW     = avx2::DigitSpanKernel
+            ,   .m_pHashIW         = avx2::HashIKernel<wchar_t>
+            }
+            // AVX512BW
+        ,   {   .m_pToLower        = avx512::ToLowerKernel
+            ,   .m_pToUpper        = avx512::ToUpperKernel
+            ,   .m_pCompareI       = avx512::CompareIKernel
+            ,   .m_pFind           = avx512::FindKernel<false>
+            ,   .m_pFindI          = avx512::FindKernel<true>
+            ,   .m_pCount          = avx512::CountKernel<false>
+            ,   .m_pCountI         = avx512::CountKernel<true>
+            ,   .m_pTeddy          = avx512::TeddyKernel
+            ,   .m_pRFind          = avx512::RFindKernel<false>
+            ,   .m_pRFindI         = avx512::RFindKernel<true>
+            ,   .m_pAffixMatch     = sse2::AffixMatchKernel
+            ,   .m_pTrimLeft       = avx512::TrimLeftKernel
+            ,   .m_pTrimRight      = avx512::TrimRightKernel
+            ,   .m_pSplit          = avx512::SplitKernel
+            ,   .m_pDelimMask      = avx512::DelimMaskKernel
+            ,   .m_pSetMask        = avx512::SetMaskKernel
+            ,   .m_pSetRFind       = avx512::SetRFindKernel
+            ,   .m_pCsvMask        = avx512::CsvMaskKernel
+            ,   .m_pLowerAscii     = avx512::LowerAsciiKernel
+            ,   .m_pMismatchAsciiI = avx512::MismatchAsciiIKernel
+            ,   .m_pMismatchI      = avx512::MismatchIKernel
+            ,   .m_pDigitSpan      = avx512::DigitSpanKernel
+            ,   .m_pHashI          = avx512::HashIKernel<char>
+            ,   .m_pCompareIW      = avx512::CompareIKernel
+            ,   .m_pFindIW         = avx512::FindIKernel
+            ,   .m_pRFindIW        = avx512::RFindIKernel
+            ,   .m_pTrimLeftW      = avx512::TrimLeftKernel
+            ,   .m_pTrimRightW     = avx512::TrimRightKernel
+            ,   .m_pSplitW         = avx512::SplitKernel
+            ,   .m_pDelimMaskW     = avx512::DelimMaskKernel
+            ,   .m_pSetMaskW       = avx512::SetMaskKernel
+            ,   .m_pSetRFindW      = avx512::SetRFindKernel
+            ,   .m_pLowerAsciiW    = avx512::CaseAsciiKernel<false>
+            ,   .m_pUpperAsciiW    = avx512::CaseAsciiKernel<true>
+            ,   .m_pMismatchIW     = avx512::MismatchIKernel
+            ,   .m_pDigitSpanW     = avx512::DigitSpanKernel
+            ,   .m_pHashIW         = avx512::HashIKernel<wchar_t>
+            }
+        }};
+
+        //--------------------------------------------------------------------------------
+        // CPU detection
+        //--------------------------------------------------------------------------------
+        void CPUID(std::uint32_t (&Info)[4], const std::uint32_t Leaf, const std::uint32_t SubLeaf) noexcept
+        {
+        #ifdef _MSC_VER
+            int Regs[4];
+            __cpuidex(Regs, static_cast<int>(Leaf), static_cast<int>(SubLeaf));
+            for (int i = 0; i < 4; ++i) Info[i] = static_cast<std::uint32_t>(Regs[i]);
+        #else
+            __cpuid_count(Leaf, SubLeaf, Info[0], Info[1], Info[2], Info[3]);
+        #endif
+        }
+
+        std::uint64_t XGetBV() noexcept
+        {
+        #ifdef _MSC_VER
+            return _xgetbv(0);
+        #else
+            std::uint32_t Eax, Edx;
+            __asm__ volatile("xgetbv" : "=a"(Eax), "=d"(Edx) : "c"(0));
+            return (static_cast<std::uint64_t>(Edx) << 32) | Eax;
+        #endif
+        }
+
+        simd_tier DetectSimdTier() noexcept
+        {
+            std::uint32_t Info[4];
+            CPUID(Info, 0, 0);
+            const std::uint32_t MaxLeaf = Info[0];
+
+            CPUID(Info, 1, 0);
+            const bool bSSE2    = Info[3] & (1u << 26);
+            const bool bSSE42   = (Info[2] & (1u << 20)) && (Info[2] & (1u << 23));     // SSE4.2 + POPCNT
+            const bool bOSXSave = Info[2] & (1u << 27);
+            const bool bAVX     = Info[2] & (1u << 28);
+            const bool bPCLMUL  = Info[2] & (1u << 1);
+            if (!bSSE2)  return simd_tier::SCALAR;
+            if (!bSSE42) return simd_tier::SSE2;
+            if (!bOSXSave || !bAVX || MaxLeaf < 7) return simd_tier::SSE42;
+
+            // The OS must save the YMM (and for AVX-512 the opmask/ZMM) state
+            const std::uint64_t XCR0 = XGetBV();
+            if ((XCR0 & 0x6) != 0x6) return simd_tier::SSE42;
+
+            CPUID(Info, 7, 0);
+            const bool bAVX2     = (Info[1] & (1u << 5)) && (Info[1] & (1u << 3)) && (Info[1] & (1u << 8)) && bPCLMUL;  // AVX2 + BMI1 + BMI2 + PCLMULQDQ
+            const bool bAVX512BW = (Info[1] & (1u << 16)) && (Info[1] & (1u << 30));                       // AVX512F + AVX512BW
+            if (!bAVX2) return simd_tier::SSE42;
+            if (bAVX512BW && (XCR0 & 0xE0) == 0xE0) return simd_tier::AVX512BW;
+            return simd_tier::AVX2;
+        }
+
+        // Reads XSTRTOOL_SIMD_TIER, returns COUNT when it is not set or not recognized
+        simd_tier ReadSimdTierOverride() noexcept
+        {
+            std::string Value;
+        #ifdef _MSC_VER
+            char*       pValue = nullptr;
+            std::size_t Size   = 0;
+            if (_dupenv_s(&pValue, &Size, "XSTRTOOL_SIMD_TIER") != 0 || pValue == nullptr) return simd_tier::COUNT;
+            Value = pValue;
+            std::free(pValue);
+        #else
+            const char* pValue = std::getenv("XSTRTOOL_SIMD_TIER");
+            if (pValue == nullptr) return simd_tier::COUNT;
+            Value = pValue;
+        #endif
+
+            // Note that the dispatcher is not ready yet, so only the scalar kernels can be used here
+            scalar::ToLowerKernel(Value.data(), Value.data(), Value.size());
+            for (std::size_t i = 0; i < static_cast<std::size_t>(simd_tier::COUNT); ++i)
+            {
+                if (Value == GetSimdTierName(static_cast<simd_tier>(i))) return static_cast<simd_tier>(i);
+            }
+            return simd_tier::COUNT;
+        }
+
+        struct dispatch_state
+        {
+            simd_tier               m_Supported;
+            std::atomic<simd_tier>  m_Active;
+
+            dispatch_state() noexcept
+                : m_Supported{ DetectSimdTier() }
+                , m_Active{ std::min(ReadSimdTierOverride(), m_Supported) }
+            {}
+        };
+
+        dispatch_state& GetDispatchState() noexcept
+        {
+            static dispatch_state State;
+            return State;
+        }
+
+        inline const kernel_table& ActiveKernels() noexcept
+        {
+            return KernelTables_v[static_cast<std::size_t>(GetDispatchState().m_Active.load(std::memory_order_relaxed))];
+        }
+    }
+
+    //--------------------------------------------------------------------------------
+    simd_tier GetSupportedSimdTier() noexcept
+    {
+        return GetDispatchState().m_Supported;
+    }
+
+    //--------------------------------------------------------------------------------
+    simd_tier GetSimdTier() noexcept
+    {
+        return GetDispatchState().m_Active.load(std::memory_order_relaxed);
+    }
+
+    //--------------------------------------------------------------------------------
+    simd_tier SetSimdTier(const simd_tier Tier) noexcept
+    {
+        auto&           State    = GetDispatchState();
+        const simd_tier Selected = std::min(Tier, State.m_Supported);
+        State.m_Active.store(Selected, std::memory_order_relaxed);
+        return Selected;
+    }
+
+    //--------------------------------------------------------------------------------
+    std::string_view GetSimdTierName(const simd_tier Tier) noexcept
+    {
+        switch (Tier)
+        {
+        case simd_tier::SCALAR:     return "scalar";
+        case simd_tier::SSE2:       return "sse2";
+        case simd_tier::SSE42:      return "sse42";
+        case simd_tier::AVX2:       return "avx2";
+        case simd_tier::AVX512BW:   return "avx512bw";
+        default:                    return "unknown";
+        }
+    }
+
+    //--------------------------------------------------------------------------------
+    // Parallel helpers
+    //--------------------------------------------------------------------------------
+    namespace
+    {
+        // Runs Work(Begin, End) over [0, Count) in chunks of Grain items. The calling thread takes part and
+        // helper threads are only started when there is more than one chunk (if one can not be started the
+        // chunks are simply shared by fewer threads). Work can also take the index of its thread first,
+        // Work(Thread, Begin, End), with 0 for the calling thread and less than hardware_concurrency
+        template< typename T_WORK >
+        void ParallelFor(const std::size_t Count, const std::size_t Grain, T_WORK&& Work) noexcept
+        {
+            assert(Grain > 0);
+            const auto Run = [&](const std::size_t Thread, const std::size_t Begin, const std::size_t End) noexcept
+            {
+                if constexpr (std::is_invocable_v<T_WORK&, std::size_t, std::size_t, std::size_t>) Work(Thread, Begin, End);
+                else                                                                              Work(Begin, End);
+            };
+
+            const std::size_t nChunks  = (Count + Grain - 1) / Grain;
+            const std::size_t nThreads = std::min<std::size_t>(nChunks, std::max(1u, std::thread::hardware_concurrency()));
+            if (nThreads <= 1)
+            {
+                if (Count) Run(0, 0, Count);
+                return;
+            }
+
+            std::atomic<std::size_t> NextChunk{ 0 };
+            auto Worker = [&](const std::size_t Thread) noexcept
+            {
+                for (std::size_t c; (c = NextChunk.fetch_add(1, std::memory_order_relaxed)) < nChunks; )
+                    Run(Thread, c * Grain, std::min(Count, (c + 1) * Grain));
+            };
+
+            std::vector<std::thread> Helpers;
+            try
+            {
+                Helpers.reserve(nThreads - 1);
+                for (std::size_t i = 1; i < nThreads; ++i) Helpers.emplace_back(Worker, i);
+            }
+            catch (...) {}
+
+            Worker(0);
+            for (auto& Helper : Helpers) Helper.join();
+        }
+
+        // Bytes of work that a chunk of a batch should have, so the cost of waking a thread stays small
+        constexpr std::size_t BatchChunkWork_v = 256 * 1024;
+
+        // Extra bytes of work counted for every string of a batch (the call and cache miss overhead)
+        constexpr std::size_t BatchItemWork_v  = 64;
+
+        // Number of strings per chunk, WorkPerByte scales the bytes for slower operations
+        template< typename T_STRING >
+        std::size_t BatchGrain(const std::span<T_STRING> Strings, const std::size_t WorkPerByte) noexcept
+        {
+            std::size_t Work = Strings.size() * BatchItemWork_v;
+            if (WorkPerByte) for (const auto& S : Strings) Work += S.size() * WorkPerByte;
+            const std::size_t nChunks = std::max<std::size_t>(1, Work / BatchChunkWork_v);
+            return std::max<std::size_t>(1, (Strings.size() + nChunks - 1) / nChunks);
+        }
+    }
+
     //--------------------------------------------------------------------------------
     std::wstring To(const std::string_view InputView) noexcept
     {
-        std::wstring Result(InputView.size(), 0);
-        std::transform(InputView.begin(), InputView.end(), Result.begin(), [](const char ch) { return static_cast<wchar_t>(static_cast<unsigned char>(ch)); });
+        std::wstring Result(InputView.size(), 0);
+        std::transform(InputView.begin(), InputView.end(), Result.begin(), [](const char ch) { return static_cast<wchar_t>(static_cast<unsigned char>(ch)); });
+        return Result;
+    }
+
+    //--------------------------------------------------------------------------------
+    std::wstring To(const char* Input) noexcept
+    {
+        assert(Input != nullptr && "Input string is null");
+        return To(std::string_view(Input));
+    }
+
+    //--------------------------------------------------------------------------------
+    std::string To(const std::wstring_view InputView) noexcept
+    {
+        std::string Result(InputView.size(), 0);
+        std::transform(InputView.begin(), InputView.end(), Result.begin(), [](const wchar_t wch) { return static_cast<char>(wch); });
+        return Result;
+    }
+
+    //--------------------------------------------------------------------------------
+    std::string To(const wchar_t* Input) noexcept
+    {
+        assert(Input != nullptr && "Input wide string is null");
+        return To(std::wstring_view(Input));
+    }
+
+    //--------------------------------------------------------------------------------
+
+    std::string CopyN(const std::string_view Source, std::size_t N) noexcept
+    {
+        std::string Result;
+        Result.resize(std::min(N, Source.size()));
+        std::copy_n(Source.begin(), Result.size(), Result.begin());
+        return Result;
+    }
+
+    //--------------------------------------------------------------------------------
+
+    std::string CopyN(const char* Source, std::size_t N) noexcept
+    {
+        assert(Source != nullptr && "Source string is null");
+        return CopyN(std::string_view(Source), N);
+    }
+
+    //--------------------------------------------------------------------------------
+
+    std::wstring CopyN(const std::wstring_view Source, std::size_t N) noexcept
+    {
+        std::wstring Result;
+        Result.resize(std::min(N, Source.size()));
+        std::copy_n(Source.begin(), Result.size(), Result.begin());
+        return Result;
+    }
+
+    //--------------------------------------------------------------------------------
+
+    std::wstring CopyN(const wchar_t* Source, std::size_t N) noexcept
+    {
+        assert(Source != nullptr && "Source wide string is null");
+        return CopyN(std::wstring_view(Source), N);
+    }
+
+    //--------------------------------------------------------------------------------
+
+    std::size_t Copy(std::span<char> Dest, std::string_view Source) noexcept
+    {
+        if ( Dest.empty() ) return 0;
+
+        // Copy up to buffer size minus 1 to leave space for null terminator
+        std::size_t copy_len = std::min(Source.size(), Dest.size() - 1);
+        std::copy_n(Source.begin(), copy_len, Dest.begin());
+
+        // Null-terminate
+        Dest[copy_len] = '\0';
+        return copy_len;
+    }
+
+    //--------------------------------------------------------------------------------
+    std::string ToLowerCopy(const std::string_view InputView) noexcept
+    {
+        std::string Result;
+        ResizeAndOverwrite(Result, InputView.size(), [&](char* pData, const std::size_t Len) noexcept
+        {
+            ActiveKernels().m_pToLower(pData, InputView.data(), Len);
+        });
+        return Result;
+    }
+
+    //--------------------------------------------------------------------------------
+    std::string ToLowerCopy(const char* Input) noexcept
+    {
+        assert(Input != nullptr && "Input string is null");
+        return ToLowerCopy(std::string_view(Input));
+    }
+
+    //--------------------------------------------------------------------------------
+    void ToLower(std::string& Str) noexcept
+    {
+        ActiveKernels().m_pToLower(Str.data(), Str.data(), Str.size());
+    }
+
+    //--------------------------------------------------------------------------------
+    std::size_t ToLowerInto(std::span<char> Dest, const std::string_view Source) noexcept
+    {
+        if (Dest.empty()) return 0;
+
+        // Convert up to buffer size minus 1 to leave space for null terminator
+        const std::size_t Len = std::min(Source.size(), Dest.size() - 1);
+        ActiveKernels().m_pToLower(Dest.data(), Source.data(), Len);
+        Dest[Len] = '\0';
+        return Len;
+    }
+
+    //--------------------------------------------------------------------------------
+    std::wstring ToLowerCopy(const std::wstring_view InputView) noexcept
+    {
+        std::wstring Result;
+        ResizeAndOverwrite(Result, InputView.size(), [&](wchar_t* pData, const std::size_t Len) noexcept
+        {
+            std::transform(InputView.data(), InputView.data() + Len, pData, [](const wchar_t C) { return ToLower(C); });
+        });
+        return Result;
+    }
+
+    //--------------------------------------------------------------------------------
+    std::wstring ToLowerCopy(const wchar_t* Input) noexcept
+    {
+        assert(Input != nullptr && "Input wide string is null");
+        return ToLowerCopy(std::wstring_view(Input));
+    }
+
+    //--------------------------------------------------------------------------------
+    void ToLower(std::wstring& Str) noexcept
+    {
+        std::ranges::transform(Str, Str.begin(), [](wchar_t c) { return ToLower(c); });
+    }
+
+    //--------------------------------------------------------------------------------
+    std::size_t ToLowerInto(std::span<wchar_t> Dest, const std::wstring_view Source) noexcept
+    {
+        if (Dest.empty()) return 0;
+
+        // Convert up to buffer size minus 1 to leave space for null terminator
+        const std::size_t Len = std::min(Source.size(), Dest.size() - 1);
+        std::transform(Source.data(), Source.data() + Len, Dest.data(), [](const wchar_t C) { return ToLower(C); });
+        Dest[Len] = L'\0';
+        return Len;
+    }
+
+    //--------------------------------------------------------------------------------
+    std::string ToUpperCopy(const std::string_view InputView) noexcept
+    {
+        std::string Result;
+        ResizeAndOverwrite(Result, InputView.size(), [&](char* pData, const std::size_t Len) noexcept
+        {
+            ActiveKernels().m_pToUpper(pData, InputView.data(), Len);
+        });
+        return Result;
+    }
+
+    //--------------------------------------------------------------------------------
+    std::string ToUpperCopy(const char* Input) noexcept
+    {
+        assert(Input != nullptr && "Input string is null");
+        return ToUpperCopy(std::string_view(Input));
+    }
+
+    //--------------------------------------------------------------------------------
+    void ToUpper(std::string& Str) noexcept
+    {
+        ActiveKernels().m_pToUpper(Str.data(), Str.data(), Str.size());
+    }
+
+    //--------------------------------------------------------------------------------
+    std::size_t ToUpperInto(std::span<char> Dest, const std::string_view Source) noexcept
+    {
+        if (Dest.empty()) return 0;
+
+        // Convert up to buffer size minus 1 to leave space for null terminator
+        const std::size_t Len = std::min(Source.size(), Dest.size() - 1);
+        ActiveKernels().m_pToUpper(Dest.data(), Source.data(), Len);
+        Dest[Len] = '\0';
+        return Len;
+    }
+
+    //--------------------------------------------------------------------------------
+    std::wstring ToUpperCopy(const std::wstring_view InputView) noexcept
+    {
+        std::wstring Result;
+        ResizeAndOverwrite(Result, InputView.size(), [&](wchar_t* pData, const std::size_t Len) noexcept
+        {
+            std::transform(InputView.data(), InputView.data() + Len, pData, [](const wchar_t C) { return ToUpper(C); });
+        });
+        return Result;
+    }
+
+    //--------------------------------------------------------------------------------
+    std::wstring ToUpperCopy(const wchar_t* Input) noexcept
+    {
+        assert(Input != nullptr && "Input wide string is null");
+        return ToUpperCopy(std::wstring_view(Input));
+    }
+
+    //--------------------------------------------------------------------------------
+    void ToUpper(std::wstring& Str) noexcept
+    {
+        std::ranges::transform(Str, Str.begin(), [](wchar_t c) { return ToUpper(c); });
+    }
+
+    //--------------------------------------------------------------------------------
+    std::size_t ToUpperInto(std::span<wchar_t> Dest, const std::wstring_view Source) noexcept
+    {
+        if (Dest.empty()) return 0;
+
+        // Convert up to buffer size minus 1 to leave space for null terminator
+        const std::size_t Len = std::min(Source.size(), Dest.size() - 1);
+        std::transform(Source.data(), Source.data() + Len, Dest.data(), [](const wchar_t C) { return ToUpper(C); });
+        Dest[Len] = L'\0';
+        return Len;
+    }
+
+    //--------------------------------------------------------------------------------
+    int CompareI(const std::string_view A, const std::string_view B) noexcept
+    {
+        const std::size_t Len = std::min(A.size(), B.size());
+        if (const int Diff = ActiveKernels().m_pCompareI(A.data(), B.data(), Len); Diff != 0)
+        {
+            return Diff;
+        }
+        return (A.size() < B.size()) ? -1 : (A.size() > B.size()) ? 1 : 0;
+    }
+
+    //--------------------------------------------------------------------------------
+    int CompareI(const char* A, const char* B) noexcept
+    {
+        assert(A != nullptr && "First input string is null");
+        assert(B != nullptr && "Second input string is null");
+        return CompareI(std::string_view(A), std::string_view(B));
+    }
+
+    //--------------------------------------------------------------------------------
+    int CompareI(const std::wstring_view A, const std::wstring_view B) noexcept
+    {
+        const std::size_t Len = std::min(A.size(), B.size());
+        if (const int Diff = ActiveKernels().m_pCompareIW(A.data(), B.data(), Len); Diff != 0)
+        {
+            return Diff;
+        }
+        return (A.size() < B.size()) ? -1 : (A.size() > B.size()) ? 1 : 0;
+    }
+
+    //--------------------------------------------------------------------------------
+    int CompareI(const wchar_t* A, const wchar_t* B) noexcept
+    {
+        assert(A != nullptr && "First input wide string is null");
+        assert(B != nullptr && "Second input wide string is null");
+        return CompareI(std::wstring_view(A), std::wstring_view(B));
+    }
+
+    //--------------------------------------------------------------------------------
+    // Natural order comparison
+    //--------------------------------------------------------------------------------
+    namespace
+    {
+        // The mismatch kernel skips the common prefix at vector width and the digit span kernel finds
+        // where the digit runs end, the runs are then compared as numbers without converting them
+        template< typename T_CHAR >
+        int CompareNaturalIImpl(const std::basic_string_view<T_CHAR> A, const std::basic_string_view<T_CHAR> B) noexcept
+        {
+            const auto& Kernels   = ActiveKernels();
+            const auto  Mismatch  = [&](const T_CHAR* pA, const T_CHAR* pB, const std::size_t Len) noexcept
+            {
+                if constexpr (sizeof(T_CHAR) == 1) return Kernels.m_pMismatchI(pA, pB, Len);
+                else                               return Kernels.m_pMismatchIW(pA, pB, Len);
+            };
+            const auto  DigitSpan = [&](const std::basic_string_view<T_CHAR> Str, const std::size_t Pos) noexcept
+            {
+                if constexpr (sizeof(T_CHAR) == 1) return Kernels.m_pDigitSpan(Str.data() + Pos, Str.size() - Pos);
+                else                               return Kernels.m_pDigitSpanW(Str.data() + Pos, Str.size() - Pos);
+            };
+
+            std::size_t Ia = 0, Ib = 0;
+            int         ZeroTieBreak = 0;       // "1" < "01" when the strings are otherwise equal
+            while (true)
+            {
+                const std::size_t Common = Mismatch(A.data() + Ia, B.data() + Ib, std::min(A.size() - Ia, B.size() - Ib));
+
+                // A digit run may have started in the common part (it can not start before Ia, a run
+                // is always followed by a non digit or by the end of the string)
+                std::size_t Back = 0;
+                while (Back < Common && IsDigit(A[Ia + Common - Back - 1])) ++Back;
+
+                const std::size_t Sa = Ia + Common - Back, Da = DigitSpan(A, Sa);
+                const std::size_t Sb = Ib + Common - Back, Db = DigitSpan(B, Sb);
+                if (Da && Db)
+                {
+                    // Compare by value: without the leading zeros the longer run is bigger, otherwise the first different digit decides
+                    std::size_t Za = 0, Zb = 0;
+                    while (Za < Da && A[Sa + Za] == '0') ++Za;
+                    while (Zb < Db && B[Sb + Zb] == '0') ++Zb;
+                    if (Da - Za != Db - Zb) return (Da - Za < Db - Zb) ? -1 : 1;
+                    if (const int Diff = A.substr(Sa + Za, Da - Za).compare(B.substr(Sb + Zb, Db - Zb)); Diff != 0) return (Diff < 0) ? -1 : 1;
+                    if (ZeroTieBreak == 0 && Za != Zb) ZeroTieBreak = (Za < Zb) ? -1 : 1;
+                    Ia = Sa + Da;
+                    Ib = Sb + Db;
+                    continue;
+                }
+
+                Ia += Common;
+                Ib += Common;
+                if (Ia == A.size() || Ib == B.size())
+                {
+                    if (Ia == A.size() && Ib == B.size()) return ZeroTieBreak;
+                    return (Ia == A.size()) ? -1 : 1;
+                }
+                const T_CHAR Ca = ToLower(A[Ia]), Cb = ToLower(B[Ib]);
+                return (Ca < Cb) ? -1 : 1;
+            }
+        }
+    }
+
+    //--------------------------------------------------------------------------------
+    int CompareNaturalI(const std::string_view A, const std::string_view B) noexcept
+    {
+        return CompareNaturalIImpl(A, B);
+    }
+
+    //--------------------------------------------------------------------------------
+    int CompareNaturalI(const char* A, const char* B) noexcept
+    {
+        assert(A != nullptr && "First input string is null");
+        assert(B != nullptr && "Second input string is null");
+        return CompareNaturalI(std::string_view(A), std::string_view(B));
+    }
+
+    //--------------------------------------------------------------------------------
+    int CompareNaturalI(const std::wstring_view A, const std::wstring_view B) noexcept
+    {
+        return CompareNaturalIImpl(A, B);
+    }
+
+    //--------------------------------------------------------------------------------
+    int CompareNaturalI(const wchar_t* A, const wchar_t* B) noexcept
+    {
+        assert(A != nullptr && "First input wide string is null");
+        assert(B != nullptr && "Second input wide string is null");
+        return CompareNaturalI(std::wstring_view(A), std::wstring_view(B));
+    }
+
+    //--------------------------------------------------------------------------------
+    // Sort keys
+    //--------------------------------------------------------------------------------
+    namespace
+    {
+        // CompareI orders the folded chars as char, the keys are compared as unsigned bytes
+        constexpr unsigned char SortKeyFlip_v = std::is_signed_v<char> ? 0x80 : 0x00;
+
+        // Key bytes of the natural order keys (see AppendSortKeyNaturalI)
+        constexpr unsigned char SortKeyEnd_v    = 0x00;
+        constexpr unsigned char SortKeyEscape_v = 0x01;
+        constexpr unsigned char SortKeyDigits_v = static_cast<unsigned char>('0') ^ SortKeyFlip_v;
+
+        void AppendSortKeyI(std::string& Key, const std::string_view Str) noexcept
+        {
+            const std::size_t Start = Key.size();
+            Key.resize(Start + Str.size());
+            ActiveKernels().m_pToLower(Key.data() + Start, Str.data(), Str.size());
+            if constexpr (SortKeyFlip_v != 0)
+            {
+                for (std::size_t i = Start; i < Key.size(); ++i) Key[i] = static_cast<char>(Key[i] ^ SortKeyFlip_v);
+            }
+        }
+
+        // Small values take one byte, bigger ones a byte count (0xF1-0xF8) followed by the big endian bytes
+        void AppendOrderedSize(std::string& Key, const std::size_t Value) noexcept
+        {
+            if (Value < 0xF0)
+            {
+                Key += static_cast<char>(Value);
+                return;
+            }
+            const int nBytes = (std::bit_width(Value) + 7) / 8;
+            Key += static_cast<char>(0xF0 + nBytes);
+            for (int i = nBytes - 1; i >= 0; --i) Key += static_cast<char>(Value >> (i * 8));
+        }
+
+        // The key is the folded chars, where every digit run becomes SortKeyDigits_v + its length without the
+        // leading zeros + those digits, then SortKeyEnd_v and the leading zero count of every run (they only
+        // decide when everything else is equal). Folded chars that would be 0x00 or 0x01 are escaped so the
+        // end byte sorts before any char, which makes the shorter string go first
+        void AppendSortKeyNaturalI(std::string& Key, const std::string_view Str) noexcept
+        {
+            const auto& Kernels = ActiveKernels();
+            std::string LeadingZeros;
+            for (std::size_t i = 0; i < Str.size(); )
+            {
+                if (!IsDigit(Str[i]))
+                {
+                    const auto C = static_cast<unsigned char>(static_cast<unsigned char>(ToLower(Str[i])) ^ SortKeyFlip_v);
+                    if (C <= SortKeyEscape_v) Key += static_cast<char>(SortKeyEscape_v);
+                    Key += static_cast<char>(C <= SortKeyEscape_v ? C + 1 : C);
+                    ++i;
+                    continue;
+                }
+
+                const std::size_t nDigits = Kernels.m_pDigitSpan(Str.data() + i, Str.size() - i);
+                std::size_t       nZeros  = 0;
+                while (nZeros < nDigits && Str[i + nZeros] == '0') ++nZeros;
+                Key += static_cast<char>(SortKeyDigits_v);
+                AppendOrderedSize(Key, nDigits - nZeros);
+                Key.append(Str.data() + i + nZeros, nDigits - nZeros);
+                AppendOrderedSize(LeadingZeros, nZeros);
+                i += nDigits;
+            }
+            Key += static_cast<char>(SortKeyEnd_v);
+            Key += LeadingZeros;
+        }
+
+        struct sort_item
+        {
+            const char*     m_pKey;
+            std::size_t     m_KeyLen;
+            std::size_t     m_Index;        // Position in the input, keeps the sort stable
+        };
+
+        // Keys that end at Depth go to bucket 0
+        inline std::size_t SortBucket(const sort_item& Item, const std::size_t Depth) noexcept
+        {
+            return (Depth < Item.m_KeyLen) ? static_cast<unsigned char>(Item.m_pKey[Depth]) + 1 : 0;
+        }
+
+        // Both keys are known to be equal before Depth
+        inline bool SortItemLess(const sort_item& A, const sort_item& B, const std::size_t Depth) noexcept
+        {
+            if (const int Diff = std::memcmp(A.m_pKey + Depth, B.m_pKey + Depth, std::min(A.m_KeyLen, B.m_KeyLen) - Depth); Diff != 0) return Diff < 0;
+            if (A.m_KeyLen != B.m_KeyLen) return A.m_KeyLen < B.m_KeyLen;
+            return A.m_Index < B.m_Index;
+        }
+
+        // Below this many items a bucket is sorted with std::sort
+        constexpr std::size_t RadixSortMin_v      = 64;
+
+        // Nested levels before std::sort takes over, bounds the stack use on keys with long shared runs
+        constexpr int         RadixSortMaxLevel_v = 48;
+
+        // The top level buckets are sorted in parallel when there are at least this many items
+        constexpr std::size_t RadixSortParallel_v = 1 << 16;
+
+        // MSD radix sort on the key bytes (Temp is scratch memory of the same size). The scatter is stable and
+        // the std::sort fallback breaks ties with the input position, so equal keys keep their input order
+        void RadixSortItems(const std::span<sort_item> Items, const std::span<sort_item> Temp, std::size_t Depth, const int Level) noexcept
+        {
+            while (true)
+            {
+                if (Items.size() <= RadixSortMin_v || Level >= RadixSortMaxLevel_v)
+                {
+                    std::sort(Items.begin(), Items.end(), [Depth](const sort_item& A, const sort_item& B) noexcept { return SortItemLess(A, B, Depth); });
+                    return;
+                }
+
+                std::array<std::size_t, 257> Offset{};
+                for (const sort_item& Item : Items) ++Offset[SortBucket(Item, Depth)];
+
+                // Everything in one bucket, the byte is shared so go to the next one without moving anything
+                if (const std::size_t First = SortBucket(Items[0], Depth); Offset[First] == Items.size())
+                {
+                    if (First == 0) return;
+                    ++Depth;
+                    continue;
+                }
+
+                std::size_t Sum = 0;
+                for (std::size_t& Count : Offset) Sum += std::exchange(Count, Sum);
+                for (const sort_item& Item : Items) Temp[Offset[SortBucket(Item, Depth)]++] = Item;
+                std::copy(Temp.begin(), Temp.end(), Items.begin());
+
+                // Offset[b] is now the end of bucket b, and the ended keys of bucket 0 are already in input order
+                const auto SortBuckets = [&](const std::size_t Begin, const std::size_t End) noexcept
+                {
+                    for (std::size_t b = Begin + 1; b <= End; ++b)
+                    {
+                        const std::size_t Start = Offset[b - 1];
+                        if (Offset[b] - Start > 1) RadixSortItems(Items.subspan(Start, Offset[b] - Start), Temp.subspan(Start, Offset[b] - Start), Depth + 1, Level + 1);
+                    }
+                };
+                if (Level == 0 && Items.size() >= RadixSortParallel_v) ParallelFor(256, 1, SortBuckets);
+                else                                                    SortBuckets(0, 256);
+                return;
+            }
+        }
+
+        // Builds the keys (in parallel, every chunk of strings gets its own key buffer), sorts them and reorders Strings
+        template< typename T_APPEND_KEY >
+        void SortByKey(const std::span<std::string_view> Strings, T_APPEND_KEY&& AppendKey) noexcept
+        {
+            const std::size_t Count = Strings.size();
+            if (Count < 2) return;
+
+            std::vector<sort_item>   Items(Count);
+            const std::size_t        Grain = BatchGrain(Strings, 1);
+            std::vector<std::string> KeyBuffers((Count + Grain - 1) / Grain);
+            ParallelFor(Count, Grain, [&](const std::size_t Begin, const std::size_t End) noexcept
+            {
+                std::string& Keys = KeyBuffers[Begin / Grain];
+                for (std::size_t i = Begin; i < End; ++i)
+                {
+                    const std::size_t Start = Keys.size();
+                    AppendKey(Keys, Strings[i]);
+                    Items[i] = { nullptr, Keys.size() - Start, i };
+                }
+
+                // The buffer does not move any more
+                const char* pKey = Keys.data();
+                for (std::size_t i = Begin; i < End; ++i)
+                {
+                    Items[i].m_pKey = pKey;
+                    pKey += Items[i].m_KeyLen;
+                }
+            });
+
+            {
+                std::vector<sort_item> Temp(Count);
+                RadixSortItems(Items, Temp, 0, 0);
+            }
+
+            const std::vector<std::string_view> Original(Strings.begin(), Strings.end());
+            for (std::size_t i = 0; i < Count; ++i) Strings[i] = Original[Items[i].m_Index];
+        }
+    }
+
+    //--------------------------------------------------------------------------------
+    std::string MakeSortKeyI(const std::string_view Str) noexcept
+    {
+        std::string Key;
+        AppendSortKeyI(Key, Str);
+        return Key;
+    }
+
+    //--------------------------------------------------------------------------------
+    std::string MakeSortKeyNaturalI(const std::string_view Str) noexcept
+    {
+        std::string Key;
+        Key.reserve(Str.size() + 8);
+        AppendSortKeyNaturalI(Key, Str);
+        return Key;
+    }
+
+    //--------------------------------------------------------------------------------
+    void SortI(std::span<std::string_view> Strings) noexcept
+    {
+        SortByKey(Strings, AppendSortKeyI);
+    }
+
+    //--------------------------------------------------------------------------------
+    void SortNaturalI(std::span<std::string_view> Strings) noexcept
+    {
+        SortByKey(Strings, AppendSortKeyNaturalI);
+    }
+
+    //--------------------------------------------------------------------------------
+    // Finder / FinderI
+    //--------------------------------------------------------------------------------
+    namespace
+    {
+        // How common a byte is in text, higher is more common. The anchors of a finder are
+        // its rarest bytes so that the anchor pair filter rejects as many positions as possible
+        constexpr auto ByteFrequency_v = []() constexpr
+        {
+            constexpr std::string_view Common = " etaoinsrhldcumfpgwybv,.k\n-0_1=2:/\"x3j'9qz5()84\r76[]\t;<>{}|*@#$%&+!?^~`ETAOINSRHLDCUMFPGWYBVKXJQZ";
+            std::array<std::uint8_t, 256> Table{};
+            for (std::size_t i = 0; i < Common.size(); ++i) Table[static_cast<unsigned char>(Common[i])] = static_cast<std::uint8_t>(255 - i);
+            return Table;
+        }();
+
+        // Needles longer than this use the Two-Way search (anchor candidates are verified with a full compare,
+        // which would make the worst case O(n*m) for long needles)
+        constexpr std::size_t FinderShortNeedle_v = 64;
+
+        // The Two-Way prefilter only verifies this many leading bytes of the needle, so it stays linear
+        constexpr std::size_t FinderPrefix_v = 32;
+
+        // The anchors are the rarest byte and the rarest other byte (or else another position of the same byte)
+        void ChooseAnchors(const std::string_view Window, std::size_t& Anchor1, std::size_t& Anchor2) noexcept
+        {
+            const auto Rank = [&](const std::size_t i) { return ByteFrequency_v[static_cast<unsigned char>(Window[i])]; };
+            Anchor1 = 0;
+            for (std::size_t i = 1; i < Window.size(); ++i)
+            {
+                if (Rank(i) < Rank(Anchor1)) Anchor1 = i;
+            }
+
+            Anchor2 = (Anchor1 == 0 && Window.size() > 1) ? 1 : 0;
+            for (std::size_t i = 0; i < Window.size(); ++i)
+            {
+                if (i == Anchor1) continue;
+                const bool bOther     = Window[i]       != Window[Anchor1];
+                const bool bBestOther = Window[Anchor2] != Window[Anchor1];
+                if (bOther != bBestOther ? bOther : Rank(i) < Rank(Anchor2)) Anchor2 = i;
+            }
+        }
+
+        // Maximal suffix of Needle for the byte order (or the reversed order), Crochemore-Perrin
+        // @return Start of the suffix minus one, and its period.
+        std::pair<std::ptrdiff_t, std::size_t> MaximalSuffix(const std::string_view Needle, const bool bReversed) noexcept
+        {
+            std::ptrdiff_t I = -1;
+            std::size_t    J = 0, K = 1, Period = 1;
+            while (J + K < Needle.size())
+            {
+                const auto A = static_cast<unsigned char>(Needle[static_cast<std::size_t>(I + static_cast<std::ptrdiff_t>(K))]);
+                const auto B = static_cast<unsigned char>(Needle[J + K]);
+                if (A == B)
+                {
+                    if (K == Period) { J += Period; K = 1; }
+                    else             ++K;
+                }
+                else if ((A > B) != bReversed)
+                {
+                    J     += K;
+                    K      = 1;
+                    Period = static_cast<std::size_t>(static_cast<std::ptrdiff_t>(J) - I);
+                }
+                else
+                {
+                    I = static_cast<std::ptrdiff_t>(J++);
+                    K = Period = 1;
+                }
+            }
+            return { I, Period };
+        }
+
+        // Critical factorization of the needle for the Two-Way search
+        void TwoWayFactorization(const std::string_view Needle, std::size_t& Split, std::size_t& Period, std::size_t& Memory) noexcept
+        {
+            const auto [Suffix1, Period1] = MaximalSuffix(Needle, false);
+            const auto [Suffix2, Period2] = MaximalSuffix(Needle, true);
+            const bool bSecond = Suffix2 > Suffix1;
+            Split  = static_cast<std::size_t>((bSecond ? Suffix2 : Suffix1) + 1);
+            Period = bSecond ? Period2 : Period1;
+
+            // When the needle is periodic the matched part of the period is remembered after a shift,
+            // otherwise the shift is larger than either half and nothing needs to be remembered
+            if (std::memcmp(Needle.data(), Needle.data() + Period, Split) == 0)
+            {
+                Memory = Needle.size() - Period;
+            }
+            else
+            {
+                Period = std::max(Split - 1, Needle.size() - Split) + 1;
+                Memory = 0;
+            }
+        }
+
+        // True when a proper prefix of Needle is also a suffix, only then can two matches overlap
+        bool HasBorder(const std::string_view Needle) noexcept
+        {
+            for (std::size_t Shift = 1; Shift < Needle.size(); ++Shift)
+            {
+                if (Needle.substr(Shift) == Needle.substr(0, Needle.size() - Shift)) return true;
+            }
+            return false;
+        }
+    }
+
+    //--------------------------------------------------------------------------------
+    template< bool T_IGNORE_CASE_V >
+    BasicFinder<T_IGNORE_CASE_V>::BasicFinder(const std::string_view Needle) noexcept
+        : m_Needle{ T_IGNORE_CASE_V ? ToLowerCopy(Needle) : std::string(Needle) }
+    {
+        if (m_Needle.empty()) return;
+
+        // Long needles take the anchors from the prefix that the Two-Way prefilter verifies
+        ChooseAnchors(std::string_view(m_Needle).substr(0, m_Needle.size() > FinderShortNeedle_v ? FinderPrefix_v : m_Needle.size()), m_Anchor1, m_Anchor2);
+        if (m_Needle.size() <= FinderShortNeedle_v) return;
+
+        TwoWayFactorization(m_Needle, m_Split, m_Period, m_Memory);
+    }
+
+    //--------------------------------------------------------------------------------
+    template< bool T_IGNORE_CASE_V >
+    std::size_t BasicFinder<T_IGNORE_CASE_V>::Find(const std::string_view Haystack, const std::size_t Pos) const noexcept
+    {
+        assert(Pos <= Haystack.size() && "Starting position exceeds haystack length");
+        if (m_Needle.empty() || Pos + m_Needle.size() > Haystack.size()) return std::string::npos;
+
+        const auto& Kernels = ActiveKernels();
+        const auto  pKernel = T_IGNORE_CASE_V ? Kernels.m_pFindI : Kernels.m_pFind;
+        if (m_Needle.size() <= FinderShortNeedle_v) return pKernel(Haystack, m_Needle, Pos, m_Anchor1, m_Anchor2);
+
+        // Two-Way: the right half is compared forward, a mismatch shifts by how far it got. Once the right half
+        // matches the left half is compared backward, a mismatch there shifts by the period.
+        // With nothing remembered the anchor kernel jumps to the next position whose prefix matches
+        const auto             Fold    = [](const char C) { return T_IGNORE_CASE_V ? ToLower(C) : C; };
+        const std::string_view Prefix  = std::string_view(m_Needle).substr(0, FinderPrefix_v);
+        const std::string_view Filter  = Haystack.substr(0, Haystack.size() - m_Needle.size() + Prefix.size());
+        const std::size_t      Last    = Haystack.size() - m_Needle.size();
+        const char*            pNeedle = m_Needle.data();
+        std::size_t            Memory  = 0;
+        for (std::size_t i = Pos; i <= Last; )
+        {
+            if (Memory == 0)
+            {
+                i = pKernel(Filter, Prefix, i, m_Anchor1, m_Anchor2);
+                if (i == std::string::npos) break;
+            }
+
+            const char* pHay = Haystack.data() + i;
+            std::size_t k    = std::max(m_Split, Memory);
+            while (k < m_Needle.size() && Fold(pHay[k]) == pNeedle[k]) ++k;
+            if (k < m_Needle.size())
+            {
+                i      += k - m_Split + 1;
+                Memory  = 0;
+                continue;
+            }
+
+            k = m_Split;
+            while (k > Memory && Fold(pHay[k - 1]) == pNeedle[k - 1]) --k;
+            if (k <= Memory) return i;
+
+            i      += m_Period;
+            Memory  = m_Memory;
+        }
+        return std::string::npos;
+    }
+
+    //--------------------------------------------------------------------------------
+    template< bool T_IGNORE_CASE_V >
+    std::size_t BasicFinder<T_IGNORE_CASE_V>::Count(const std::string_view Haystack, const match_mode Mode) const noexcept
+    {
+        if (m_Needle.empty() || m_Needle.size() > Haystack.size()) return 0;
+
+        // The count kernel counts every match, which is also the non overlapping count when matches can not overlap
+        if (m_Needle.size() <= FinderShortNeedle_v && (Mode == match_mode::OVERLAPPING || !HasBorder(m_Needle)))
+        {
+            const auto& Kernels = ActiveKernels();
+            return (T_IGNORE_CASE_V ? Kernels.m_pCountI : Kernels.m_pCount)(Haystack, m_Needle, 0, m_Anchor1, m_Anchor2);
+        }
+
+        const std::size_t Step  = (Mode == match_mode::OVERLAPPING) ? 1 : m_Needle.size();
+        std::size_t       Count = 0;
+        for (std::size_t Pos = Find(Haystack); Pos != std::string::npos; Pos = (Pos + Step <= Haystack.size()) ? Find(Haystack, Pos + Step) : std::string::npos) ++Count;
+        return Count;
+    }
+
+    template class BasicFinder<false>;
+    template class BasicFinder<true>;
+
+    //--------------------------------------------------------------------------------
+    template< bool T_IGNORE_CASE_V >
+    BasicReverseFinder<T_IGNORE_CASE_V>::BasicReverseFinder(const std::string_view Needle) noexcept
+        : m_Needle{ T_IGNORE_CASE_V ? ToLowerCopy(Needle) : std::string(Needle) }
+    {
+        if (m_Needle.empty()) return;
+
+        // Long needles take the anchors from the suffix that the Two-Way prefilter verifies
+        const std::size_t Window = m_Needle.size() > FinderShortNeedle_v ? FinderPrefix_v : m_Needle.size();
+        ChooseAnchors(std::string_view(m_Needle).substr(m_Needle.size() - Window), m_Anchor1, m_Anchor2);
+        if (m_Needle.size() <= FinderShortNeedle_v) return;
+
+        // Searching backwards is the forward Two-Way search of the reversed needle in the reversed haystack
+        const std::string Reversed(m_Needle.rbegin(), m_Needle.rend());
+        TwoWayFactorization(Reversed, m_Split, m_Period, m_Memory);
+    }
+
+    //--------------------------------------------------------------------------------
+    template< bool T_IGNORE_CASE_V >
+    std::size_t BasicReverseFinder<T_IGNORE_CASE_V>::Find(const std::string_view Haystack, const std::size_t Pos) const noexcept
+    {
+        assert(Pos == std::string::npos || (Pos <= Haystack.size() && "Starting position exceeds haystack length"));
+        if (m_Needle.empty() || m_Needle.size() > Haystack.size()) return std::string::npos;
+
+        const auto&       Kernels = ActiveKernels();
+        const auto        pKernel = T_IGNORE_CASE_V ? Kernels.m_pRFindI : Kernels.m_pRFind;
+        const std::size_t Size    = m_Needle.size();
+        const std::size_t Start   = std::min(Pos, Haystack.size() - Size);
+        if (Size <= FinderShortNeedle_v) return pKernel(Haystack, m_Needle, Start, m_Anchor1, m_Anchor2);
+
+        // Two-Way on the reversed strings, see BasicFinder::Find. Offset k of the reversed window at i is
+        // pHay[Size - 1 - k] and every shift moves i down. Position i of Filter is the window at i whose
+        // suffix is compared with the anchor kernel
+        const auto             Fold    = [](const char C) { return T_IGNORE_CASE_V ? ToLower(C) : C; };
+        const std::string_view Suffix  = std::string_view(m_Needle).substr(Size - FinderPrefix_v);
+        const std::string_view Filter  = Haystack.substr(Size - FinderPrefix_v);
+        const char*            pNeedle = m_Needle.data() + Size - 1;
+        std::size_t            Memory  = 0;
+        for (std::size_t i = Start; ; )
+        {
+            if (Memory == 0)
+            {
+                i = pKernel(Filter, Suffix, i, m_Anchor1, m_Anchor2);
+                if (i == std::string::npos) break;
+            }
+
+            const char* pHay = Haystack.data() + i + Size - 1;
+            std::size_t k    = std::max(m_Split, Memory);
+            while (k < Size && Fold(pHay[-static_cast<std::ptrdiff_t>(k)]) == pNeedle[-static_cast<std::ptrdiff_t>(k)]) ++k;
+            if (k < Size)
+            {
+                const std::size_t Shift = k - m_Split + 1;
+                if (Shift > i) break;
+                i      -= Shift;
+                Memory  = 0;
+                continue;
+            }
+
+            k = m_Split;
+            while (k > Memory && Fold(pHay[1 - static_cast<std::ptrdiff_t>(k)]) == pNeedle[1 - static_cast<std::ptrdiff_t>(k)]) --k;
+            if (k <= Memory) return i;
+
+            if (m_Period > i) break;
+            i      -= m_Period;
+            Memory  = m_Memory;
+        }
+        return std::string::npos;
+    }
+
+    template class BasicReverseFinder<false>;
+    template class BasicReverseFinder<true>;
+
+    //--------------------------------------------------------------------------------
+    std::size_t Find(const std::string_view Haystack, const std::string_view Needle, const std::size_t Pos) noexcept
+    {
+        assert(Pos <= Haystack.size() && "Starting position exceeds haystack length");
+        if (Needle.empty() || Pos + Needle.size() > Haystack.size()) return std::string::npos;
+
+        // Short needles do not need a copy, the kernel works on the caller's needle directly
+        if (Needle.size() > FinderShortNeedle_v) return Finder(Needle).Find(Haystack, Pos);
+
+        std::size_t Anchor1, Anchor2;
+        ChooseAnchors(Needle, Anchor1, Anchor2);
+        return ActiveKernels().m_pFind(Haystack, Needle, Pos, Anchor1, Anchor2);
+    }
+
+    //--------------------------------------------------------------------------------
+    std::size_t Count(const std::string_view Haystack, const std::string_view Needle, const match_mode Mode) noexcept
+    {
+        return Finder(Needle).Count(Haystack, Mode);
+    }
+
+    //--------------------------------------------------------------------------------
+    std::size_t CountI(const std::string_view Haystack, const std::string_view Needle, const match_mode Mode) noexcept
+    {
+        return FinderI(Needle).Count(Haystack, Mode);
+    }
+
+    //--------------------------------------------------------------------------------
+    // MultiFinder / MultiFinderI
+    //--------------------------------------------------------------------------------
+    namespace
+    {
+        // Pattern sets up to this size use the Teddy front end (8 buckets of up to 4 patterns)
+        constexpr std::size_t TeddyMaxPatterns_v = 32;
+
+        template< bool T_IGNORE_CASE_V >
+        inline bool PatternAt(const std::string_view Haystack, const std::size_t Pos, const std::string& Pattern) noexcept
+        {
+            if (Pattern.size() > Haystack.size() - Pos) return false;
+            if constexpr (T_IGNORE_CASE_V) return scalar::EqualsLowered(Haystack.data() + Pos, Pattern.data(), Pattern.size());
+            else                           return std::memcmp(Haystack.data() + Pos, Pattern.data(), Pattern.size()) == 0;
+        }
+
+        // Leftmost first, then the longest, then the lowest id
+        inline bool IsBetterMatch(const std::size_t Offset, const std::size_t Len, const std::size_t Id, const pattern_match& Best, const std::size_t BestLen) noexcept
+        {
+            if (Best.m_Offset != Offset) return Offset < Best.m_Offset;
+            if (BestLen != Len)          return Len > BestLen;
+            return Id < Best.m_PatternId;
+        }
+    }
+
+    //--------------------------------------------------------------------------------
+    template< bool T_IGNORE_CASE_V >
+    BasicMultiFinder<T_IGNORE_CASE_V>::BasicMultiFinder(std::span<const std::string_view> Patterns) noexcept
+    {
+        std::size_t MinLen = std::string::npos;
+        m_Patterns.reserve(Patterns.size());
+        for (const std::string_view Pattern : Patterns)
+        {
+            m_Patterns.push_back(T_IGNORE_CASE_V ? ToLowerCopy(Pattern) : std::string(Pattern));
+            if (Pattern.empty()) continue;
+            m_MaxLen = std::max(m_MaxLen, Pattern.size());
+            MinLen   = std::min(MinLen, Pattern.size());
+        }
+        if (m_MaxLen == 0) return;
+
+        m_bTeddy = m_Patterns.size() <= TeddyMaxPatterns_v;
+        if (m_bTeddy)
+        {
+            m_FingerprintLen = std::min<std::size_t>(MinLen, 3);
+
+            // Patterns with similar fingerprints share a bucket, so the buckets stay selective
+            std::vector<std::uint32_t> Ids;
+            for (std::size_t i = 0; i < m_Patterns.size(); ++i)
+            {
+                if (!m_Patterns[i].empty()) Ids.push_back(static_cast<std::uint32_t>(i));
+            }
+            std::ranges::stable_sort(Ids, {}, [&](const std::uint32_t Id) { return std::string_view(m_Patterns[Id]).substr(0, m_FingerprintLen); });
+
+            const auto SetNibbles = [&](const std::size_t k, const unsigned char C, const std::uint8_t Bit)
+            {
+                m_TeddyMasks[k * 32 + (C & 0xF)]       |= Bit;
+                m_TeddyMasks[k * 32 + 16 + (C >> 4)]   |= Bit;
+            };
+
+            for (std::size_t i = 0; i < Ids.size(); ++i)
+            {
+                const std::size_t Bucket = i * 8 / Ids.size();
+                const auto        Bit    = static_cast<std::uint8_t>(1u << Bucket);
+                m_BucketBegin[Bucket + 1] = static_cast<std::uint32_t>(i + 1);
+                m_BucketIds.push_back(Ids[i]);
+                for (std::size_t k = 0; k < m_FingerprintLen; ++k)
+                {
+                    const auto C = static_cast<unsigned char>(m_Patterns[Ids[i]][k]);
+                    SetNibbles(k, C, Bit);
+                    if (T_IGNORE_CASE_V && C >= 'a' && C <= 'z') SetNibbles(k, static_cast<unsigned char>(C - 32), Bit);
+                }
+            }
+
+            // Empty buckets (fewer than 8 patterns) start where the previous one ended
+            for (std::size_t b = 1; b <= 8; ++b) m_BucketBegin[b] = std::max(m_BucketBegin[b], m_BucketBegin[b - 1]);
+            return;
+        }
+
+        // Aho-Corasick, the bytes that are in no pattern share class 0 (when there are such bytes)
+        bool bUsed[256] = {};
+        for (const std::string& Pattern : m_Patterns)
+        {
+            for (const char C : Pattern) bUsed[static_cast<unsigned char>(C)] = true;
+        }
+        m_ClassCount = std::ranges::all_of(bUsed, [](const bool b) { return b; }) ? 0 : 1;
+        for (std::size_t c = 0; c < 256; ++c)
+        {
+            if (bUsed[c]) m_ByteClass[c] = static_cast<std::uint8_t>(m_ClassCount++);
+        }
+        if (T_IGNORE_CASE_V)
+        {
+            for (std::size_t c = 'A'; c <= 'Z'; ++c) m_ByteClass[c] = m_ByteClass[c + 32];
+        }
+
+        // Trie, a zero transition is a missing child (the root is nobody's child)
+        const std::size_t                       Classes = m_ClassCount;
+        std::vector<std::uint32_t>              Trans(Classes, 0);
+        std::vector<std::vector<std::uint32_t>> Out(1);
+        for (std::size_t Id = 0; Id < m_Patterns.size(); ++Id)
+        {
+            if (m_Patterns[Id].empty()) continue;
+
+            std::size_t State = 0;
+            for (const char C : m_Patterns[Id])
+            {
+                const std::size_t Index = State * Classes + m_ByteClass[static_cast<unsigned char>(C)];
+                if (Trans[Index] == 0)
+                {
+                    Trans[Index] = static_cast<std::uint32_t>(Out.size());
+                    Trans.resize(Trans.size() + Classes, 0);
+                    Out.emplace_back();
+                }
+                State = Trans[Index];
+            }
+            Out[State].push_back(static_cast<std::uint32_t>(Id));
+        }
+
+        // Breadth first the failure links complete the DFA: a missing transition takes the one of the failure state,
+        // which is shallower and so already complete. A state also matches everything its failure state matches
+        std::vector<std::uint32_t> Fail(Out.size(), 0);
+        std::vector<std::uint32_t> Queue;
+        Queue.reserve(Out.size());
+        for (std::size_t c = 0; c < Classes; ++c)
+        {
+            if (Trans[c]) Queue.push_back(Trans[c]);
+        }
+        for (std::size_t q = 0; q < Queue.size(); ++q)
+        {
+            const std::uint32_t State = Queue[q];
+            Out[State].insert(Out[State].end(), Out[Fail[State]].begin(), Out[Fail[State]].end());
+            for (std::size_t c = 0; c < Classes; ++c)
+            {
+                std::uint32_t& Next = Trans[State * Classes + c];
+                if (Next)
+                {
+                    Fail[Next] = Trans[Fail[State] * Classes + c];
+                    Queue.push_back(Next);
+                }
+                else
+                {
+                    Next = Trans[Fail[State] * Classes + c];
+                }
+            }
+        }
+
+        m_Transitions = std::move(Trans);
+        m_OutputBegin.reserve(Out.size() + 1);
+        for (auto& Ids : Out)
+        {
+            std::ranges::sort(Ids, [&](const std::uint32_t A, const std::uint32_t B)
+            {
+                return (m_Patterns[A].size() != m_Patterns[B].size()) ? m_Patterns[A].size() > m_Patterns[B].size() : A < B;
+            });
+            m_OutputBegin.push_back(static_cast<std::uint32_t>(m_Outputs.size()));
+            m_Outputs.insert(m_Outputs.end(), Ids.begin(), Ids.end());
+        }
+        m_OutputBegin.push_back(static_cast<std::uint32_t>(m_Outputs.size()));
+    }
+
+    //--------------------------------------------------------------------------------
+    template< bool T_IGNORE_CASE_V >
+    pattern_match BasicMultiFinder<T_IGNORE_CASE_V>::Find(const std::string_view Haystack, const std::size_t Pos) const noexcept
+    {
+        assert(Pos <= Haystack.size() && "Starting position exceeds haystack length");
+        pattern_match Best;
+        std::size_t   BestLen = 0;
+        if (m_MaxLen == 0) return Best;
+
+        if (m_bTeddy)
+        {
+            if (Haystack.size() - Pos < m_FingerprintLen) return Best;
+
+            // Candidates come in order, so the first one that verifies is the leftmost match
+            const auto&       Kernels = ActiveKernels();
+            const std::size_t End     = Haystack.size() - m_FingerprintLen + 1;
+            std::uint8_t      Buckets = 0;
+            for (std::size_t i = Pos; (i = Kernels.m_pTeddy(m_TeddyMasks, m_FingerprintLen, Haystack.data(), i, End, Buckets)) != std::string::npos; ++i)
+            {
+                for (std::uint32_t Bits = Buckets; Bits; Bits &= Bits - 1)
+                {
+                    const std::size_t b = std::countr_zero(Bits);
+                    for (std::uint32_t j = m_BucketBegin[b]; j < m_BucketBegin[b + 1]; ++j)
+                    {
+                        const std::uint32_t Id = m_BucketIds[j];
+                        if (PatternAt<T_IGNORE_CASE_V>(Haystack, i, m_Patterns[Id]) && IsBetterMatch(i, m_Patterns[Id].size(), Id, Best, BestLen))
+                        {
+                            Best    = { i, Id };
+                            BestLen = m_Patterns[Id].size();
+                        }
+                    }
+                }
+                if (BestLen) break;
+            }
+            return Best;
+        }
+
+        // The longest output of a state starts the earliest. Once a match is known the scan only goes on
+        // while a longer pattern could still start at or before it
+        std::uint32_t State = 0;
+        for (std::size_t i = Pos; i < Haystack.size(); ++i)
+        {
+            State = m_Transitions[State * m_ClassCount + m_ByteClass[static_cast<unsigned char>(Haystack[i])]];
+            if (m_OutputBegin[State] != m_OutputBegin[State + 1])
+            {
+                const std::uint32_t Id  = m_Outputs[m_OutputBegin[State]];
+                const std::size_t   Len = m_Patterns[Id].size();
+                if (IsBetterMatch(i + 1 - Len, Len, Id, Best, BestLen))
+                {
+                    Best    = { i + 1 - Len, Id };
+                    BestLen = Len;
+                }
+            }
+            if (BestLen && i + 1 - Best.m_Offset >= m_MaxLen) break;
+        }
+        return Best;
+    }
+
+    //--------------------------------------------------------------------------------
+    template< bool T_IGNORE_CASE_V >
+    void BasicMultiFinder<T_IGNORE_CASE_V>::FindAll(const std::string_view Haystack, std::vector<pattern_match>& Matches) const noexcept
+    {
+        Matches.clear();
+        if (m_MaxLen == 0) return;
+
+        if (m_bTeddy)
+        {
+            if (Haystack.size() < m_FingerprintLen) return;
+
+            const auto&       Kernels = ActiveKernels();
+            const std::size_t End     = Haystack.size() - m_FingerprintLen + 1;
+            std::uint8_t      Buckets = 0;
+            for (std::size_t i = 0; (i = Kernels.m_pTeddy(m_TeddyMasks, m_FingerprintLen, Haystack.data(), i, End, Buckets)) != std::string::npos; ++i)
+            {
+                for (std::uint32_t Bits = Buckets; Bits; Bits &= Bits - 1)
+                {
+                    const std::size_t b = std::countr_zero(Bits);
+                    for (std::uint32_t j = m_BucketBegin[b]; j < m_BucketBegin[b + 1]; ++j)
+                    {
+                        if (PatternAt<T_IGNORE_CASE_V>(Haystack, i, m_Patterns[m_BucketIds[j]])) Matches.push_back({ i, m_BucketIds[j] });
+                    }
+                }
+            }
+        }
+        else
+        {
+            std::uint32_t State = 0;
+            for (std::size_t i = 0; i < Haystack.size(); ++i)
+            {
+                State = m_Transitions[State * m_ClassCount + m_ByteClass[static_cast<unsigned char>(Haystack[i])]];
+                for (std::uint32_t j = m_OutputBegin[State]; j < m_OutputBegin[State + 1]; ++j)
+                {
+                    Matches.push_back({ i + 1 - m_Patterns[m_Outputs[j]].size(), m_Outputs[j] });
+                }
+            }
+        }
+
+        std::ranges::sort(Matches, [](const pattern_match& A, const pattern_match& B)
+        {
+            return (A.m_Offset != B.m_Offset) ? A.m_Offset < B.m_Offset : A.m_PatternId < B.m_PatternId;
+        });
+    }
+
+    template class BasicMultiFinder<false>;
+    template class BasicMultiFinder<true>;
+
+    //--------------------------------------------------------------------------------
+    pattern_match FindAny(const std::string_view Haystack, std::span<const std::string_view> Patterns, const std::size_t Pos) noexcept
+    {
+        return MultiFinder(Patterns).Find(Haystack, Pos);
+    }
+
+    //--------------------------------------------------------------------------------
+    pattern_match FindAnyI(const std::string_view Haystack, std::span<const std::string_view> Patterns, const std::size_t Pos) noexcept
+    {
+        return MultiFinderI(Patterns).Find(Haystack, Pos);
+    }
+
+    //--------------------------------------------------------------------------------
+    // StreamFinder / StreamFinderI
+    //--------------------------------------------------------------------------------
+    template< bool T_IGNORE_CASE_V >
+    BasicStreamFinder<T_IGNORE_CASE_V>::BasicStreamFinder(const std::string_view Needle) noexcept
+        : m_Finder{ Needle }
+        , m_Keep{ Needle.empty() ? 0 : Needle.size() - 1 }
+    {
+    }
+
+    //--------------------------------------------------------------------------------
+    template< bool T_IGNORE_CASE_V >
+    BasicStreamFinder<T_IGNORE_CASE_V>::BasicStreamFinder(std::span<const std::string_view> Patterns) noexcept
+        : m_MultiFinder{ Patterns }
+        , m_bMulti{ true }
+    {
+        for (const auto& Pattern : Patterns) m_Keep = std::max(m_Keep, Pattern.empty() ? 0 : Pattern.size() - 1);
+    }
+
+    //--------------------------------------------------------------------------------
+    template< bool T_IGNORE_CASE_V >
+    void BasicStreamFinder<T_IGNORE_CASE_V>::Feed(const std::string_view Chunk, std::vector<pattern_match>& Matches) noexcept
+    {
+        // Appends every match of a haystack (offset by Base) for the single needle or the pattern set
+        const auto FindAll = [&](const std::string_view Haystack, const std::size_t Base, std::vector<pattern_match>& Out)
+        {
+            if (m_bMulti)
+            {
+                m_MultiFinder.FindAll(Haystack, Out);
+                for (auto& Match : Out) Match.m_Offset += Base;
+                return;
+            }
+            Out.clear();
+            for (std::size_t Pos = m_Finder.Find(Haystack); Pos != std::string::npos; Pos = m_Finder.Find(Haystack, Pos + 1)) Out.push_back({ Base + Pos, 0 });
+        };
+        const auto Length = [&](const pattern_match& Match) { return m_bMulti ? m_MultiFinder.Pattern(Match.m_PatternId).size() : m_Finder.size(); };
+
+        // A match that ends in this chunk but starts before it starts in the tail, and it uses at most m_Keep bytes of the chunk.
+        // The tail is searched together with them and only the matches that cross into the chunk are new
+        const std::size_t TailSize = m_Tail.size();
+        const std::size_t TailBase = m_Offset - TailSize;
+        Matches.clear();
+        if (TailSize)
+        {
+            m_Tail.append(Chunk.substr(0, m_Keep));
+            FindAll(m_Tail, TailBase, m_Scratch);
+            for (const auto& Match : m_Scratch)
+            {
+                if (Match.m_Offset - TailBase < TailSize && Match.m_Offset - TailBase + Length(Match) > TailSize) Matches.push_back(Match);
+            }
+        }
+
+        // The matches inside the chunk are found in place, they all start after the ones crossing the boundary
+        if (!Chunk.empty())
+        {
+            FindAll(Chunk, m_Offset, m_Scratch);
+            Matches.insert(Matches.end(), m_Scratch.begin(), m_Scratch.end());
+        }
+
+        // Keep the last m_Keep bytes of the stream
+        if (Chunk.size() >= m_Keep)
+        {
+            m_Tail.assign(Chunk.substr(Chunk.size() - m_Keep));
+        }
+        else
+        {
+            if (m_Tail.size() == TailSize) m_Tail.append(Chunk);
+            if (m_Tail.size() > m_Keep) m_Tail.erase(0, m_Tail.size() - m_Keep);
+        }
+        m_Offset += Chunk.size();
+    }
+
+    //--------------------------------------------------------------------------------
+    template< bool T_IGNORE_CASE_V >
+    void BasicStreamFinder<T_IGNORE_CASE_V>::Reset() noexcept
+    {
+        m_Offset = 0;
+        m_Tail.clear();
+    }
+
+    template class BasicStreamFinder<false>;
+    template class BasicStreamFinder<true>;
+
+    //--------------------------------------------------------------------------------
+    // SearchFile
+    //--------------------------------------------------------------------------------
+    namespace
+    {
+        // Bytes per shard of SearchFile, big enough that a shard costs much more than handing it to a thread
+        constexpr std::size_t SearchShard_v = 1024 * 1024;
+
+        // Maps a whole file read only, the deleter of Data unmaps it. An empty file is not mapped (Data stays null)
+        bool MapFile(const std::string_view Path, std::shared_ptr<const char>& Data, std::size_t& Size) noexcept
+        {
+        #ifdef _WIN32
+            const HANDLE hFile = CreateFileW(UTF8ToUTF16(Path).c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+            if (hFile == INVALID_HANDLE_VALUE) return false;
+
+            LARGE_INTEGER FileSize;
+            if (!GetFileSizeEx(hFile, &FileSize))
+            {
+                CloseHandle(hFile);
+                return false;
+            }
+            Size = static_cast<std::size_t>(FileSize.QuadPart);
+            if (Size == 0)
+            {
+                CloseHandle(hFile);
+                return true;
+            }
+
+            const HANDLE hMapping = CreateFileMappingW(hFile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            CloseHandle(hFile);
+            if (hMapping == nullptr) return false;
+            const void* pView = MapViewOfFile(hMapping, FILE_MAP_READ, 0, 0, 0);
+            CloseHandle(hMapping);
+            if (pView == nullptr) return false;
+
+            // If the control block can not be allocated the deleter is still called
+            try { Data = std::shared_ptr<const char>(static_cast<const char*>(pView), [](const char* p) noexcept { UnmapViewOfFile(p); }); }
+            catch (...) { return false; }
+        #else
+            const int Fd = open(std::string(Path).c_str(), O_RDONLY | O_CLOEXEC);
+            if (Fd < 0) return false;
+
+            struct stat Info;
+            if (fstat(Fd, &Info) != 0 || !S_ISREG(Info.st_mode))
+            {
+                close(Fd);
+                return false;
+            }
+            Size = static_cast<std::size_t>(Info.st_size);
+            if (Size == 0)
+            {
+                close(Fd);
+                return true;
+            }
+
+            void* pView = mmap(nullptr, Size, PROT_READ, MAP_PRIVATE, Fd, 0);
+            close(Fd);
+            if (pView == MAP_FAILED) return false;
+
+            // If the control block can not be allocated the deleter is still called
+            try { Data = std::shared_ptr<const char>(static_cast<const char*>(pView), [Size](const char* p) noexcept { munmap(const_cast<char*>(p), Size); }); }
+            catch (...) { return false; }
+        #endif
+            return true;
+        }
+
+        // The matches of one shard, their line numbers start at 0 in the shard
+        struct search_shard
+        {
+            std::vector<file_match> m_Matches;
+            std::size_t             m_Lines     = 0;        // New lines in the shard
+            bool                    m_bDone     = false;    // False if the shard was not searched to the end (or to the match limit)
+        };
+
+        template< bool T_IGNORE_CASE_V >
+        void SearchShards(const std::string_view File, const std::vector<std::size_t>& Starts, const BasicFinder<T_IGNORE_CASE_V>& Searcher, const search_options& Options, std::vector<search_shard>& Shards) noexcept
+        {
+            const Finder      NewLine("\n");
+            const std::size_t MaxMatches = Options.m_MaxMatches ? Options.m_MaxMatches : std::string::npos;
+            const auto        bStop      = [&]() { return Options.m_pStop && Options.m_pStop->load(std::memory_order_relaxed); };
+
+            // The first shard that found MaxMatches matches by itself, the shards after it can not add any
+            std::atomic<std::size_t> FullShard{ Shards.size() };
+
+            const auto SearchShard = [&](const std::size_t Index) noexcept
+            {
+                if (Index > FullShard.load(std::memory_order_relaxed) || bStop()) return;
+
+                search_shard&          Shard     = Shards[Index];
+                const std::string_view Text      = File.substr(Starts[Index], Starts[Index + 1] - Starts[Index]);
+                std::size_t            Line      = 0;
+                std::size_t            LineBegin = 0;
+                std::size_t            LineEnd   = 0;                   // End of the line of the last match, 0 before the first one
+                for (std::size_t Pos = Searcher.Find(Text); Pos != std::string::npos; Pos = (Pos + Searcher.size() <= Text.size()) ? Searcher.Find(Text, Pos + Searcher.size()) : std::string::npos)
+                {
+                    if (bStop()) return;
+
+                    // The needle has no new line so a match never leaves its line
+                    if (Pos >= LineEnd)
+                    {
+                        Line     += NewLine.Count(Text.substr(LineBegin, Pos - LineBegin));
+                        LineBegin = Text.rfind('\n', Pos) + 1;
+                        LineEnd   = std::min(Text.find('\n', Pos), Text.size());
+                    }
+
+                    std::string_view LineView = Text.substr(LineBegin, LineEnd - LineBegin);
+                    if (LineView.ends_with('\r')) LineView.remove_suffix(1);
+                    Shard.m_Matches.push_back({ Line, Pos - LineBegin, LineView });
+
+                    if (Shard.m_Matches.size() == MaxMatches)
+                    {
+                        for (std::size_t Full = FullShard.load(std::memory_order_relaxed); Index < Full && !FullShard.compare_exchange_weak(Full, Index, std::memory_order_relaxed); ) {}
+                        Shard.m_bDone = true;
+                        return;
+                    }
+                }
+
+                Shard.m_Lines = Line + NewLine.Count(Text.substr(LineBegin));
+                Shard.m_bDone = true;
+            };
+
+            ParallelFor(Shards.size(), 1, [&](const std::size_t Begin, const std::size_t End) noexcept
+            {
+                for (std::size_t Index = Begin; Index < End; ++Index) SearchShard(Index);
+            });
+        }
+    }
+
+    //--------------------------------------------------------------------------------
+    file_search_result SearchFile(const std::string_view Path, const std::string_view Needle, const search_options& Options) noexcept
+    {
+        file_search_result Result;
+        std::size_t        Size = 0;
+        if (!MapFile(Path, Result.m_pData, Size)) return Result;
+        Result.m_bOpened = true;
+        if (Needle.empty() || Needle.size() > Size || Needle.find('\n') != std::string_view::npos) return Result;
+
+        // Shards start after the first new line past every SearchShard_v bytes
+        const std::string_view   File(Result.m_pData.get(), Size);
+        std::vector<std::size_t> Starts{ 0 };
+        for (std::size_t Pos = SearchShard_v; Pos < Size; Pos += SearchShard_v)
+        {
+            const auto* pNewLine = static_cast<const char*>(std::memchr(File.data() + Pos, '\n', Size - Pos));
+            if (pNewLine == nullptr || pNewLine + 1 == File.data() + Size) break;
+            Pos = static_cast<std::size_t>(pNewLine + 1 - File.data());
+            Starts.push_back(Pos);
+        }
+        Starts.push_back(Size);
+
+        std::vector<search_shard> Shards(Starts.size() - 1);
+        if (Options.m_bIgnoreCase) SearchShards(File, Starts, FinderI(Needle), Options, Shards);
+        else                       SearchShards(File, Starts, Finder(Needle), Options, Shards);
+
+        // Line numbers are the prefix sum of the new lines of the shards before
+        const std::size_t MaxMatches = Options.m_MaxMatches ? Options.m_MaxMatches : std::string::npos;
+        std::size_t       FirstLine  = 1;
+        for (auto& Shard : Shards)
+        {
+            if (Result.m_Matches.size() == MaxMatches) break;
+            if (!Shard.m_bDone)
+            {
+                Result.m_bStopped = true;
+                break;
+            }
+            for (auto& Match : Shard.m_Matches)
+            {
+                if (Result.m_Matches.size() == MaxMatches) break;
+                Match.m_Line += FirstLine;
+                Result.m_Matches.push_back(Match);
+            }
+            FirstLine += Shard.m_Lines;
+        }
         return Result;
     }
 
     //--------------------------------------------------------------------------------
-    std::wstring To(const char* Input) noexcept
+    std::size_t findI(const std::string_view Haystack, const std::string_view Needle, const std::size_t Pos) noexcept
     {
-        assert(Input != nullptr && "Input string is null");
-        return To(std::string_view(Input));
+        if (Needle.empty())
+        {
+            return std::string::npos; // Empty needle matches at Pos (if valid)
+        }
+
+        assert(Pos <= Haystack.size() && "Starting position exceeds haystack length");
+        if (Pos + Needle.size() > Haystack.size())
+        {
+            return std::string::npos;
+        }
+
+        return FinderI(Needle).Find(Haystack, Pos);
     }
 
     //--------------------------------------------------------------------------------
-    std::string To(const std::wstring_view InputView) noexcept
+    std::size_t findI(const char* Haystack, const char* Needle, const std::size_t Pos) noexcept
     {
-        std::string Result(InputView.size(), 0);
-        std::transform(InputView.begin(), InputView.end(), Result.begin(), [](const wchar_t wch) { return static_cast<char>(wch); });
-        return Result;
+        assert(Haystack != nullptr && "Haystack string is null");
+        assert(Needle != nullptr && "Needle string is null");
+        return findI(std::string_view(Haystack), std::string_view(Needle), Pos);
     }
 
     //--------------------------------------------------------------------------------
-    std::string To(const wchar_t* Input) noexcept
+    std::size_t findI(const std::wstring_view Haystack, const std::wstring_view Needle, const std::size_t Pos) noexcept
     {
-        assert(Input != nullptr && "Input wide string is null");
-        return To(std::wstring_view(Input));
+        assert(Pos <= Haystack.size() && "Starting position exceeds haystack length");
+        if (Pos + Needle.size() > Haystack.size() || Needle.empty())
+        {
+            return std::wstring::npos;
+        }
+
+        const std::wstring LowerNeedle = ToLowerCopy(Needle);
+        return ActiveKernels().m_pFindIW(Haystack, LowerNeedle, Pos);
     }
 
     //--------------------------------------------------------------------------------
-
-    std::string CopyN(const std::string_view Source, std::size_t N) noexcept
+    std::size_t findI(const wchar_t* Haystack, const wchar_t* Needle, const std::size_t Pos) noexcept
     {
-        std::string Result;
-        Result.resize(std::min(N, Source.size()));
-        std::copy_n(Source.begin(), Result.size(), Result.begin());
-        return Result;
+        assert(Haystack != nullptr && "Haystack wide string is null");
+        assert(Needle != nullptr && "Needle wide string is null");
+        return findI(std::wstring_view(Haystack), std::wstring_view(Needle), Pos);
     }
 
     //--------------------------------------------------------------------------------
 
-    std::string CopyN(const char* Source, std::size_t N) noexcept
+    std::size_t rfindI(const std::string_view Haystack, const std::string_view Needle, const std::size_t Pos) noexcept
     {
-        assert(Source != nullptr && "Source string is null");
-        return CopyN(std::string_view(Source), N);
+        assert(Pos == std::string::npos || Pos <= Haystack.size() && "Starting position exceeds haystack length");
+        if (Needle.empty())
+        {
+            return Pos == std::string::npos ? Haystack.size() : std::min(Pos, Haystack.size());
+        }
+        if (Needle.size() > Haystack.size())
+        {
+            return std::string::npos;
+        }
+        return ReverseFinderI(Needle).Find(Haystack, Pos);
     }
 
     //--------------------------------------------------------------------------------
 
-    std::wstring CopyN(const std::wstring_view Source, std::size_t N) noexcept
+    std::size_t rfindI(const char* Haystack, const char* Needle, const std::size_t Pos) noexcept
     {
-        std::wstring Result;
-        Result.resize(std::min(N, Source.size()));
-        std::copy_n(Source.begin(), Result.size(), Result.begin());
-        return Result;
+        assert(Haystack != nullptr && "Haystack string is null");
+        assert(Needle != nullptr && "Needle string is null");
+        return rfindI(std::string_view(Haystack), std::string_view(Needle), Pos);
     }
 
     //--------------------------------------------------------------------------------
 
-    std::wstring CopyN(const wchar_t* Source, std::size_t N) noexcept
+    std::size_t rfindI(const std::wstring_view Haystack, const std::wstring_view Needle, const std::size_t Pos) noexcept
     {
-        assert(Source != nullptr && "Source wide string is null");
-        return CopyN(std::wstring_view(Source), N);
+        assert(Pos == std::wstring::npos || Pos <= Haystack.size() && "Starting position exceeds haystack length");
+        if (Needle.empty())
+        {
+            return Pos == std::wstring::npos ? Haystack.size() : std::min(Pos, Haystack.size());
+        }
+        if (Needle.size() > Haystack.size())
+        {
+            return std::wstring::npos;
+        }
+        const std::size_t  StartPos    = Pos == std::wstring::npos ? Haystack.size() - Needle.size() : std::min(Pos, Haystack.size() - Needle.size());
+        const std::wstring LowerNeedle = ToLowerCopy(Needle);
+        return ActiveKernels().m_pRFindIW(Haystack, LowerNeedle, StartPos);
     }
 
     //--------------------------------------------------------------------------------
 
-    std::size_t Copy(std::span<char> Dest, std::string_view Source) noexcept
+    std::size_t rfindI(const wchar_t* Haystack, const wchar_t* Needle, const std::size_t Pos) noexcept
     {
-        if ( Dest.empty() ) return 0;
-
-        // Copy up to buffer size minus 1 to leave space for null terminator
-        std::size_t copy_len = std::min(Source.size(), Dest.size() - 1);
-        std::copy_n(Source.begin(), copy_len, Dest.begin());
-
-        // Null-terminate
-        Dest[copy_len] = '\0';
-        return copy_len;
+        assert(Haystack != nullptr && "Haystack wide string is null");
+        assert(Needle != nullptr && "Needle wide string is null");
+        return rfindI(std::wstring_view(Haystack), std::wstring_view(Needle), Pos);
     }
 
     //--------------------------------------------------------------------------------
-    std::string ToLowerCopy(const std::string_view InputView) noexcept
+    bool StartsWithI(const std::string_view Haystack, const std::string_view Needle) noexcept
     {
-        std::string Result(InputView);
-        ToLower(Result);
-        return Result;
+        return Needle.size() <= Haystack.size() && CompareI(Haystack.substr(0, Needle.size()), Needle) == 0;
     }
 
     //--------------------------------------------------------------------------------
-    std::string ToLowerCopy(const char* Input) noexcept
+    bool StartsWithI(const char* Haystack, const char* Needle) noexcept
     {
-        assert(Input != nullptr && "Input string is null");
-        return ToLowerCopy(std::string_view(Input));
+        assert(Haystack != nullptr && "Haystack string is null");
+        assert(Needle != nullptr && "Needle string is null");
+        return StartsWithI(std::string_view(Haystack), std::string_view(Needle));
     }
 
     //--------------------------------------------------------------------------------
-    void ToLower(std::string& Str) noexcept
+    bool StartsWithI(const std::wstring_view Haystack, const std::wstring_view Needle) noexcept
     {
-        if constexpr (optimized_sse_v)
-        {
-            // SSE optimized for ASCII tolower (add 32 for 'A'-'Z')
-            const std::size_t Len = Str.size();
-            char* Data = Str.data();
-            __m128i LowerMask = _mm_set1_epi8(32);
-            __m128i UpperA = _mm_set1_epi8('A' - 1);
-            __m128i UpperZ = _mm_set1_epi8('Z' + 1);
-            for (std::size_t i = 0; i < Len / 16 * 16; i += 16)
-            {
-                __m128i V = _mm_loadu_si128(reinterpret_cast<__m128i*>(Data + i));
-                __m128i Mask1 = _mm_cmpgt_epi8(V, UpperA);
-                __m128i Mask2 = _mm_cmpgt_epi8(UpperZ, V);
-                __m128i Mask = _mm_and_si128(Mask1, Mask2);
-                V = _mm_add_epi8(V, _mm_and_si128(Mask, LowerMask));
-                _mm_storeu_si128(reinterpret_cast<__m128i*>(Data + i), V);
-            }
-            for (std::size_t i = Len / 16 * 16; i < Len; ++i)
-            {
-                Str[i] = ToLower(Str[i]);
-            }
-        }
-        else
-        {
-            std::ranges::transform(Str, Str.begin(), [](char c) { return ToLower(c); });
-        }
+        return Needle.size() <= Haystack.size() && ActiveKernels().m_pCompareIW(Haystack.data(), Needle.data(), Needle.size()) == 0;
     }
 
     //--------------------------------------------------------------------------------
-    std::wstring ToLowerCopy(const std::wstring_view InputView) noexcept
+    bool StartsWithI(const wchar_t* Haystack, const wchar_t* Needle) noexcept
     {
-        std::wstring Result(InputView);
-        ToLower(Result);
-        return Result;
+        assert(Haystack != nullptr && "Haystack wide string is null");
+        assert(Needle != nullptr && "Needle wide string is null");
+        return StartsWithI(std::wstring_view(Haystack), std::wstring_view(Needle));
     }
 
     //--------------------------------------------------------------------------------
-    std::wstring ToLowerCopy(const wchar_t* Input) noexcept
+    bool EndsWithI(const std::string_view Haystack, const std::string_view Needle) noexcept
     {
-        assert(Input != nullptr && "Input wide string is null");
-        return ToLowerCopy(std::wstring_view(Input));
+        return Needle.size() <= Haystack.size() && CompareI(Haystack.substr(Haystack.size() - Needle.size()), Needle) == 0;
     }
 
     //--------------------------------------------------------------------------------
-    void ToLower(std::wstring& Str) noexcept
+    bool EndsWithI(const char* Haystack, const char* Needle) noexcept
     {
-        std::ranges::transform(Str, Str.begin(), [](wchar_t c) { return ToLower(c); });
+        assert(Haystack != nullptr && "Haystack string is null");
+        assert(Needle != nullptr && "Needle string is null");
+        return EndsWithI(std::string_view(Haystack), std::string_view(Needle));
     }
 
     //--------------------------------------------------------------------------------
-    std::string ToUpperCopy(const std::string_view InputView) noexcept
+    bool EndsWithI(const std::wstring_view Haystack, const std::wstring_view Needle) noexcept
     {
-        std::string Result(InputView);
-        ToUpper(Result);
-        return Result;
+        return Needle.size() <= Haystack.size() && ActiveKernels().m_pCompareIW(Haystack.data() + Haystack.size() - Needle.size(), Needle.data(), Needle.size()) == 0;
     }
 
     //--------------------------------------------------------------------------------
-    std::string ToUpperCopy(const char* Input) noexcept
+    bool EndsWithI(const wchar_t* Haystack, const wchar_t* Needle) noexcept
     {
-        assert(Input != nullptr && "Input string is null");
-        return ToUpperCopy(std::string_view(Input));
+        assert(Haystack != nullptr && "Haystack wide string is null");
+        assert(Needle != nullptr && "Needle wide string is null");
+        return EndsWithI(std::wstring_view(Haystack), std::wstring_view(Needle));
     }
 
     //--------------------------------------------------------------------------------
-    void ToUpper(std::string& Str) noexcept
+    template< bool T_SUFFIX_V >
+    BasicAffixSetI<T_SUFFIX_V>::BasicAffixSetI(std::span<const std::string_view> Entries) noexcept
+        : m_Count{ Entries.size() }
     {
-        if constexpr (optimized_sse_v)
+        // Plain trie first, every node with its (label, child) list
+        struct build_node
         {
-            // SSE optimized for ASCII toupper (subtract 32 for 'a'-'z')
-            const std::size_t Len = Str.size();
-            char* Data = Str.data();
-            __m128i UpperMask = _mm_set1_epi8(-32);
-            __m128i LowerA = _mm_set1_epi8('a' - 1);
-            __m128i LowerZ = _mm_set1_epi8('z' + 1);
-            for (std::size_t i = 0; i < Len / 16 * 16; i += 16)
-            {
-                __m128i V = _mm_loadu_si128(reinterpret_cast<__m128i*>(Data + i));
-                __m128i Mask1 = _mm_cmpgt_epi8(V, LowerA);
-                __m128i Mask2 = _mm_cmpgt_epi8(LowerZ, V);
-                __m128i Mask = _mm_and_si128(Mask1, Mask2);
-                V = _mm_add_epi8(V, _mm_and_si128(Mask, UpperMask));
-                _mm_storeu_si128(reinterpret_cast<__m128i*>(Data + i), V);
-            }
-            for (std::size_t i = Len / 16 * 16; i < Len; ++i)
+            std::vector<std::pair<char, std::uint32_t>> m_Children;
+            std::uint32_t                               m_Id = ~0u;
+        };
+        std::vector<build_node> Trie(1);
+        for (std::size_t Id = 0; Id < Entries.size(); ++Id)
+        {
+            const std::string_view Entry = Entries[Id];
+            std::uint32_t          Node  = 0;
+            for (std::size_t i = 0; i < Entry.size(); ++i)
             {
-                Str[i] = ToUpper(Str[i]);
+                const char C     = ToLower(Entry[T_SUFFIX_V ? Entry.size() - 1 - i : i]);
+                auto&      Edges = Trie[Node].m_Children;
+                const auto It    = std::ranges::find(Edges, C, &std::pair<char, std::uint32_t>::first);
+                if (It != Edges.end())
+                {
+                    Node = It->second;
+                    continue;
+                }
+                Edges.emplace_back(C, static_cast<std::uint32_t>(Trie.size()));
+                Node = static_cast<std::uint32_t>(Trie.size());
+                Trie.emplace_back();
             }
+            if (Trie[Node].m_Id == ~0u) Trie[Node].m_Id = static_cast<std::uint32_t>(Id);
         }
-        else
+
+        // Breadth first renumbering puts the children of every node next to each other
+        std::vector<std::uint32_t> Order{ 0 };
+        m_Nodes.resize(3 * Trie.size());
+        m_Labels.assign(Trie.size() + 16, 0);
+        for (std::size_t n = 0; n < Order.size(); ++n)
         {
-            std::ranges::transform(Str, Str.begin(), [](char c) { return ToUpper(c); });
+            const build_node& Node = Trie[Order[n]];
+            m_Nodes[3 * n + 0] = static_cast<std::uint32_t>(Order.size());
+            m_Nodes[3 * n + 1] = static_cast<std::uint32_t>(Node.m_Children.size());
+            m_Nodes[3 * n + 2] = Node.m_Id;
+            for (const auto& [Label, Child] : Node.m_Children)
+            {
+                m_Labels[Order.size()] = Label;
+                Order.push_back(Child);
+            }
         }
     }
 
     //--------------------------------------------------------------------------------
-    std::wstring ToUpperCopy(const std::wstring_view InputView) noexcept
+    template< bool T_SUFFIX_V >
+    std::size_t BasicAffixSetI<T_SUFFIX_V>::Match(const std::string_view Str) const noexcept
     {
-        std::wstring Result(InputView);
-        ToUpper(Result);
-        return Result;
+        if (m_Nodes.empty()) return std::string::npos;
+        return ActiveKernels().m_pAffixMatch(m_Nodes.data(), m_Labels.data(), Str.data(), Str.size(), T_SUFFIX_V);
     }
 
+    template class BasicAffixSetI<false>;
+    template class BasicAffixSetI<true>;
+
     //--------------------------------------------------------------------------------
-    std::wstring ToUpperCopy(const wchar_t* Input) noexcept
+    std::size_t StartsWithAnyI(const std::string_view Str, std::span<const std::string_view> Prefixes) noexcept
     {
-        assert(Input != nullptr && "Input wide string is null");
-        return ToUpperCopy(std::wstring_view(Input));
+        return PrefixSetI(Prefixes).Match(Str);
     }
 
     //--------------------------------------------------------------------------------
-    void ToUpper(std::wstring& Str) noexcept
+    std::size_t EndsWithAnyI(const std::string_view Str, std::span<const std::string_view> Suffixes) noexcept
     {
-        std::ranges::transform(Str, Str.begin(), [](wchar_t c) { return ToUpper(c); });
+        return SuffixSetI(Suffixes).Match(Str);
     }
 
     //--------------------------------------------------------------------------------
-    int CompareI(const std::string_view A, const std::string_view B) noexcept
+    bool ContainsI(const std::string_view Haystack, const std::string_view Needle) noexcept
     {
-        if constexpr (optimized_sse_v)
-        {
-            // SSE optimized ASCII case-insensitive compare
-            const std::size_t Len = std::min(A.size(), B.size());
-            const char* Pa = A.data();
-            const char* Pb = B.data();
-            __m128i LowerMask = _mm_set1_epi8(32);
-            __m128i UpperA = _mm_set1_epi8('A' - 1);
-            __m128i UpperZ = _mm_set1_epi8('Z' + 1);
-            for (std::size_t i = 0; i < Len / 16 * 16; i += 16)
-            {
-                __m128i Va = _mm_loadu_si128(reinterpret_cast<const __m128i*>(Pa + i));
-                __m128i Vb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(Pb + i));
-                __m128i MaskA = _mm_and_si128(_mm_cmpgt_epi8(Va, UpperA), _mm_cmpgt_epi8(UpperZ, Va));
-                __m128i MaskB = _mm_and_si128(_mm_cmpgt_epi8(Vb, UpperA), _mm_cmpgt_epi8(UpperZ, Vb));
-                Va = _mm_or_si128(Va, _mm_and_si128(MaskA, LowerMask));
-                Vb = _mm_or_si128(Vb, _mm_and_si128(MaskB, LowerMask));
-                __m128i Eq = _mm_cmpeq_epi8(Va, Vb);
-                if (_mm_movemask_epi8(Eq) != 0xFFFF)
-                {
-                    for (std::size_t j = i; j < i + 16 && j < Len; ++j)
-                    {
-                        char Ca = ToLower(A[j]), Cb = ToLower(B[j]);
-                        if (Ca != Cb) return (Ca < Cb) ? -1 : 1;
-                    }
-                }
-            }
-            for (std::size_t i = Len / 16 * 16; i < Len; ++i)
-            {
-                char Ca = ToLower(A[i]), Cb = ToLower(B[i]);
-                if (Ca != Cb) return (Ca < Cb) ? -1 : 1;
-            }
-            return (A.size() < B.size()) ? -1 : (A.size() > B.size()) ? 1 : 0;
-        }
-        else
+        if ( Needle.empty() ) return true;
+        return FinderI(Needle).Contains(Haystack);
+    }
+
+    //--------------------------------------------------------------------------------
+    bool ContainsI(const char* Haystack, const char* Needle) noexcept
+    {
+        assert(Haystack != nullptr && "Haystack string is null");
+        assert(Needle != nullptr && "Needle string is null");
+        return ContainsI(std::string_view(Haystack), std::string_view(Needle));
+    }
+
+    //--------------------------------------------------------------------------------
+    namespace
+    {
+        // Candidate positions per block of the parallel search, a thread checks for a match found before
+        // its block only between blocks
+        constexpr std::size_t ParallelSearchBlock_v = 1024 * 1024;
+
+        // bFirst keeps the blocks before a match going so the first match is found, otherwise every
+        // block stops as soon as any match is known
+        std::size_t ParallelSearchI(const std::string_view Haystack, const FinderI& Searcher, const std::size_t Pos, const bool bFirst) noexcept
         {
-            const std::size_t Len = std::min(A.size(), B.size());
-            for (std::size_t i = 0; i < Len; ++i)
+            const std::size_t        Candidates = Haystack.size() - Searcher.size() + 1 - Pos;
+            std::atomic<std::size_t> Best{ std::string::npos };
+            ParallelFor(Candidates, ParallelSearchBlock_v, [&](const std::size_t Begin, const std::size_t End) noexcept
             {
-                const char Ca = ToLower(A[i]), Cb = ToLower(B[i]);
-                if (Ca != Cb)
+                for (std::size_t Block = Begin; Block < End; Block += ParallelSearchBlock_v)
                 {
-                    return (Ca < Cb) ? -1 : 1;
+                    const std::size_t Known = Best.load(std::memory_order_relaxed);
+                    if (bFirst ? Pos + Block >= Known : Known != std::string::npos) return;
+
+                    // The block overlaps the next one by the needle length minus one
+                    const std::size_t Start = Pos + Block;
+                    const std::size_t Count = std::min(End - Block, ParallelSearchBlock_v);
+                    const std::size_t Match = Searcher.Find(Haystack.substr(Start, Count + Searcher.size() - 1));
+                    if (Match == std::string::npos) continue;
+
+                    for (std::size_t Current = Best.load(std::memory_order_relaxed); Start + Match < Current && !Best.compare_exchange_weak(Current, Start + Match, std::memory_order_relaxed); ) {}
+                    return;
                 }
-            }
-            return (A.size() < B.size()) ? -1 : (A.size() > B.size()) ? 1 : 0;
+            });
+            return Best.load(std::memory_order_relaxed);
         }
     }
 
     //--------------------------------------------------------------------------------
-    int CompareI(const char* A, const char* B) noexcept
+    std::size_t ParallelFindI(const std::string_view Haystack, const std::string_view Needle, const std::size_t Pos, const std::size_t Threshold) noexcept
     {
-        assert(A != nullptr && "First input string is null");
-        assert(B != nullptr && "Second input string is null");
-        return CompareI(std::string_view(A), std::string_view(B));
+        assert(Pos <= Haystack.size() && "Starting position exceeds haystack length");
+        if (Needle.empty() || Pos + Needle.size() > Haystack.size() || Haystack.size() - Pos < Threshold) return findI(Haystack, Needle, Pos);
+        return ParallelSearchI(Haystack, FinderI(Needle), Pos, true);
     }
 
     //--------------------------------------------------------------------------------
-    int CompareI(const std::wstring_view A, const std::wstring_view B) noexcept
+    bool ParallelContainsI(const std::string_view Haystack, const std::string_view Needle, const std::size_t Threshold) noexcept
     {
-        const std::size_t Len = std::min(A.size(), B.size());
-        for (std::size_t i = 0; i < Len; ++i)
-        {
-            const wchar_t Ca = ToLower(A[i]), Cb = ToLower(B[i]);
-            if (Ca != Cb)
-            {
-                return (Ca < Cb) ? -1 : 1;
-            }
-        }
-        return (A.size() < B.size()) ? -1 : (A.size() > B.size()) ? 1 : 0;
+        if (Needle.empty() || Needle.size() > Haystack.size() || Haystack.size() < Threshold) return ContainsI(Haystack, Needle);
+        return ParallelSearchI(Haystack, FinderI(Needle), 0, false) != std::string::npos;
     }
 
     //--------------------------------------------------------------------------------
-    int CompareI(const wchar_t* A, const wchar_t* B) noexcept
+    bool ContainsI(const std::wstring_view Haystack, const std::wstring_view Needle) noexcept
     {
-        assert(A != nullptr && "First input wide string is null");
-        assert(B != nullptr && "Second input wide string is null");
-        return CompareI(std::wstring_view(A), std::wstring_view(B));
+        if (Needle.empty()) return true;
+        return findI(Haystack, Needle) != std::wstring::npos;
     }
 
     //--------------------------------------------------------------------------------
-    std::size_t findI(const std::string_view Haystack, const std::string_view Needle, const std::size_t Pos) noexcept
+    bool ContainsI(const wchar_t* Haystack, const wchar_t* Needle) noexcept
     {
-        if (Needle.empty())
-        {
-            return std::string::npos; // Empty needle matches at Pos (if valid)
-        }
+        assert(Haystack != nullptr && "Haystack wide string is null");
+        assert(Needle != nullptr && "Needle wide string is null");
+        return ContainsI(std::wstring_view(Haystack), std::wstring_view(Needle));
+    }
 
-        if constexpr (optimized_sse_v)
-        {
-            // SSE optimized for ASCII case-insensitive find
-            assert(Pos <= Haystack.size() && "Starting position exceeds haystack length");
-            if (Pos + Needle.size() > Haystack.size() || Needle.empty())
-            {
-                return std::string::npos;
-            }
-            std::string LowerNeedle = ToLowerCopy(Needle);
-            const char* Hay = Haystack.data();
-            const char* Ndl = LowerNeedle.data();
-            __m128i LowerMask = _mm_set1_epi8(32);
-            __m128i UpperA = _mm_set1_epi8('A' - 1);
-            __m128i UpperZ = _mm_set1_epi8('Z' + 1);
-            for (std::size_t i = Pos; i <= Haystack.size() - Needle.size(); ++i)
-            {
-                bool Match = true;
-                for (std::size_t j = 0; j < Needle.size() / 16 * 16; j += 16)
-                {
-                    __m128i Vh = _mm_loadu_si128(reinterpret_cast<const __m128i*>(Hay + i + j));
-                    __m128i Vn = _mm_loadu_si128(reinterpret_cast<const __m128i*>(Ndl + j));
-                    __m128i MaskH = _mm_and_si128(_mm_cmpgt_epi8(Vh, UpperA), _mm_cmpgt_epi8(UpperZ, Vh));
-                    Vh = _mm_or_si128(Vh, _mm_and_si128(MaskH, LowerMask));
-                    __m128i Eq = _mm_cmpeq_epi8(Vh, Vn);
-                    if (_mm_movemask_epi8(Eq) != 0xFFFF)
-                    {
-                        Match = false;
-                        break;
-                    }
-                }
-                if (Match)
-                {
-                    for (std::size_t j = Needle.size() / 16 * 16; j < Needle.size(); ++j)
-                    {
-                        if (ToLower(Haystack[i + j]) != LowerNeedle[j])
-                        {
-                            Match = false;
-                            break;
-                        }
-                    }
-                }
-                if (Match) return i;
-            }
-            return std::string::npos;
-        }
-        else
-        {
-            assert(Pos <= Haystack.size() && "Starting position exceeds haystack length");
-            if (Pos + Needle.size() > Haystack.size() || Needle.empty())
-            {
-                return std::string::npos;
-            }
-            for (std::size_t i = Pos; i <= Haystack.size() - Needle.size(); ++i)
-            {
-                if (CompareI(Haystack.substr(i, Needle.size()), Needle) == 0)
-                {
-                    return i;
-                }
-            }
-            return std::string::npos;
-        }
+    //--------------------------------------------------------------------------------
+    std::string_view TrimLeftCopy(const std::string_view InputView) noexcept
+    {
+        return InputView.substr(ActiveKernels().m_pTrimLeft(InputView.data(), InputView.size()));
+    }
+
+    //--------------------------------------------------------------------------------
+    std::string_view TrimLeftCopy(const char* Input) noexcept
+    {
+        assert(Input != nullptr && "Input string is null");
+        return TrimLeftCopy(std::string_view(Input));
     }
 
     //--------------------------------------------------------------------------------
-    std::size_t findI(const char* Haystack, const char* Needle, const std::size_t Pos) noexcept
+    void TrimLeft(std::string& Str) noexcept
     {
-        assert(Haystack != nullptr && "Haystack string is null");
-        assert(Needle != nullptr && "Needle string is null");
-        return findI(std::string_view(Haystack), std::string_view(Needle), Pos);
+        Str = Str.substr(TrimLeftCopy(Str).data() - Str.data());
     }
 
     //--------------------------------------------------------------------------------
-    std::size_t findI(const std::wstring_view Haystack, const std::wstring_view Needle, const std::size_t Pos) noexcept
+    std::string_view TrimRightCopy(const std::string_view InputView) noexcept
     {
-        assert(Pos <= Haystack.size() && "Starting position exceeds haystack length");
-        if (Pos + Needle.size() > Haystack.size() || Needle.empty())
-        {
-            return std::wstring::npos;
-        }
-        for (std::size_t i = Pos; i <= Haystack.size() - Needle.size(); ++i)
-        {
-            if (CompareI(Haystack.substr(i, Needle.size()), Needle) == 0)
-            {
-                return i;
-            }
-        }
-        return std::wstring::npos;
+        return InputView.substr(0, ActiveKernels().m_pTrimRight(InputView.data(), InputView.size()));
     }
 
     //--------------------------------------------------------------------------------
-    std::size_t findI(const wchar_t* Haystack, const wchar_t* Needle, const std::size_t Pos) noexcept
+    std::string_view TrimRightCopy(const char* Input) noexcept
     {
-        assert(Haystack != nullptr && "Haystack wide string is null");
-        assert(Needle != nullptr && "Needle wide string is null");
-        return findI(std::wstring_view(Haystack), std::wstring_view(Needle), Pos);
+        assert(Input != nullptr && "Input string is null");
+        return TrimRightCopy(std::string_view(Input));
     }
 
     //--------------------------------------------------------------------------------
+    void TrimRight(std::string& Str) noexcept
+    {
+        Str.erase(TrimRightCopy(Str).size());
+    }
 
-    std::size_t rfindI(const std::string_view Haystack, const std::string_view Needle, const std::size_t Pos) noexcept
+    //--------------------------------------------------------------------------------
+    std::string_view TrimCopy(const std::string_view InputView) noexcept
     {
-        assert(Pos == std::string::npos || Pos <= Haystack.size() && "Starting position exceeds haystack length");
-        if (Needle.empty())
-        {
-            return Pos == std::string::npos ? Haystack.size() : std::min(Pos, Haystack.size());
-        }
-        if (Needle.size() > Haystack.size())
-        {
-            return std::string::npos;
-        }
-        std::size_t StartPos = Pos == std::string::npos ? Haystack.size() - Needle.size() : std::min(Pos, Haystack.size() - Needle.size());
+        return TrimLeftCopy(TrimRightCopy(InputView));
+    }
 
-        if constexpr (optimized_sse_v)
-        {
-            std::string LowerNeedle = ToLowerCopy(Needle);
-            const char* Hay = Haystack.data();
-            const char* Ndl = LowerNeedle.data();
-            __m128i LowerMask = _mm_set1_epi8(32);
-            __m128i UpperA = _mm_set1_epi8('A' - 1);
-            __m128i UpperZ = _mm_set1_epi8('Z' + 1);
-            for (std::size_t i = StartPos; i <= StartPos; --i)
-            {
-                bool Match = true;
-                for (std::size_t k = 0; k < Needle.size() / 16 * 16; k += 16)
-                {
-                    __m128i Vh = _mm_loadu_si128(reinterpret_cast<const __m128i*>(Hay + i + k));
-                    __m128i Vn = _mm_loadu_si128(reinterpret_cast<const __m128i*>(Ndl + k));
-                    __m128i MaskH = _mm_and_si128(_mm_cmpgt_epi8(Vh, UpperA), _mm_cmpgt_epi8(UpperZ, Vh));
-                    Vh = _mm_or_si128(Vh, _mm_and_si128(MaskH, LowerMask));
-                    __m128i Eq = _mm_cmpeq_epi8(Vh, Vn);
-                    if (_mm_movemask_epi8(Eq) != 0xFFFF)
-                    {
-                        Match = false;
-                        break;
-                    }
-                }
-                if (Match)
-                {
-                    for (std::size_t k = Needle.size() / 16 * 16; k < Needle.size(); ++k)
-                    {
-                        if (ToLower(Haystack[i + k]) != LowerNeedle[k])
-                        {
-                            Match = false;
-                            break;
-                        }
-                    }
-                }
-                if (Match) return i;
-                if (i == 0) break;
-            }
-            return std::string::npos;
-        }
-        else
-        {
-            for (std::size_t i = StartPos; i <= StartPos; --i)
-            {
-                if (CompareI(Haystack.substr(i, Needle.size()), Needle) == 0)
-                {
-                    return i;
-                }
-                if (i == 0) break;
-            }
-            return std::string::npos;
-        }
+    //--------------------------------------------------------------------------------
+    std::string_view TrimCopy(const char* Input) noexcept
+    {
+        assert(Input != nullptr && "Input string is null");
+        return TrimCopy(std::string_view(Input));
     }
 
     //--------------------------------------------------------------------------------
+    void Trim(std::string& Str) noexcept
+    {
+        Str = std::string(TrimCopy(Str));
+    }
 
-    std::size_t rfindI(const char* Haystack, const char* Needle, const std::size_t Pos) noexcept
+    //--------------------------------------------------------------------------------
+    std::wstring_view TrimLeftCopy(const std::wstring_view InputView) noexcept
     {
-        assert(Haystack != nullptr && "Haystack string is null");
-        assert(Needle != nullptr && "Needle string is null");
-        return rfindI(std::string_view(Haystack), std::string_view(Needle), Pos);
+        return InputView.substr(ActiveKernels().m_pTrimLeftW(InputView.data(), InputView.size()));
     }
 
     //--------------------------------------------------------------------------------
+    std::wstring_view TrimLeftCopy(const wchar_t* Input) noexcept
+    {
+        assert(Input != nullptr && "Input wide string is null");
+        return TrimLeftCopy(std::wstring_view(Input));
+    }
 
-    std::size_t rfindI(const std::wstring_view Haystack, const std::wstring_view Needle, const std::size_t Pos) noexcept
+    //--------------------------------------------------------------------------------
+    void TrimLeft(std::wstring& Str) noexcept
     {
-        assert(Pos == std::wstring::npos || Pos <= Haystack.size() && "Starting position exceeds haystack length");
-        if (Needle.empty())
-        {
-            return Pos == std::wstring::npos ? Haystack.size() : std::min(Pos, Haystack.size());
-        }
-        if (Needle.size() > Haystack.size())
-        {
-            return std::wstring::npos;
-        }
-        std::size_t StartPos = Pos == std::wstring::npos ? Haystack.size() - Needle.size() : std::min(Pos, Haystack.size() - Needle.size());
-        for (std::size_t i = StartPos + 1; i > 0; --i)
-        {
-            std::size_t j = i - 1;
-            if (CompareI(Haystack.substr(j, Needle.size()), Needle) == 0)
-            {
-                return j;
-            }
-        }
-        return std::wstring::npos;
+        Str = Str.substr(TrimLeftCopy(Str).data() - Str.data());
     }
 
     //--------------------------------------------------------------------------------
+    std::wstring_view TrimRightCopy(const std::wstring_view InputView) noexcept
+    {
+        return InputView.substr(0, ActiveKernels().m_pTrimRightW(InputView.data(), InputView.size()));
+    }
 
-    std::size_t rfindI(const wchar_t* Haystack, const wchar_t* Needle, const std::size_t Pos) noexcept
+    //--------------------------------------------------------------------------------
+    std::wstring_view TrimRightCopy(const wchar_t* Input) noexcept
     {
-        assert(Haystack != nullptr && "Haystack wide string is null");
-        assert(Needle != nullptr && "Needle wide string is null");
-        return rfindI(std::wstring_view(Haystack), std::wstring_view(Needle), Pos);
+        assert(Input != nullptr && "Input wide string is null");
+        return TrimRightCopy(std::wstring_view(Input));
     }
 
     //--------------------------------------------------------------------------------
-    bool StartsWithI(const std::string_view Haystack, const std::string_view Needle) noexcept
+    void TrimRight(std::wstring& Str) noexcept
     {
-        return Needle.size() <= Haystack.size() && CompareI(Haystack.substr(0, Needle.size()), Needle) == 0;
+        Str.erase(TrimRightCopy(Str).size());
     }
 
     //--------------------------------------------------------------------------------
-    bool StartsWithI(const char* Haystack, const char* Needle) noexcept
+    std::wstring_view TrimCopy(const std::wstring_view InputView) noexcept
     {
-        assert(Haystack != nullptr && "Haystack string is null");
-        assert(Needle != nullptr && "Needle string is null");
-        return StartsWithI(std::string_view(Haystack), std::string_view(Needle));
+        return TrimLeftCopy(TrimRightCopy(InputView));
     }
 
     //--------------------------------------------------------------------------------
-    bool StartsWithI(const std::wstring_view Haystack, const std::wstring_view Needle) noexcept
+    std::wstring_view TrimCopy(const wchar_t* Input) noexcept
     {
-        return Needle.size() <= Haystack.size() && CompareI(Haystack.substr(0, Needle.size()), Needle) == 0;
+        assert(Input != nullptr && "Input wide string is null");
+        return TrimCopy(std::wstring_view(Input));
     }
 
     //--------------------------------------------------------------------------------
-    bool StartsWithI(const wchar_t* Haystack, const wchar_t* Needle) noexcept
+    void Trim(std::wstring& Str) noexcept
     {
-        assert(Haystack != nullptr && "Haystack wide string is null");
-        assert(Needle != nullptr && "Needle wide string is null");
-        return StartsWithI(std::wstring_view(Haystack), std::wstring_view(Needle));
+        Str = std::wstring(TrimCopy(Str));
     }
 
     //--------------------------------------------------------------------------------
-    bool EndsWithI(const std::string_view Haystack, const std::string_view Needle) noexcept
+    std::vector<std::string_view> Split(const std::string_view InputView, const char Delim) noexcept
     {
-        return Needle.size() <= Haystack.size() && CompareI(Haystack.substr(Haystack.size() - Needle.size()), Needle) == 0;
+        std::vector<std::string_view> Result;
+        ActiveKernels().m_pSplit(InputView, Delim, Result);
+        return Result;
     }
 
     //--------------------------------------------------------------------------------
-    bool EndsWithI(const char* Haystack, const char* Needle) noexcept
+    std::vector<std::string_view> Split(const char* Input, const char Delim) noexcept
     {
-        assert(Haystack != nullptr && "Haystack string is null");
-        assert(Needle != nullptr && "Needle string is null");
-        return EndsWithI(std::string_view(Haystack), std::string_view(Needle));
+        assert(Input != nullptr && "Input string is null");
+        return Split(std::string_view(Input), Delim);
     }
 
     //--------------------------------------------------------------------------------
-    bool EndsWithI(const std::wstring_view Haystack, const std::wstring_view Needle) noexcept
+    std::vector<std::string_view> Split(const std::string_view InputView, const std::string_view Delim) noexcept
     {
-        return Needle.size() <= Haystack.size() && CompareI(Haystack.substr(Haystack.size() - Needle.size()), Needle) == 0;
+        std::vector<std::string_view> Result;
+        const Finder Searcher(Delim);
+        std::size_t Start = 0;
+        std::size_t Pos = 0;
+        while ((Pos = Searcher.Find(InputView, Start)) != std::string_view::npos)
+        {
+            Result.push_back(InputView.substr(Start, Pos - Start));
+            Start = Pos + Delim.size();
+        }
+        Result.push_back(InputView.substr(Start));
+        return Result;
     }
 
     //--------------------------------------------------------------------------------
-    bool EndsWithI(const wchar_t* Haystack, const wchar_t* Needle) noexcept
+    std::vector<std::string_view> Split(const char* Input, const char* Delim) noexcept
     {
-        assert(Haystack != nullptr && "Haystack wide string is null");
-        assert(Needle != nullptr && "Needle wide string is null");
-        return EndsWithI(std::wstring_view(Haystack), std::wstring_view(Needle));
+        assert(Input != nullptr && "Input string is null");
+        assert(Delim != nullptr && "Delimiter string is null");
+        return Split(std::string_view(Input), std::string_view(Delim));
     }
 
     //--------------------------------------------------------------------------------
-    bool ContainsI(const std::string_view Haystack, const std::string_view Needle) noexcept
+    std::vector<std::wstring_view> Split(const std::wstring_view InputView, const wchar_t Delim) noexcept
     {
-        if ( Needle.empty() ) return true;
-        return findI(Haystack, Needle) != std::string::npos;
+        std::vector<std::wstring_view> Result;
+        ActiveKernels().m_pSplitW(InputView, Delim, Result);
+        return Result;
     }
 
     //--------------------------------------------------------------------------------
-    bool ContainsI(const char* Haystack, const char* Needle) noexcept
+    std::vector<std::wstring_view> Split(const wchar_t* Input, const wchar_t Delim) noexcept
     {
-        assert(Haystack != nullptr && "Haystack string is null");
-        assert(Needle != nullptr && "Needle string is null");
-        return ContainsI(std::string_view(Haystack), std::string_view(Needle));
+        assert(Input != nullptr && "Input wide string is null");
+        return Split(std::wstring_view(Input), Delim);
     }
 
     //--------------------------------------------------------------------------------
-    bool ContainsI(const std::wstring_view Haystack, const std::wstring_view Needle) noexcept
+    std::vector<std::wstring_view> Split(const std::wstring_view InputView, const std::wstring_view Delim) noexcept
     {
-        if (Needle.empty()) return true;
-        return findI(Haystack, Needle) != std::wstring::npos;
+        std::vector<std::wstring_view> Result;
+        std::size_t Start = 0;
+        std::size_t Pos = 0;
+        while ((Pos = InputView.find(Delim, Start)) != std::wstring_view::npos)
+        {
+            Result.push_back(InputView.substr(Start, Pos - Start));
+            Start = Pos + Delim.size();
+        }
+        Result.push_back(InputView.substr(Start));
+        return Result;
     }
 
     //--------------------------------------------------------------------------------
-    bool ContainsI(const wchar_t* Haystack, const wchar_t* Needle) noexcept
+    std::vector<std::wstring_view> Split(const wchar_t* Input, const wchar_t* Delim) noexcept
     {
-        assert(Haystack != nullptr && "Haystack wide string is null");
-        assert(Needle != nullptr && "Needle wide string is null");
-        return ContainsI(std::wstring_view(Haystack), std::wstring_view(Needle));
+        assert(Input != nullptr && "Input wide string is null");
+        assert(Delim != nullptr && "Delimiter wide string is null");
+        return Split(std::wstring_view(Input), std::wstring_view(Delim));
     }
 
     //--------------------------------------------------------------------------------
-    std::string_view TrimLeftCopy(const std::string_view InputView) noexcept
+    template< typename T_CHAR >
+    std::size_t BasicSplitRange<T_CHAR>::iterator::ScanDelimiter(const std::size_t From) noexcept
     {
-        if constexpr (optimized_sse_v)
+        const view Input = m_pRange->m_Input;
+        for (std::size_t Pos = std::max(From, m_Next); Pos < Input.size(); Pos = m_Next)
         {
-            // SSE optimized whitespace skip
-            const std::size_t Len = InputView.size();
-            const char* Data = InputView.data();
-            __m128i White = _mm_set_epi8(0, 0, 0, 0, 0, 0, 0, 0, 0, '\r', '\n', '\t', ' ', 0, 0, 0);
-            std::size_t i = 0;
-            for (; i < Len / 16 * 16; i += 16)
-            {
-                __m128i V = _mm_loadu_si128(reinterpret_cast<const __m128i*>(Data + i));
-                __m128i Eq = _mm_cmpeq_epi8(V, White);
-                int Mask = _mm_movemask_epi8(Eq);
-                if (Mask != 0xFFFF)
-                {
+            if constexpr (std::is_same_v<T_CHAR, char>) m_Mask = ActiveKernels().m_pDelimMask(Input.data(), Input.size(), m_pRange->m_First, Pos);
+            else                                        m_Mask = ActiveKernels().m_pDelimMaskW(Input.data(), Input.size(), m_pRange->m_First, Pos);
+            m_Base = Pos;
+            m_Next = Pos + 64;
 
-                #ifdef _MSC_VER
-                    unsigned long Index;
-                    if (_BitScanForward(&Index, ~static_cast<unsigned long>(Mask)))
-                    {
-                        i += Index;
-                    }
-                    else
-                    {
-                        i = Len; // No non-whitespace found
-                    }
-                #else
-                    i += __builtin_ctz(~Mask);
-                #endif
+            const std::size_t Found = PopDelimiter(From);
+            if (Found != std::string::npos) return Found;
+        }
+        return Input.size();
+    }
 
-                    return InputView.substr(i);
-                }
-            }
-            for (; i < Len; ++i)
+    template class BasicSplitRange<char>;
+    template class BasicSplitRange<wchar_t>;
+
+    //--------------------------------------------------------------------------------
+    namespace
+    {
+        template< typename T_CHAR >
+        std::size_t CountDelimiters(const std::basic_string_view<T_CHAR> InputView, const T_CHAR Delim) noexcept
+        {
+            std::size_t Count = 0;
+            for (std::size_t Pos = 0; Pos < InputView.size(); Pos += 64)
             {
-                if (InputView[i] != ' ' && InputView[i] != '\t' && InputView[i] != '\n' && InputView[i] != '\r')
-                {
-                    return InputView.substr(i);
-                }
+                if constexpr (std::is_same_v<T_CHAR, char>) Count += static_cast<std::size_t>(std::popcount(ActiveKernels().m_pDelimMask(InputView.data(), InputView.size(), Delim, Pos)));
+                else                                        Count += static_cast<std::size_t>(std::popcount(ActiveKernels().m_pDelimMaskW(InputView.data(), InputView.size(), Delim, Pos)));
             }
-            return {};
+            return Count;
         }
-        else
+
+        // Fills the span from a lazy split, once it is full the rest of the parts are only counted
+        template< typename T_CHAR, typename T_DELIM >
+        std::size_t SplitIntoParts(const std::span<std::basic_string_view<T_CHAR>> Parts, const std::basic_string_view<T_CHAR> InputView, const T_DELIM Delim) noexcept
         {
-            std::size_t i = 0;
-            while (i < InputView.size() && (InputView[i] == ' ' || InputView[i] == '\t' || InputView[i] == '\n' || InputView[i] == '\r'))
+            const BasicSplitRange<T_CHAR> Range(InputView, Delim);
+            std::size_t                   Count = 0;
+            for (auto It = Range.begin(); It != Range.end(); ++It)
             {
-                ++i;
+                if (Count == Parts.size()) return Count + CountSplits(InputView.substr(static_cast<std::size_t>((*It).data() - InputView.data())), Delim);
+                Parts[Count++] = *It;
             }
-            return InputView.substr(i);
+            return Count;
         }
     }
 
     //--------------------------------------------------------------------------------
-    std::string_view TrimLeftCopy(const char* Input) noexcept
+    std::size_t CountSplits(const std::string_view InputView, const char Delim) noexcept
     {
-        assert(Input != nullptr && "Input string is null");
-        return TrimLeftCopy(std::string_view(Input));
+        return CountDelimiters(InputView, Delim) + 1;
     }
 
     //--------------------------------------------------------------------------------
-    void TrimLeft(std::string& Str) noexcept
+    std::size_t CountSplits(const std::string_view InputView, const std::string_view Delim) noexcept
     {
-        Str = Str.substr(TrimLeftCopy(Str).data() - Str.data());
+        assert(!Delim.empty() && "Delimiter string is empty");
+        return Count(InputView, Delim) + 1;
     }
 
     //--------------------------------------------------------------------------------
-    std::string_view TrimRightCopy(const std::string_view InputView) noexcept
+    std::size_t CountSplits(const std::wstring_view InputView, const wchar_t Delim) noexcept
     {
-        if constexpr (optimized_sse_v)
-        {
-            // SSE optimized reverse whitespace skip
-            const std::size_t Len = InputView.size();
-            const char* Data = InputView.data();
-            __m128i White = _mm_set_epi8(0, 0, 0, 0, 0, 0, 0, 0, 0, '\r', '\n', '\t', ' ', 0, 0, 0);
-            std::size_t i = Len;
-            for (; i > 16; i -= 16)
-            {
-                __m128i V = _mm_loadu_si128(reinterpret_cast<const __m128i*>(Data + i - 16));
-                __m128i Eq = _mm_cmpeq_epi8(V, White);
-                int Mask = _mm_movemask_epi8(Eq);
-                if (Mask != 0xFFFF)
-                {
-                #ifdef _MSC_VER
-                    unsigned long Index;
-                    if (_BitScanReverse(&Index, ~static_cast<unsigned long>(Mask)))
-                    {
-                        i -= 16 - (Index / 8);
-                    }
-                    else
-                    {
-                        i = 0; // No non-whitespace found
-                    }
-                #else
-                    i -= 16 - __builtin_clz(~Mask) / 8;
-                #endif
-
-                    return InputView.substr(0, i);
-                }
-            }
-            while (i > 0 && (InputView[i - 1] == ' ' || InputView[i - 1] == '\t' || InputView[i - 1] == '\n' || InputView[i - 1] == '\r'))
-            {
-                --i;
-            }
-            return InputView.substr(0, i);
-        }
-        else
-        {
-            std::size_t i = InputView.size();
-            while (i > 0 && (InputView[i - 1] == ' ' || InputView[i - 1] == '\t' || InputView[i - 1] == '\n' || InputView[i - 1] == '\r'))
-            {
-                --i;
-            }
-            return InputView.substr(0, i);
-        }
+        return CountDelimiters(InputView, Delim) + 1;
     }
 
     //--------------------------------------------------------------------------------
-    std::string_view TrimRightCopy(const char* Input) noexcept
+    std::size_t CountSplits(const std::wstring_view InputView, const std::wstring_view Delim) noexcept
     {
-        assert(Input != nullptr && "Input string is null");
-        return TrimRightCopy(std::string_view(Input));
+        return static_cast<std::size_t>(std::ranges::distance(SplitRangeW(InputView, Delim)));
     }
 
     //--------------------------------------------------------------------------------
-    void TrimRight(std::string& Str) noexcept
+    std::size_t SplitInto(const std::span<std::string_view> Parts, const std::string_view InputView, const char Delim) noexcept
     {
-        Str.erase(TrimRightCopy(Str).size());
+        return SplitIntoParts(Parts, InputView, Delim);
     }
 
     //--------------------------------------------------------------------------------
-    std::string_view TrimCopy(const std::string_view InputView) noexcept
+    std::size_t SplitInto(const std::span<std::string_view> Parts, const std::string_view InputView, const std::string_view Delim) noexcept
     {
-        return TrimLeftCopy(TrimRightCopy(InputView));
+        return SplitIntoParts(Parts, InputView, Delim);
     }
 
     //--------------------------------------------------------------------------------
-    std::string_view TrimCopy(const char* Input) noexcept
+    std::size_t SplitInto(const std::span<std::wstring_view> Parts, const std::wstring_view InputView, const wchar_t Delim) noexcept
     {
-        assert(Input != nullptr && "Input string is null");
-        return TrimCopy(std::string_view(Input));
+        return SplitIntoParts(Parts, InputView, Delim);
     }
 
     //--------------------------------------------------------------------------------
-    void Trim(std::string& Str) noexcept
+    std::size_t SplitInto(const std::span<std::wstring_view> Parts, const std::wstring_view InputView, const std::wstring_view Delim) noexcept
     {
-        Str = std::string(TrimCopy(Str));
+        return SplitIntoParts(Parts, InputView, Delim);
     }
 
     //--------------------------------------------------------------------------------
-    std::wstring_view TrimLeftCopy(const std::wstring_view InputView) noexcept
+    // CharSet
+    //--------------------------------------------------------------------------------
+    namespace
     {
-        std::size_t i = 0;
-        while (i < InputView.size() && (InputView[i] == L' ' || InputView[i] == L'\t' || InputView[i] == L'\n' || InputView[i] == L'\r'))
+        template< typename T_CHAR >
+        std::uint64_t SetMask(const std::uint8_t* pTables, const std::basic_string_view<T_CHAR> Str, const bool bNegate, std::size_t& Pos) noexcept
         {
-            ++i;
+            if constexpr (std::is_same_v<T_CHAR, char>) return ActiveKernels().m_pSetMask(pTables, Str.data(), Str.size(), bNegate, Pos);
+            else                                        return ActiveKernels().m_pSetMaskW(pTables, Str.data(), Str.size(), bNegate, Pos);
         }
-        return InputView.substr(i);
-    }
 
-    //--------------------------------------------------------------------------------
-    std::wstring_view TrimLeftCopy(const wchar_t* Input) noexcept
-    {
-        assert(Input != nullptr && "Input wide string is null");
-        return TrimLeftCopy(std::wstring_view(Input));
+        template< typename T_CHAR >
+        std::size_t SetFind(const std::uint8_t* pTables, const std::basic_string_view<T_CHAR> Str, std::size_t Pos, const bool bNegate) noexcept
+        {
+            if (Pos >= Str.size()) return std::string::npos;
+            const std::uint64_t Mask = SetMask(pTables, Str, bNegate, Pos);
+            return Mask ? Pos + static_cast<std::size_t>(std::countr_zero(Mask)) : std::string::npos;
+        }
+
+        template< typename T_CHAR >
+        std::size_t SetRFind(const std::uint8_t* pTables, const std::basic_string_view<T_CHAR> Str, const std::size_t Pos) noexcept
+        {
+            const std::size_t End = std::min(Pos, Str.size() - 1) + 1;
+            if (Str.empty()) return std::string::npos;
+            if constexpr (std::is_same_v<T_CHAR, char>) return ActiveKernels().m_pSetRFind(pTables, Str.data(), End);
+            else                                        return ActiveKernels().m_pSetRFindW(pTables, Str.data(), End);
+        }
+
+        // Same as Split for each of the delimiter characters, one window mask gives the parts of 64 characters
+        template< typename T_CHAR >
+        std::vector<std::basic_string_view<T_CHAR>> SetSplit(const std::uint8_t* pTables, const std::basic_string_view<T_CHAR> InputView) noexcept
+        {
+            std::vector<std::basic_string_view<T_CHAR>> Result;
+            std::size_t                                 Start = 0;
+            for (std::size_t Pos = 0; Pos < InputView.size(); Pos += 64)
+            {
+                EmitSplitParts(InputView, Pos, SetMask(pTables, InputView, false, Pos), Start, Result);
+            }
+            Result.push_back(InputView.substr(Start));
+            return Result;
+        }
     }
 
     //--------------------------------------------------------------------------------
-    void TrimLeft(std::wstring& Str) noexcept
+    CharSet::CharSet(const std::string_view Chars) noexcept
     {
-        Str = Str.substr(TrimLeftCopy(Str).data() - Str.data());
+        for (const char C : Chars)
+        {
+            const auto U = static_cast<std::uint8_t>(C);
+            m_Tables[(U >> 7) * 16 + (U & 15)] |= static_cast<std::uint8_t>(1u << ((U >> 4) & 7));
+        }
     }
 
     //--------------------------------------------------------------------------------
-    std::wstring_view TrimRightCopy(const std::wstring_view InputView) noexcept
+    CharSet::CharSet(const std::wstring_view Chars) noexcept
     {
-        std::size_t i = InputView.size();
-        while (i > 0 && (InputView[i - 1] == L' ' || InputView[i - 1] == L'\t' || InputView[i - 1] == L'\n' || InputView[i - 1] == L'\r'))
+        for (const wchar_t C : Chars)
         {
-            --i;
+            const auto U = static_cast<std::make_unsigned_t<wchar_t>>(C);
+            if (U < 256)                                            m_Tables[(U >> 7) * 16 + (U & 15)] |= static_cast<std::uint8_t>(1u << ((U >> 4) & 7));
+            else if (std::ranges::find(m_Wide, C) == m_Wide.end()) m_Wide.push_back(C);
         }
-        return InputView.substr(0, i);
     }
 
     //--------------------------------------------------------------------------------
-    std::wstring_view TrimRightCopy(const wchar_t* Input) noexcept
+    bool CharSet::Contains(const char C) const noexcept
     {
-        assert(Input != nullptr && "Input wide string is null");
-        return TrimRightCopy(std::wstring_view(Input));
+        return InSet(m_Tables, C);
     }
 
     //--------------------------------------------------------------------------------
-    void TrimRight(std::wstring& Str) noexcept
+    bool CharSet::Contains(const wchar_t C) const noexcept
     {
-        Str.erase(TrimRightCopy(Str).size());
+        return InSet(m_Tables, C) || std::ranges::find(m_Wide, C) != m_Wide.end();
     }
 
     //--------------------------------------------------------------------------------
-    std::wstring_view TrimCopy(const std::wstring_view InputView) noexcept
+    std::size_t CharSet::Find(const std::string_view Str, const std::size_t Pos) const noexcept
     {
-        return TrimLeftCopy(TrimRightCopy(InputView));
+        return SetFind(m_Tables, Str, Pos, false);
     }
 
     //--------------------------------------------------------------------------------
-    std::wstring_view TrimCopy(const wchar_t* Input) noexcept
+    std::size_t CharSet::Find(const std::wstring_view Str, std::size_t Pos) const noexcept
     {
-        assert(Input != nullptr && "Input wide string is null");
-        return TrimCopy(std::wstring_view(Input));
+        if (m_Wide.empty()) return SetFind(m_Tables, Str, Pos, false);
+        for (; Pos < Str.size(); ++Pos)
+        {
+            if (Contains(Str[Pos])) return Pos;
+        }
+        return std::string::npos;
     }
 
     //--------------------------------------------------------------------------------
-    void Trim(std::wstring& Str) noexcept
+    std::size_t CharSet::FindNot(const std::string_view Str, const std::size_t Pos) const noexcept
     {
-        Str = std::wstring(TrimCopy(Str));
+        return SetFind(m_Tables, Str, Pos, true);
     }
 
     //--------------------------------------------------------------------------------
-    std::vector<std::string_view> Split(const std::string_view InputView, const char Delim) noexcept
+    std::size_t CharSet::FindNot(const std::wstring_view Str, std::size_t Pos) const noexcept
     {
-        if constexpr (optimized_sse_v)
+        if (m_Wide.empty()) return SetFind(m_Tables, Str, Pos, true);
+        for (; Pos < Str.size(); ++Pos)
         {
-            // SSE optimized char search for split
-            std::vector<std::string_view> Result;
-            std::size_t Start = 0;
-            const char* Data = InputView.data();
-            const std::size_t Len = InputView.size();
-            __m128i D = _mm_set1_epi8(Delim);
-            for (std::size_t i = 0; i < Len / 16 * 16; i += 16)
-            {
-                __m128i V = _mm_loadu_si128(reinterpret_cast<const __m128i*>(Data + i));
-                __m128i Eq = _mm_cmpeq_epi8(V, D);
-                int Mask = _mm_movemask_epi8(Eq);
-                while (Mask)
-                {
-                #ifdef _MSC_VER
-                    unsigned long Bit;
-                    if (_BitScanForward(&Bit, static_cast<unsigned long>(Mask)))
-                    {
-                        Result.push_back(InputView.substr(Start, i + Bit - Start));
-                        Start = i + Bit + 1;
-                        Mask ^= (1 << Bit);
-                    }
-                    else
-                    {
-                        break; // No more delimiters in this block
-                    }
-                #else
-                    int Bit = __builtin_ctz(Mask);
-                    Result.push_back(InputView.substr(Start, i + Bit - Start));
-                    Start = i + Bit + 1;
-                    Mask ^= (1 << Bit);
-                #endif
-                }
-            }
-            for (std::size_t i = Len / 16 * 16; i < Len; ++i)
-            {
-                if (InputView[i] == Delim)
-                {
-                    Result.push_back(InputView.substr(Start, i - Start));
-                    Start = i + 1;
-                }
-            }
-            Result.push_back(InputView.substr(Start));
-            return Result;
-        }
-        else
-        {
-            std::vector<std::string_view> Result;
-            std::size_t Start = 0;
-            for (std::size_t i = 0; i < InputView.size(); ++i)
-            {
-                if (InputView[i] == Delim)
-                {
-                    Result.push_back(InputView.substr(Start, i - Start));
-                    Start = i + 1;
-                }
-            }
-            Result.push_back(InputView.substr(Start));
-            return Result;
+            if (!Contains(Str[Pos])) return Pos;
         }
+        return std::string::npos;
     }
 
     //--------------------------------------------------------------------------------
-    std::vector<std::string_view> Split(const char* Input, const char Delim) noexcept
+    std::size_t CharSet::RFind(const std::string_view Str, const std::size_t Pos) const noexcept
     {
-        assert(Input != nullptr && "Input string is null");
-        return Split(std::string_view(Input), Delim);
+        return SetRFind(m_Tables, Str, Pos);
     }
 
     //--------------------------------------------------------------------------------
-    std::vector<std::string_view> Split(const std::string_view InputView, const std::string_view Delim) noexcept
+    std::size_t CharSet::RFind(const std::wstring_view Str, const std::size_t Pos) const noexcept
     {
-        std::vector<std::string_view> Result;
-        std::size_t Start = 0;
-        std::size_t Pos = 0;
-        while ((Pos = InputView.find(Delim, Start)) != std::string_view::npos)
+        if (m_Wide.empty()) return SetRFind(m_Tables, Str, Pos);
+        for (std::size_t i = std::min(Pos, Str.size() - 1) + 1; !Str.empty() && i-- > 0; )
         {
-            Result.push_back(InputView.substr(Start, Pos - Start));
-            Start = Pos + Delim.size();
+            if (Contains(Str[i])) return i;
         }
-        Result.push_back(InputView.substr(Start));
-        return Result;
+        return std::string::npos;
     }
 
     //--------------------------------------------------------------------------------
-    std::vector<std::string_view> Split(const char* Input, const char* Delim) noexcept
+    std::vector<std::string_view> SplitAny(const std::string_view InputView, const CharSet& Delims) noexcept
     {
-        assert(Input != nullptr && "Input string is null");
-        assert(Delim != nullptr && "Delimiter string is null");
-        return Split(std::string_view(Input), std::string_view(Delim));
+        return SetSplit(Delims.m_Tables, InputView);
     }
 
     //--------------------------------------------------------------------------------
-    std::vector<std::wstring_view> Split(const std::wstring_view InputView, const wchar_t Delim) noexcept
+    std::vector<std::wstring_view> SplitAny(const std::wstring_view InputView, const CharSet& Delims) noexcept
     {
+        if (Delims.m_Wide.empty()) return SetSplit(Delims.m_Tables, InputView);
+
         std::vector<std::wstring_view> Result;
-        std::size_t Start = 0;
+        std::size_t                    Start = 0;
         for (std::size_t i = 0; i < InputView.size(); ++i)
         {
-            if (InputView[i] == Delim)
+            if (Delims.Contains(InputView[i]))
             {
                 Result.push_back(InputView.substr(Start, i - Start));
                 Start = i + 1;
@@ -951,73 +5278,182 @@ namespace xstrtool
     }
 
     //--------------------------------------------------------------------------------
-    std::vector<std::wstring_view> Split(const wchar_t* Input, const wchar_t Delim) noexcept
+    // CsvReader
+    //--------------------------------------------------------------------------------
+    std::string_view csv_field::Value(std::string& Scratch) const noexcept
     {
-        assert(Input != nullptr && "Input wide string is null");
-        return Split(std::wstring_view(Input), Delim);
+        if (!m_bEscaped) return m_Raw;
+
+        Scratch.clear();
+        for (std::size_t i = 0; i < m_Raw.size(); ++i)
+        {
+            Scratch += m_Raw[i];
+            if (m_Raw[i] == '"' && i + 1 < m_Raw.size() && m_Raw[i + 1] == '"') ++i;
+        }
+        return Scratch;
     }
 
     //--------------------------------------------------------------------------------
-    std::vector<std::wstring_view> Split(const std::wstring_view InputView, const std::wstring_view Delim) noexcept
+    std::size_t CsvReader::NextStructural() noexcept
     {
-        std::vector<std::wstring_view> Result;
-        std::size_t Start = 0;
-        std::size_t Pos = 0;
-        while ((Pos = InputView.find(Delim, Start)) != std::wstring_view::npos)
+        while (m_Mask == 0)
         {
-            Result.push_back(InputView.substr(Start, Pos - Start));
-            Start = Pos + Delim.size();
+            if (m_Next >= m_Buffer.size()) return m_Buffer.size();
+            std::size_t Pos = m_Next;
+            m_Mask = ActiveKernels().m_pCsvMask(m_Buffer.data(), m_Buffer.size(), m_Delimiter, Pos, m_Inside);
+            m_Base = Pos;
+            m_Next = Pos + 64;
         }
-        Result.push_back(InputView.substr(Start));
-        return Result;
+        const std::size_t Pos = m_Base + static_cast<std::size_t>(std::countr_zero(m_Mask));
+        m_Mask &= m_Mask - 1;
+        return Pos;
     }
 
     //--------------------------------------------------------------------------------
-    std::vector<std::wstring_view> Split(const wchar_t* Input, const wchar_t* Delim) noexcept
+    bool CsvReader::Next(std::span<const csv_field>& Record) noexcept
     {
-        assert(Input != nullptr && "Input wide string is null");
-        assert(Delim != nullptr && "Delimiter wide string is null");
-        return Split(std::wstring_view(Input), std::wstring_view(Delim));
+        if (m_Pos >= m_Buffer.size()) return false;
+
+        m_Fields.clear();
+        for (std::size_t Start = m_Pos; ; )
+        {
+            const std::size_t End        = NextStructural();
+            const bool        bRecordEnd = End == m_Buffer.size() || m_Buffer[End] == '\n';
+
+            csv_field& Field = m_Fields.emplace_back();
+            Field.m_Raw = { m_Buffer.data() + Start, End - Start };
+            if (bRecordEnd && Field.m_Raw.ends_with('\r')) Field.m_Raw.remove_suffix(1);
+            if (Field.m_Raw.starts_with('"'))
+            {
+                Field.m_bQuoted = true;
+                Field.m_Raw.remove_prefix(1);
+                if (Field.m_Raw.ends_with('"')) Field.m_Raw.remove_suffix(1);
+                Field.m_bEscaped = Field.m_Raw.find('"') != std::string_view::npos;
+            }
+
+            if (bRecordEnd)
+            {
+                m_Pos = std::min(End + 1, m_Buffer.size());
+                break;
+            }
+            Start = End + 1;
+        }
+
+        Record = m_Fields;
+        return true;
     }
 
     //--------------------------------------------------------------------------------
-    std::string ReplaceCopy(const std::string_view Haystack, const std::string_view Needle, const std::string_view Replacement) noexcept
+    // SplitLinesParallel
+    //--------------------------------------------------------------------------------
+    namespace
     {
-        if constexpr (optimized_sse_v)
+        // Bytes of a chunk of SplitLinesParallel, it and its line views stay in the L2 cache of its worker
+        constexpr std::size_t SplitLinesChunk_v = 256 * 1024;
+    }
+
+    //--------------------------------------------------------------------------------
+    std::size_t SplitLinesParallel(const std::string_view Buffer, const std::function<void(const line_batch& Batch)>& Sink)
+    {
+        if (Buffer.empty()) return 0;
+
+        // First pass: the new lines of each chunk, their prefix sum is the number of new lines before each chunk
+        const std::size_t        nChunks = (Buffer.size() + SplitLinesChunk_v - 1) / SplitLinesChunk_v;
+        std::vector<std::size_t> NewLines(nChunks + 1);
+        ParallelFor(nChunks, 1, [&](const std::size_t Begin, const std::size_t End) noexcept
         {
-            // SSE optimized find for replace
-            if (Needle.empty()) return std::string(Haystack);
-            std::string Result;
-            std::size_t Pos = 0;
-            std::size_t LastPos = 0;
-            while ((Pos = Haystack.find(Needle, Pos)) != std::string_view::npos)
+            for (std::size_t c = Begin; c < End; ++c) NewLines[c + 1] = CountDelimiters(Buffer.substr(c * SplitLinesChunk_v, SplitLinesChunk_v), '\n');
+        });
+        std::size_t MaxLines = 0;
+        for (std::size_t c = 0; c < nChunks; ++c)
+        {
+            MaxLines         = std::max(MaxLines, NewLines[c + 1] + 1);
+            NewLines[c + 1] += NewLines[c];
+        }
+
+        // Second pass: each chunk gives the lines that start in it (at most its new lines plus one), the line
+        // view storage of every worker is reserved here so the workers never allocate. ParallelFor does not
+        // start more workers than there are chunks
+        std::vector<std::vector<std::string_view>> Scratch(std::min<std::size_t>(nChunks, std::max(1u, std::thread::hardware_concurrency())));
+        for (auto& Lines : Scratch) Lines.reserve(MaxLines);
+        ParallelFor(nChunks, 1, [&](const std::size_t Worker, const std::size_t Begin, const std::size_t End) noexcept
+        {
+            assert(Worker < Scratch.size());
+            auto& Lines = Scratch[Worker];
+            for (std::size_t c = Begin; c < End; ++c)
             {
-                Result.append(Haystack, LastPos, Pos - LastPos);
-                Result.append(Replacement);
-                Pos += Needle.size();
-                LastPos = Pos;
+                const std::size_t ChunkBegin = c * SplitLinesChunk_v;
+                const std::size_t ChunkEnd   = std::min(ChunkBegin + SplitLinesChunk_v, Buffer.size());
+                std::size_t       Start      = ChunkBegin;
+                std::size_t       FirstLine  = NewLines[c] + 1;
+
+                // The line that crosses into the chunk belongs to the chunk where it starts
+                if (c > 0 && Buffer[ChunkBegin - 1] != '\n')
+                {
+                    const std::size_t NewLine = Buffer.substr(ChunkBegin, ChunkEnd - ChunkBegin).find('\n');
+                    if (NewLine == std::string_view::npos) continue;
+                    Start = ChunkBegin + NewLine + 1;
+                    ++FirstLine;
+                }
+
+                Lines.clear();
+                for (const std::string_view Part : SplitRange(Buffer.substr(Start, ChunkEnd - Start), '\n'))
+                {
+                    std::string_view Line = Part;
+
+                    // The last part goes on to the end of its line in the next chunks
+                    const std::size_t LineBegin = static_cast<std::size_t>(Part.data() - Buffer.data());
+                    if (LineBegin + Part.size() == ChunkEnd)
+                    {
+                        if (LineBegin == ChunkEnd) break;
+                        Line = Buffer.substr(LineBegin, std::min(Buffer.find('\n', ChunkEnd), Buffer.size()) - LineBegin);
+                    }
+
+                    if (Line.ends_with('\r')) Line.remove_suffix(1);
+                    assert(Lines.size() < Lines.capacity());
+                    Lines.push_back(Line);
+                }
+
+                if (!Lines.empty()) Sink({ Worker, FirstLine, Lines });
             }
-            Result.append(Haystack.substr(LastPos));
-            return Result;
-        }
-        else
+        });
+
+        return NewLines[nChunks] + (Buffer.back() != '\n');
+    }
+
+    //--------------------------------------------------------------------------------
+    namespace
+    {
+        // The matches are counted first so the result is written once at its final size
+        template< bool T_IGNORE_CASE_V >
+        std::string ReplaceAllCopy(const std::string_view Haystack, const BasicFinder<T_IGNORE_CASE_V>& Searcher, const std::string_view Replacement) noexcept
         {
-            if (Needle.empty()) return std::string(Haystack);
+            const std::size_t Count = Searcher.Count(Haystack);
+            if (Count == 0) return std::string(Haystack);
+
             std::string Result;
-            std::size_t Pos = 0;
-            std::size_t LastPos = 0;
-            while ((Pos = Haystack.find(Needle, Pos)) != std::string_view::npos)
+            ResizeAndOverwrite(Result, Haystack.size() - Count * Searcher.size() + Count * Replacement.size(), [&](char* pData, const std::size_t) noexcept
             {
-                Result.append(Haystack, LastPos, Pos - LastPos);
-                Result.append(Replacement);
-                Pos += Needle.size();
-                LastPos = Pos;
-            }
-            Result.append(Haystack.substr(LastPos));
+                std::size_t LastPos = 0;
+                for (std::size_t Pos = Searcher.Find(Haystack); Pos != std::string::npos; Pos = Searcher.Find(Haystack, LastPos))
+                {
+                    pData   = std::copy_n(Haystack.data() + LastPos, Pos - LastPos, pData);
+                    pData   = std::copy_n(Replacement.data(), Replacement.size(), pData);
+                    LastPos = Pos + Searcher.size();
+                }
+                std::copy_n(Haystack.data() + LastPos, Haystack.size() - LastPos, pData);
+            });
             return Result;
         }
     }
 
+    //--------------------------------------------------------------------------------
+    std::string ReplaceCopy(const std::string_view Haystack, const std::string_view Needle, const std::string_view Replacement) noexcept
+    {
+        if (Needle.empty()) return std::string(Haystack);
+        return ReplaceAllCopy(Haystack, Finder(Needle), Replacement);
+    }
+
     //--------------------------------------------------------------------------------
     std::string ReplaceCopy(const char* Haystack, const char* Needle, const char* Replacement) noexcept
     {
@@ -1030,7 +5466,30 @@ namespace xstrtool
     //--------------------------------------------------------------------------------
     void Replace(std::string& Str, const std::string_view Needle, const std::string_view Replacement) noexcept
     {
-        Str = ReplaceCopy(Str, Needle, Replacement);
+        // A replacement that is not longer than the needle is done in place, the writes stay behind the search
+        // position (the finder keeps its own copy of the needle, a replacement inside Str takes the copy path)
+        const std::less<const char*> Less;
+        const bool bAliased = !Less(Replacement.data(), Str.data()) && Less(Replacement.data(), Str.data() + Str.size());
+        if (Needle.empty() || Replacement.size() > Needle.size() || bAliased)
+        {
+            Str = ReplaceCopy(Str, Needle, Replacement);
+            return;
+        }
+
+        const Finder Searcher(Needle);
+        std::size_t  Write = 0;
+        std::size_t  Read  = 0;
+        for (std::size_t Pos; (Pos = Searcher.Find(Str, Read)) != std::string::npos; Read = Pos + Needle.size())
+        {
+            if (Write != Read) std::memmove(Str.data() + Write, Str.data() + Read, Pos - Read);
+            Write += Pos - Read;
+            std::copy_n(Replacement.data(), Replacement.size(), Str.data() + Write);
+            Write += Replacement.size();
+        }
+        if (Write == Read) return;
+
+        std::memmove(Str.data() + Write, Str.data() + Read, Str.size() - Read);
+        Str.resize(Write + Str.size() - Read);
     }
 
     //--------------------------------------------------------------------------------
@@ -1070,18 +5529,7 @@ namespace xstrtool
     std::string ReplaceICopy(const std::string_view Haystack, const std::string_view Needle, const std::string_view Replacement) noexcept
     {
         if (Needle.empty()) return std::string(Haystack);
-        std::string Result;
-        std::size_t Pos = 0;
-        std::size_t LastPos = 0;
-        while ((Pos = findI(Haystack, Needle, Pos)) != std::string::npos)
-        {
-            Result.append(Haystack, LastPos, Pos - LastPos);
-            Result.append(Replacement);
-            Pos += Needle.size();
-            LastPos = Pos;
-        }
-        Result.append(Haystack.substr(LastPos));
-        return Result;
+        return ReplaceAllCopy(Haystack, FinderI(Needle), Replacement);
     }
 
     //--------------------------------------------------------------------------------
@@ -1275,37 +5723,278 @@ namespace xstrtool
         std::wstring Result;
         if (IsDrive)
         {
-            Result = std::wstring(Drive);
-            if (!ResultParts.empty()) Result += L'/';
+            Result = std::wstring(Drive);
+            if (!ResultParts.empty()) Result += L'/';
+        }
+        else if (IsAbsolute)
+        {
+            Result = L"/";
+        }
+        bool First = true;
+        for (const auto& Part : ResultParts)
+        {
+            if (!First) Result += L'/';
+            First = false;
+            Result.append(Part);
+        }
+        if (Result.empty() && !IsAbsolute) return L".";
+        return Result;
+    }
+
+    //--------------------------------------------------------------------------------
+    std::wstring PathNormalizeCopy(const wchar_t* Path) noexcept
+    {
+        assert(Path != nullptr && "Path wide string is null");
+        return PathNormalizeCopy(std::wstring_view(Path));
+    }
+
+    //--------------------------------------------------------------------------------
+    void PathNormalize(std::wstring& Str) noexcept
+    {
+        Str = PathNormalizeCopy(Str);
+    }
+
+    //--------------------------------------------------------------------------------
+    // Glob / GlobI
+    //--------------------------------------------------------------------------------
+    namespace
+    {
+        // Start of the separator that ends the component at Pos (the end of the path for the last component)
+        std::size_t ComponentEnd(const std::string_view Path, const std::size_t Pos) noexcept
+        {
+            return std::min(Path.find_first_of("/\\", Pos), Path.size());
+        }
+    }
+
+    //--------------------------------------------------------------------------------
+    template< bool T_IGNORE_CASE_V >
+    BasicGlob<T_IGNORE_CASE_V>::BasicGlob(const std::string_view Pattern) noexcept
+    {
+        const auto Fold = [](const char C) { return T_IGNORE_CASE_V ? ToLower(C) : C; };
+
+        for (std::size_t Start = 0; Start <= Pattern.size(); )
+        {
+            const std::size_t      End  = ComponentEnd(Pattern, Start);
+            const std::string_view Text = Pattern.substr(Start, End - Start);
+            Start = End + 1;
+
+            // Consecutive "**" components match the same as one
+            if (Text == "**")
+            {
+                if (m_Components.empty() || !m_Components.back().m_bGlobStar) m_Components.push_back({ 0, 0, false, false, true });
+                continue;
+            }
+
+            component Component{ static_cast<std::uint32_t>(m_Pieces.size()), 0, !Text.empty() && Text[0] == '*', false, false };
+            std::size_t PieceStart = m_Elements.size();
+
+            // Closes the piece of the elements added since PieceStart, its finder looks for its longest run of literals
+            const auto EndPiece = [&]()
+            {
+                if (m_Elements.size() == PieceStart) return;
+
+                std::size_t BestOffset = 0, BestLen = 0;
+                for (std::size_t i = PieceStart; i < m_Elements.size(); )
+                {
+                    std::size_t j = i;
+                    while (j < m_Elements.size() && m_Elements[j].m_Kind == element::LITERAL) ++j;
+                    if (j - i > BestLen) { BestOffset = i - PieceStart; BestLen = j - i; }
+                    i = std::max(j, i + 1);
+                }
+
+                std::string Literal;
+                for (std::size_t i = 0; i < BestLen; ++i) Literal += m_Elements[PieceStart + BestOffset + i].m_Char;
+                m_Pieces.push_back({ static_cast<std::uint32_t>(PieceStart), static_cast<std::uint32_t>(m_Elements.size() - PieceStart), static_cast<std::uint32_t>(BestOffset), BasicFinder<T_IGNORE_CASE_V>(Literal) });
+                ++Component.m_PieceCount;
+                PieceStart = m_Elements.size();
+            };
+
+            for (std::size_t i = 0; i < Text.size(); ++i)
+            {
+                Component.m_bTrailingStar = Text[i] == '*';
+                if (Text[i] == '*')
+                {
+                    EndPiece();
+                    continue;
+                }
+                if (Text[i] == '?')
+                {
+                    m_Elements.push_back({ element::ANY, 0, 0 });
+                    continue;
+                }
+
+                // A class needs its closing ']', which can not be the first character of the set
+                std::size_t Close = std::string_view::npos;
+                std::size_t First = i + 1;
+                if (Text[i] == '[')
+                {
+                    if (First < Text.size() && (Text[First] == '!' || Text[First] == '^')) ++First;
+                    Close = (First + 1 < Text.size()) ? Text.find(']', First + 1) : std::string_view::npos;
+                }
+                if (Close == std::string_view::npos)
+                {
+                    m_Elements.push_back({ element::LITERAL, Fold(Text[i]), 0 });
+                    continue;
+                }
+
+                std::uint64_t Bits[4] = {};
+                for (std::size_t k = First; k < Close; ++k)
+                {
+                    const auto Low  = static_cast<unsigned char>(Text[k]);
+                    const auto High = (k + 2 < Close && Text[k + 1] == '-') ? static_cast<unsigned char>(Text[k += 2]) : Low;
+                    for (unsigned C = Low; C <= High; ++C)
+                    {
+                        const auto Folded = static_cast<unsigned char>(Fold(static_cast<char>(C)));
+                        Bits[Folded >> 6] |= std::uint64_t(1) << (Folded & 63);
+                    }
+                }
+                const bool bNegate = First > i + 1;
+                for (const std::uint64_t Word : Bits) m_Classes.push_back(bNegate ? ~Word : Word);
+                m_Elements.push_back({ element::CLASS, 0, static_cast<std::uint16_t>(m_Classes.size() / 4 - 1) });
+                i = Close;
+            }
+            EndPiece();
+            m_Components.push_back(Component);
+        }
+    }
+
+    //--------------------------------------------------------------------------------
+    template< bool T_IGNORE_CASE_V >
+    bool BasicGlob<T_IGNORE_CASE_V>::PieceAt(const piece& Piece, const std::string_view Str, const std::size_t Pos) const noexcept
+    {
+        for (std::uint32_t i = 0; i < Piece.m_Count; ++i)
+        {
+            const element& Element = m_Elements[Piece.m_First + i];
+            const auto     C       = static_cast<unsigned char>(T_IGNORE_CASE_V ? ToLower(Str[Pos + i]) : Str[Pos + i]);
+            if (Element.m_Kind == element::LITERAL && static_cast<unsigned char>(Element.m_Char) != C) return false;
+            if (Element.m_Kind == element::CLASS && !((m_Classes[Element.m_Class * 4 + (C >> 6)] >> (C & 63)) & 1)) return false;
+        }
+        return true;
+    }
+
+    //--------------------------------------------------------------------------------
+    template< bool T_IGNORE_CASE_V >
+    std::size_t BasicGlob<T_IGNORE_CASE_V>::FindPiece(const piece& Piece, const std::string_view Str, const std::size_t Pos) const noexcept
+    {
+        if (Pos + Piece.m_Count > Str.size()) return std::string::npos;
+
+        // Without literals every position is a candidate
+        if (Piece.m_Finder.size() == 0)
+        {
+            for (std::size_t i = Pos; i + Piece.m_Count <= Str.size(); ++i)
+            {
+                if (PieceAt(Piece, Str, i)) return i;
+            }
+            return std::string::npos;
         }
-        else if (IsAbsolute)
+
+        // The finder skips to the next place where the literal run fits, only those are verified
+        for (std::size_t i = Pos + Piece.m_LiteralOffset; (i = Piece.m_Finder.Find(Str, i)) != std::string::npos; ++i)
         {
-            Result = L"/";
+            const std::size_t Candidate = i - Piece.m_LiteralOffset;
+            if (Candidate + Piece.m_Count > Str.size()) break;
+            if (Piece.m_Finder.size() == Piece.m_Count || PieceAt(Piece, Str, Candidate)) return Candidate;
+            if (i + 1 > Str.size()) break;
         }
-        bool First = true;
-        for (const auto& Part : ResultParts)
+        return std::string::npos;
+    }
+
+    //--------------------------------------------------------------------------------
+    template< bool T_IGNORE_CASE_V >
+    bool BasicGlob<T_IGNORE_CASE_V>::MatchComponent(const component& Component, const std::string_view Str) const noexcept
+    {
+        // The first piece is anchored at the start unless a '*' comes before it, the last one at the end unless
+        // a '*' follows it, and each '*' takes the leftmost place of the next piece
+        std::size_t Pos = 0;
+        for (std::uint32_t p = 0; p < Component.m_PieceCount; ++p)
         {
-            if (!First) Result += L'/';
-            First = false;
-            Result.append(Part);
+            const piece& Piece = m_Pieces[Component.m_FirstPiece + p];
+            const bool   bLast = p + 1 == Component.m_PieceCount;
+            if (p == 0 && !Component.m_bLeadingStar)
+            {
+                if (Piece.m_Count > Str.size() || !PieceAt(Piece, Str, 0)) return false;
+                Pos = Piece.m_Count;
+            }
+            else if (bLast && !Component.m_bTrailingStar)
+            {
+                return Str.size() >= Pos + Piece.m_Count && PieceAt(Piece, Str, Str.size() - Piece.m_Count);
+            }
+            else
+            {
+                const std::size_t Found = FindPiece(Piece, Str, Pos);
+                if (Found == std::string::npos) return false;
+                Pos = Found + Piece.m_Count;
+            }
         }
-        if (Result.empty() && !IsAbsolute) return L".";
-        return Result;
+        return Component.m_bTrailingStar || Pos == Str.size();
     }
 
     //--------------------------------------------------------------------------------
-    std::wstring PathNormalizeCopy(const wchar_t* Path) noexcept
+    template< bool T_IGNORE_CASE_V >
+    bool BasicGlob<T_IGNORE_CASE_V>::MatchRun(std::size_t First, const std::size_t Last, const std::string_view Path, std::size_t& Pos) const noexcept
     {
-        assert(Path != nullptr && "Path wide string is null");
-        return PathNormalizeCopy(std::wstring_view(Path));
+        // Pattern components [First, Last) against the path components that start at Pos, Pos moves past them
+        for (; First < Last; ++First)
+        {
+            const std::size_t End = ComponentEnd(Path, Pos);
+            if (!MatchComponent(m_Components[First], Path.substr(Pos, End - Pos))) return false;
+            Pos = End + 1;
+        }
+        return true;
     }
 
     //--------------------------------------------------------------------------------
-    void PathNormalize(std::wstring& Str) noexcept
+    template< bool T_IGNORE_CASE_V >
+    bool BasicGlob<T_IGNORE_CASE_V>::Match(const std::string_view Path) const noexcept
     {
-        Str = PathNormalizeCopy(Str);
+        const std::size_t nComponents = 1 + static_cast<std::size_t>(std::ranges::count_if(Path, [](const char C) { return C == '/' || C == '\\'; }));
+        const auto        IsGlobStar  = [](const component& Component) { return Component.m_bGlobStar; };
+        const std::size_t FirstStar   = static_cast<std::size_t>(std::ranges::find_if(m_Components, IsGlobStar) - m_Components.begin());
+        std::size_t       Pos         = 0;
+        if (FirstStar == m_Components.size())
+        {
+            return nComponents == m_Components.size() && MatchRun(0, m_Components.size(), Path, Pos);
+        }
+
+        // The components before the first "**" match the start of the path and the ones after the last "**" its end
+        const std::size_t LastStar = m_Components.size() - 1 - static_cast<std::size_t>(std::ranges::find_if(m_Components.rbegin(), m_Components.rend(), IsGlobStar) - m_Components.rbegin());
+        const std::size_t nSuffix  = m_Components.size() - 1 - LastStar;
+        if (nComponents < FirstStar + nSuffix) return false;
+
+        std::size_t SuffixPos = Path.size() + 1;
+        for (std::size_t i = 0; i < nSuffix; ++i)
+        {
+            const std::size_t Separator = (SuffixPos > 1) ? Path.find_last_of("/\\", SuffixPos - 2) : std::string_view::npos;
+            SuffixPos = (Separator == std::string_view::npos) ? 0 : Separator + 1;
+        }
+        if (std::size_t End = SuffixPos; !MatchRun(LastStar + 1, m_Components.size(), Path, End)) return false;
+        if (!MatchRun(0, FirstStar, Path, Pos)) return false;
+
+        // Every group between two "**" takes its leftmost place in the components left in the middle
+        std::size_t Remaining = nComponents - FirstStar - nSuffix;
+        for (std::size_t Begin = FirstStar + 1; Begin < LastStar; )
+        {
+            const std::size_t End = static_cast<std::size_t>(std::find_if(m_Components.begin() + Begin, m_Components.end(), IsGlobStar) - m_Components.begin());
+            for (;;)
+            {
+                if (Remaining < End - Begin) return false;
+                if (std::size_t Next = Pos; MatchRun(Begin, End, Path, Next))
+                {
+                    Pos        = Next;
+                    Remaining -= End - Begin;
+                    break;
+                }
+                Pos = ComponentEnd(Path, Pos) + 1;
+                --Remaining;
+            }
+            Begin = End + 1;
+        }
+        return true;
     }
 
+    template class BasicGlob<false>;
+    template class BasicGlob<true>;
+
     //--------------------------------------------------------------------------------
     std::string FormatTime(const std::chrono::system_clock::time_point Tp, const std::string_view Fmt) noexcept
     {
@@ -1480,6 +6169,18 @@ namespace xstrtool
         return std::hash<std::string_view>{}(Sv);
     }
 
+    //--------------------------------------------------------------------------------
+    std::size_t HashI::operator()(const std::string_view Sv) const noexcept
+    {
+        return static_cast<std::size_t>(ActiveKernels().m_pHashI(Sv.data(), Sv.size()));
+    }
+
+    //--------------------------------------------------------------------------------
+    std::size_t HashI::operator()(const std::wstring_view Sv) const noexcept
+    {
+        return static_cast<std::size_t>(ActiveKernels().m_pHashIW(Sv.data(), Sv.size()));
+    }
+
     //--------------------------------------------------------------------------------
     std::string ToString(const double Num, const int Precision) noexcept
     {
@@ -1750,17 +6451,33 @@ namespace xstrtool
     */
 
     //--------------------------------------------------------------------------------
-    uint32_t CRC32(const std::string_view Sv) noexcept
+    // CRC32 (the zlib/PNG polynomial), one table lookup per byte
+    //--------------------------------------------------------------------------------
+    namespace
     {
-        const uint32_t Polynomial = 0xEDB88320;
-        uint32_t Crc = ~0u;
-        for (char C : Sv)
+        constexpr std::array<std::uint32_t, 256> CRC32Table_v = []
+        {
+            std::array<std::uint32_t, 256> Table{};
+            for (std::uint32_t i = 0; i < 256; ++i)
+            {
+                std::uint32_t Crc = i;
+                for (int j = 0; j < 8; ++j) Crc = (Crc >> 1) ^ ((Crc & 1) ? 0xEDB88320u : 0u);
+                Table[i] = Crc;
+            }
+            return Table;
+        }();
+
+        inline std::uint32_t CRC32Update(std::uint32_t Crc, const char* pData, const std::size_t Len) noexcept
         {
-            Crc ^= static_cast<unsigned char>(C);
-            for (int j = 0; j < 8; ++j)
-                Crc = (Crc >> 1) ^ (-static_cast<int>(Crc & 1) & Polynomial);
+            for (std::size_t i = 0; i < Len; ++i) Crc = CRC32Table_v[(Crc ^ static_cast<unsigned char>(pData[i])) & 0xFF] ^ (Crc >> 8);
+            return Crc;
         }
-        return ~Crc;
+    }
+
+    //--------------------------------------------------------------------------------
+    uint32_t CRC32(const std::string_view Sv) noexcept
+    {
+        return ~CRC32Update(~0u, Sv.data(), Sv.size());
     }
 
     //--------------------------------------------------------------------------------
@@ -1874,6 +6591,130 @@ namespace xstrtool
         return HashStr;
     }
 
+    //--------------------------------------------------------------------------------
+    // Batch helpers
+    //--------------------------------------------------------------------------------
+    namespace
+    {
+        // CRC32 of four strings at a time: the table lookups of a single string form one long dependency
+        // chain, interleaving four independent chains keeps the load units busy
+        template< typename T_STRING >
+        void BatchCRC32Range(const std::span<const T_STRING> Input, const std::span<std::uint32_t> Output, const std::size_t Begin, const std::size_t End) noexcept
+        {
+            std::size_t i = Begin;
+            for (; i + 4 <= End; i += 4)
+            {
+                const char*   pData[4] = { Input[i].data(), Input[i + 1].data(), Input[i + 2].data(), Input[i + 3].data() };
+                std::uint32_t Crc[4]   = { ~0u, ~0u, ~0u, ~0u };
+                const std::size_t Common = std::min({ Input[i].size(), Input[i + 1].size(), Input[i + 2].size(), Input[i + 3].size() });
+                for (std::size_t k = 0; k < Common; ++k)
+                {
+                    for (int l = 0; l < 4; ++l) Crc[l] = CRC32Table_v[(Crc[l] ^ static_cast<unsigned char>(pData[l][k])) & 0xFF] ^ (Crc[l] >> 8);
+                }
+                for (int l = 0; l < 4; ++l) Output[i + l] = ~CRC32Update(Crc[l], pData[l] + Common, Input[i + l].size() - Common);
+            }
+            for (; i < End; ++i) Output[i] = CRC32(Input[i]);
+        }
+    }
+
+    //--------------------------------------------------------------------------------
+    void BatchToLower(std::span<std::string> Strings) noexcept
+    {
+        ParallelFor(Strings.size(), BatchGrain(Strings, 1), [&](const std::size_t Begin, const std::size_t End) noexcept
+        {
+            const auto& Kernels = ActiveKernels();
+            for (std::size_t i = Begin; i < End; ++i) Kernels.m_pToLower(Strings[i].data(), Strings[i].data(), Strings[i].size());
+        });
+    }
+
+    //--------------------------------------------------------------------------------
+    void BatchToLower(std::span<const std::string_view> Input, std::span<std::string> Output) noexcept
+    {
+        assert(Input.size() == Output.size());
+        ParallelFor(Input.size(), BatchGrain(Input, 1), [&](const std::size_t Begin, const std::size_t End) noexcept
+        {
+            const auto& Kernels = ActiveKernels();
+            for (std::size_t i = Begin; i < End; ++i)
+            {
+                ResizeAndOverwrite(Output[i], Input[i].size(), [&](char* pData, const std::size_t Len) noexcept
+                {
+                    Kernels.m_pToLower(pData, Input[i].data(), Len);
+                });
+            }
+        });
+    }
+
+    //--------------------------------------------------------------------------------
+    void BatchTrim(std::span<std::string> Strings) noexcept
+    {
+        ParallelFor(Strings.size(), BatchGrain(Strings, 0), [&](const std::size_t Begin, const std::size_t End) noexcept
+        {
+            const auto& Kernels = ActiveKernels();
+            for (std::size_t i = Begin; i < End; ++i)
+            {
+                std::string&      Str   = Strings[i];
+                const std::size_t Right = Kernels.m_pTrimRight(Str.data(), Str.size());
+                Str.erase(Right);
+                Str.erase(0, Kernels.m_pTrimLeft(Str.data(), Right));
+            }
+        });
+    }
+
+    //--------------------------------------------------------------------------------
+    void BatchTrim(std::span<const std::string_view> Input, std::span<std::string_view> Output) noexcept
+    {
+        assert(Input.size() == Output.size());
+        ParallelFor(Input.size(), BatchGrain(Input, 0), [&](const std::size_t Begin, const std::size_t End) noexcept
+        {
+            const auto& Kernels = ActiveKernels();
+            for (std::size_t i = Begin; i < End; ++i)
+            {
+                const std::string_view Right = Input[i].substr(0, Kernels.m_pTrimRight(Input[i].data(), Input[i].size()));
+                Output[i] = Right.substr(Kernels.m_pTrimLeft(Right.data(), Right.size()));
+            }
+        });
+    }
+
+    //--------------------------------------------------------------------------------
+    void BatchHash(std::span<const std::string_view> Input, std::span<std::size_t> Output) noexcept
+    {
+        assert(Input.size() == Output.size());
+        ParallelFor(Input.size(), BatchGrain(Input, 1), [&](const std::size_t Begin, const std::size_t End) noexcept
+        {
+            for (std::size_t i = Begin; i < End; ++i) Output[i] = Hash(Input[i]);
+        });
+    }
+
+    //--------------------------------------------------------------------------------
+    void BatchHash(std::span<const std::string> Input, std::span<std::size_t> Output) noexcept
+    {
+        assert(Input.size() == Output.size());
+        ParallelFor(Input.size(), BatchGrain(Input, 1), [&](const std::size_t Begin, const std::size_t End) noexcept
+        {
+            for (std::size_t i = Begin; i < End; ++i) Output[i] = Hash(Input[i]);
+        });
+    }
+
+    //--------------------------------------------------------------------------------
+    void BatchCRC32(std::span<const std::string_view> Input, std::span<std::uint32_t> Output) noexcept
+    {
+        assert(Input.size() == Output.size());
+        ParallelFor(Input.size(), BatchGrain(Input, 4), [&](const std::size_t Begin, const std::size_t End) noexcept
+        {
+            BatchCRC32Range(Input, Output, Begin, End);
+        });
+    }
+
+    //--------------------------------------------------------------------------------
+    void BatchCRC32(std::span<const std::string> Input, std::span<std::uint32_t> Output) noexcept
+    {
+        assert(Input.size() == Output.size());
+        ParallelFor(Input.size(), BatchGrain(Input, 4), [&](const std::size_t Begin, const std::size_t End) noexcept
+        {
+            BatchCRC32Range(Input, Output, Begin, End);
+        });
+    }
+
 
     //--------------------------------------------------------------------------------
     std::wstring UTF8ToUTF16(const std::string_view Utf8) noexcept
@@ -1967,6 +6808,338 @@ namespace xstrtool
         return result;
     }
 
+    //--------------------------------------------------------------------------------
+    // UTF-8 simple case folding
+    //--------------------------------------------------------------------------------
+    namespace
+    {
+        struct fold_range
+        {
+            std::uint32_t   m_First;        // First code point of the range
+            std::uint32_t   m_Last;         // Last code point of the range
+            std::int32_t    m_Delta;        // Added to a code point to fold it
+            std::uint32_t   m_Stride;       // 1 when every code point folds, 2 for the alternating upper/lower case pairs
+        };
+
+        // Unicode 14 simple case folding (CaseFolding.txt status C and S) for everything above ASCII
+        constexpr std::array<fold_range, 201> FoldRanges_v =
+        {{
+              { 0x000B5, 0x000B5,    775, 1 }, { 0x000C0, 0x000D6,     32, 1 }, { 0x000D8, 0x000DE,     32, 1 }, { 0x00100, 0x0012E,      1, 2 }
+            , { 0x00132, 0x00136,      1, 2 }, { 0x00139, 0x00147,      1, 2 }, { 0x0014A, 0x00176,      1, 2 }, { 0x00178, 0x00178,   -121, 1 }
+            , { 0x00179, 0x0017D,      1, 2 }, { 0x0017F, 0x0017F,   -268, 1 }, { 0x00181, 0x00181,    210, 1 }, { 0x00182, 0x00184,      1, 2 }
+            , { 0x00186, 0x00186,    206, 1 }, { 0x00187, 0x00187,      1, 1 }, { 0x00189, 0x0018A,    205, 1 }, { 0x0018B, 0x0018B,      1, 1 }
+            , { 0x0018E, 0x0018E,     79, 1 }, { 0x0018F, 0x0018F,    202, 1 }, { 0x00190, 0x00190,    203, 1 }, { 0x00191, 0x00191,      1, 1 }
+            , { 0x00193, 0x00193,    205, 1 }, { 0x00194, 0x00194,    207, 1 }, { 0x00196, 0x00196,    211, 1 }, { 0x00197, 0x00197,    209, 1 }
+            , { 0x00198, 0x00198,      1, 1 }, { 0x0019C, 0x0019C,    211, 1 }, { 0x0019D, 0x0019D,    213, 1 }, { 0x0019F, 0x0019F,    214, 1 }
+            , { 0x001A0, 0x001A4,      1, 2 }, { 0x001A6, 0x001A6,    218, 1 }, { 0x001A7, 0x001A7,      1, 1 }, { 0x001A9, 0x001A9,    218, 1 }
+            , { 0x001AC, 0x001AC,      1, 1 }, { 0x001AE, 0x001AE,    218, 1 }, { 0x001AF, 0x001AF,      1, 1 }, { 0x001B1, 0x001B2,    217, 1 }
+            , { 0x001B3, 0x001B5,      1, 2 }, { 0x001B7, 0x001B7,    219, 1 }, { 0x001B8, 0x001B8,      1, 1 }, { 0x001BC, 0x001BC,      1, 1 }
+            , { 0x001C4, 0x001C4,      2, 1 }, { 0x001C5, 0x001C5,      1, 1 }, { 0x001C7, 0x001C7,      2, 1 }, { 0x001C8, 0x001C8,      1, 1 }
+            , { 0x001CA, 0x001CA,      2, 1 }, { 0x001CB, 0x001DB,      1, 2 }, { 0x001DE, 0x001EE,      1, 2 }, { 0x001F1, 0x001F1,      2, 1 }
+            , { 0x001F2, 0x001F4,      1, 2 }, { 0x001F6, 0x001F6,    -97, 1 }, { 0x001F7, 0x001F7,    -56, 1 }, { 0x001F8, 0x0021E,      1, 2 }
+            , { 0x00220, 0x00220,   -130, 1 }, { 0x00222, 0x00232,      1, 2 }, { 0x0023A, 0x0023A,  10795, 1 }, { 0x0023B, 0x0023B,      1, 1 }
+            , { 0x0023D, 0x0023D,   -163, 1 }, { 0x0023E, 0x0023E,  10792, 1 }, { 0x00241, 0x00241,      1, 1 }, { 0x00243, 0x00243,   -195, 1 }
+            , { 0x00244, 0x00244,     69, 1 }, { 0x00245, 0x00245,     71, 1 }, { 0x00246, 0x0024E,      1, 2 }, { 0x00345, 0x00345,    116, 1 }
+            , { 0x00370, 0x00372,      1, 2 }, { 0x00376, 0x00376,      1, 1 }, { 0x0037F, 0x0037F,    116, 1 }, { 0x00386, 0x00386,     38, 1 }
+            , { 0x00388, 0x0038A,     37, 1 }, { 0x0038C, 0x0038C,     64, 1 }, { 0x0038E, 0x0038F,     63, 1 }, { 0x00391, 0x003A1,     32, 1 }
+            , { 0x003A3, 0x003AB,     32, 1 }, { 0x003C2, 0x003C2,      1, 1 }, { 0x003CF, 0x003CF,      8, 1 }, { 0x003D0, 0x003D0,    -30, 1 }
+            , { 0x003D1, 0x003D1,    -25, 1 }, { 0x003D5, 0x003D5,    -15, 1 }, { 0x003D6, 0x003D6,    -22, 1 }, { 0x003D8, 0x003EE,      1, 2 }
+            , { 0x003F0, 0x003F0,    -54, 1 }, { 0x003F1, 0x003F1,    -48, 1 }, { 0x003F4, 0x003F4,    -60, 1 }, { 0x003F5, 0x003F5,    -64, 1 }
+            , { 0x003F7, 0x003F7,      1, 1 }, { 0x003F9, 0x003F9,     -7, 1 }, { 0x003FA, 0x003FA,      1, 1 }, { 0x003FD, 0x003FF,   -130, 1 }
+            , { 0x00400, 0x0040F,     80, 1 }, { 0x00410, 0x0042F,     32, 1 }, { 0x00460, 0x00480,      1, 2 }, { 0x0048A, 0x004BE,      1, 2 }
+            , { 0x004C0, 0x004C0,     15, 1 }, { 0x004C1, 0x004CD,      1, 2 }, { 0x004D0, 0x0052E,      1, 2 }, { 0x00531, 0x00556,     48, 1 }
+            , { 0x010A0, 0x010C5,   7264, 1 }, { 0x010C7, 0x010C7,   7264, 1 }, { 0x010CD, 0x010CD,   7264, 1 }, { 0x013F8, 0x013FD,     -8, 1 }
+            , { 0x01C80, 0x01C80,  -6222, 1 }, { 0x01C81, 0x01C81,  -6221, 1 }, { 0x01C82, 0x01C82,  -6212, 1 }, { 0x01C83, 0x01C84,  -6210, 1 }
+            , { 0x01C85, 0x01C85,  -6211, 1 }, { 0x01C86, 0x01C86,  -6204, 1 }, { 0x01C87, 0x01C87,  -6180, 1 }, { 0x01C88, 0x01C88,  35267, 1 }
+            , { 0x01C90, 0x01CBA,  -3008, 1 }, { 0x01CBD, 0x01CBF,  -3008, 1 }, { 0x01E00, 0x01E94,      1, 2 }, { 0x01E9B, 0x01E9B,    -58, 1 }
+            , { 0x01E9E, 0x01E9E,  -7615, 1 }, { 0x01EA0, 0x01EFE,      1, 2 }, { 0x01F08, 0x01F0F,     -8, 1 }, { 0x01F18, 0x01F1D,     -8, 1 }
+            , { 0x01F28, 0x01F2F,     -8, 1 }, { 0x01F38, 0x01F3F,     -8, 1 }, { 0x01F48, 0x01F4D,     -8, 1 }, { 0x01F59, 0x01F5F,     -8, 2 }
+            , { 0x01F68, 0x01F6F,     -8, 1 }, { 0x01F88, 0x01F8F,     -8, 1 }, { 0x01F98, 0x01F9F,     -8, 1 }, { 0x01FA8, 0x01FAF,     -8, 1 }
+            , { 0x01FB8, 0x01FB9,     -8, 1 }, { 0x01FBA, 0x01FBB,    -74, 1 }, { 0x01FBC, 0x01FBC,     -9, 1 }, { 0x01FBE, 0x01FBE,  -7173, 1 }
+            , { 0x01FC8, 0x01FCB,    -86, 1 }, { 0x01FCC, 0x01FCC,     -9, 1 }, { 0x01FD8, 0x01FD9,     -8, 1 }, { 0x01FDA, 0x01FDB,   -100, 1 }
+            , { 0x01FE8, 0x01FE9,     -8, 1 }, { 0x01FEA, 0x01FEB,   -112, 1 }, { 0x01FEC, 0x01FEC,     -7, 1 }, { 0x01FF8, 0x01FF9,   -128, 1 }
+            , { 0x01FFA, 0x01FFB,   -126, 1 }, { 0x01FFC, 0x01FFC,     -9, 1 }, { 0x02126, 0x02126,  -7517, 1 }, { 0x0212A, 0x0212A,  -8383, 1 }
+            , { 0x0212B, 0x0212B,  -8262, 1 }, { 0x02132, 0x02132,     28, 1 }, { 0x02160, 0x0216F,     16, 1 }, { 0x02183, 0x02183,      1, 1 }
+            , { 0x024B6, 0x024CF,     26, 1 }, { 0x02C00, 0x02C2F,     48, 1 }, { 0x02C60, 0x02C60,      1, 1 }, { 0x02C62, 0x02C62, -10743, 1 }
+            , { 0x02C63, 0x02C63,  -3814, 1 }, { 0x02C64, 0x02C64, -10727, 1 }, { 0x02C67, 0x02C6B,      1, 2 }, { 0x02C6D, 0x02C6D, -10780, 1 }
+            , { 0x02C6E, 0x02C6E, -10749, 1 }, { 0x02C6F, 0x02C6F, -10783, 1 }, { 0x02C70, 0x02C70, -10782, 1 }, { 0x02C72, 0x02C72,      1, 1 }
+            , { 0x02C75, 0x02C75,      1, 1 }, { 0x02C7E, 0x02C7F, -10815, 1 }, { 0x02C80, 0x02CE2,      1, 2 }, { 0x02CEB, 0x02CED,      1, 2 }
+            , { 0x02CF2, 0x02CF2,      1, 1 }, { 0x0A640, 0x0A66C,      1, 2 }, { 0x0A680, 0x0A69A,      1, 2 }, { 0x0A722, 0x0A72E,      1, 2 }
+            , { 0x0A732, 0x0A76E,      1, 2 }, { 0x0A779, 0x0A77B,      1, 2 }, { 0x0A77D, 0x0A77D, -35332, 1 }, { 0x0A77E, 0x0A786,      1, 2 }
+            , { 0x0A78B, 0x0A78B,      1, 1 }, { 0x0A78D, 0x0A78D, -42280, 1 }, { 0x0A790, 0x0A792,      1, 2 }, { 0x0A796, 0x0A7A8,      1, 2 }
+            , { 0x0A7AA, 0x0A7AA, -42308, 1 }, { 0x0A7AB, 0x0A7AB, -42319, 1 }, { 0x0A7AC, 0x0A7AC, -42315, 1 }, { 0x0A7AD, 0x0A7AD, -42305, 1 }
+            , { 0x0A7AE, 0x0A7AE, -42308, 1 }, { 0x0A7B0, 0x0A7B0, -42258, 1 }, { 0x0A7B1, 0x0A7B1, -42282, 1 }, { 0x0A7B2, 0x0A7B2, -42261, 1 }
+            , { 0x0A7B3, 0x0A7B3,    928, 1 }, { 0x0A7B4, 0x0A7C2,      1, 2 }, { 0x0A7C4, 0x0A7C4,    -48, 1 }, { 0x0A7C5, 0x0A7C5, -42307, 1 }
+            , { 0x0A7C6, 0x0A7C6, -35384, 1 }, { 0x0A7C7, 0x0A7C9,      1, 2 }, { 0x0A7D0, 0x0A7D0,      1, 1 }, { 0x0A7D6, 0x0A7D8,      1, 2 }
+            , { 0x0A7F5, 0x0A7F5,      1, 1 }, { 0x0AB70, 0x0ABBF, -38864, 1 }, { 0x0FF21, 0x0FF3A,     32, 1 }, { 0x10400, 0x10427,     40, 1 }
+            , { 0x104B0, 0x104D3,     40, 1 }, { 0x10570, 0x1057A,     39, 1 }, { 0x1057C, 0x1058A,     39, 1 }, { 0x1058C, 0x10592,     39, 1 }
+            , { 0x10594, 0x10595,     39, 1 }, { 0x10C80, 0x10CB2,     64, 1 }, { 0x118A0, 0x118BF,     32, 1 }, { 0x16E40, 0x16E5F,     32, 1 }
+            , { 0x1E900, 0x1E921,     34, 1 }
+        }};
+
+        // Invalid bytes decode to InvalidU8_v + byte, so they never fold and only match themselves
+        constexpr std::uint32_t InvalidU8_v = 0x110000;
+
+        std::uint32_t FoldCodePoint(const std::uint32_t CP) noexcept
+        {
+            if (CP < 0x80) return (CP - 'A' < 26) ? CP + 32 : CP;
+
+            const auto It = std::upper_bound(FoldRanges_v.begin(), FoldRanges_v.end(), CP, [](const std::uint32_t C, const fold_range& R) { return C < R.m_First; });
+            if (It == FoldRanges_v.begin()) return CP;
+
+            const fold_range& R = *(It - 1);
+            return (CP <= R.m_Last && (CP - R.m_First) % R.m_Stride == 0) ? static_cast<std::uint32_t>(static_cast<std::int32_t>(CP) + R.m_Delta) : CP;
+        }
+
+        // Decodes the character at pData, returns its length in bytes. Overlong forms, surrogates and code points
+        // above U+10FFFF are rejected by the range of the second byte, their lead byte is then an invalid byte
+        std::size_t DecodeU8(const char* pData, const std::size_t Len, std::uint32_t& CP) noexcept
+        {
+            const auto B0     = static_cast<unsigned char>(pData[0]);
+            const auto IsCont = [&](const std::size_t i) { return i < Len && (static_cast<unsigned char>(pData[i]) & 0xC0) == 0x80; };
+            if (B0 < 0x80)
+            {
+                CP = B0;
+                return 1;
+            }
+
+            const unsigned Low     = (B0 == 0xE0) ? 0xA0 : (B0 == 0xF0) ? 0x90 : 0x80;
+            const unsigned High    = (B0 == 0xED) ? 0x9F : (B0 == 0xF4) ? 0x8F : 0xBF;
+            const bool     bSecond = Len > 1 && static_cast<unsigned char>(pData[1]) >= Low && static_cast<unsigned char>(pData[1]) <= High;
+            if (B0 >= 0xC2 && B0 < 0xE0 && bSecond)
+            {
+                CP = ((B0 & 0x1Fu) << 6) | (pData[1] & 0x3Fu);
+                return 2;
+            }
+            if (B0 >= 0xE0 && B0 < 0xF0 && bSecond && IsCont(2))
+            {
+                CP = ((B0 & 0x0Fu) << 12) | ((pData[1] & 0x3Fu) << 6) | (pData[2] & 0x3Fu);
+                return 3;
+            }
+            if (B0 >= 0xF0 && B0 < 0xF5 && bSecond && IsCont(2) && IsCont(3))
+            {
+                CP = ((B0 & 0x07u) << 18) | ((pData[1] & 0x3Fu) << 12) | ((pData[2] & 0x3Fu) << 6) | (pData[3] & 0x3Fu);
+                return 4;
+            }
+            CP = InvalidU8_v + B0;
+            return 1;
+        }
+
+        // Writes the character, returns its length in bytes
+        std::size_t EncodeU8(char* pData, const std::uint32_t CP) noexcept
+        {
+            if (CP < 0x80)
+            {
+                pData[0] = static_cast<char>(CP);
+                return 1;
+            }
+            if (CP < 0x800)
+            {
+                pData[0] = static_cast<char>(0xC0 | (CP >> 6));
+                pData[1] = static_cast<char>(0x80 | (CP & 0x3F));
+                return 2;
+            }
+            if (CP < 0x10000)
+            {
+                pData[0] = static_cast<char>(0xE0 | (CP >> 12));
+                pData[1] = static_cast<char>(0x80 | ((CP >> 6) & 0x3F));
+                pData[2] = static_cast<char>(0x80 | (CP & 0x3F));
+                return 3;
+            }
+            if (CP < InvalidU8_v)
+            {
+                assert(CP < 0x110000);
+                pData[0] = static_cast<char>(0xF0 | (CP >> 18));
+                pData[1] = static_cast<char>(0x80 | ((CP >> 12) & 0x3F));
+                pData[2] = static_cast<char>(0x80 | ((CP >> 6) & 0x3F));
+                pData[3] = static_cast<char>(0x80 | (CP & 0x3F));
+                return 4;
+            }
+            assert(CP - InvalidU8_v >= 0x80 && CP - InvalidU8_v <= 0xFF && "Only an invalid byte decodes above U+10FFFF");
+            pData[0] = static_cast<char>(CP - InvalidU8_v);
+            return 1;
+        }
+
+        // Checks that the folded characters of Haystack starting at Pos begin with FoldedNeedle
+        bool StartsWithFoldedU8(const std::string_view Haystack, std::size_t Pos, const std::string_view FoldedNeedle) noexcept
+        {
+            const auto  pMismatch = ActiveKernels().m_pMismatchAsciiI;
+            std::size_t j         = 0;
+            while (true)
+            {
+                const std::size_t Same = pMismatch(Haystack.data() + Pos, FoldedNeedle.data() + j, std::min(Haystack.size() - Pos, FoldedNeedle.size() - j));
+                Pos += Same;
+                j   += Same;
+                if (j == FoldedNeedle.size()) return true;
+                if (Pos == Haystack.size()) return false;
+
+                std::uint32_t Ch, Cn;
+                Pos += DecodeU8(Haystack.data() + Pos, Haystack.size() - Pos, Ch);
+                j   += DecodeU8(FoldedNeedle.data() + j, FoldedNeedle.size() - j, Cn);
+                if (FoldCodePoint(Ch) != Cn) return false;
+            }
+        }
+    }
+
+    //--------------------------------------------------------------------------------
+    std::string FoldCaseU8Copy(const std::string_view Utf8) noexcept
+    {
+        // A character never grows by more than half its size (2 byte characters that fold to 3 bytes),
+        // which also leaves room for the LowerAscii kernel to write whole vectors
+        std::string Result;
+        ResizeAndOverwrite(Result, Utf8.size() + Utf8.size() / 2, [&](char* pData, const std::size_t) noexcept
+        {
+            const auto  pLowerAscii = ActiveKernels().m_pLowerAscii;
+            std::size_t i = 0, o = 0;
+            while (i < Utf8.size())
+            {
+                const std::size_t Ascii = pLowerAscii(pData + o, Utf8.data() + i, Utf8.size() - i);
+                i += Ascii;
+                o += Ascii;
+
+                // Non ASCII characters one at a time until the next ASCII byte
+                while (i < Utf8.size() && static_cast<unsigned char>(Utf8[i]) >= 0x80)
+                {
+                    std::uint32_t CP;
+                    i += DecodeU8(Utf8.data() + i, Utf8.size() - i, CP);
+                    o += EncodeU8(pData + o, FoldCodePoint(CP));
+                }
+            }
+            return o;
+        });
+        return Result;
+    }
+
+    //--------------------------------------------------------------------------------
+    int CompareIU8(const std::string_view A, const std::string_view B) noexcept
+    {
+        const auto  pMismatch = ActiveKernels().m_pMismatchAsciiI;
+        std::size_t i = 0, j = 0;
+        while (true)
+        {
+            // ASCII that folds the same is skipped a vector at a time
+            const std::size_t Same = pMismatch(A.data() + i, B.data() + j, std::min(A.size() - i, B.size() - j));
+            i += Same;
+            j += Same;
+            if (i == A.size() || j == B.size()) break;
+
+            std::uint32_t Ca, Cb;
+            i += DecodeU8(A.data() + i, A.size() - i, Ca);
+            j += DecodeU8(B.data() + j, B.size() - j, Cb);
+            Ca = FoldCodePoint(Ca);
+            Cb = FoldCodePoint(Cb);
+            if (Ca != Cb) return (Ca < Cb) ? -1 : 1;
+        }
+        return (i == A.size()) ? (j == B.size() ? 0 : -1) : 1;
+    }
+
+    //--------------------------------------------------------------------------------
+    std::size_t FindIU8(const std::string_view Haystack, const std::string_view Needle, const std::size_t Pos) noexcept
+    {
+        assert(Pos <= Haystack.size() && "Starting position exceeds haystack length");
+        if (Needle.empty()) return std::string::npos;
+
+        const std::string Folded = FoldCaseU8Copy(Needle);
+        const auto&       Kernels = ActiveKernels();
+
+        // Only U+017F and U+212A fold into ASCII ('s' and 'k'), so without those letters an ASCII
+        // needle can only match ASCII bytes and the ASCII search kernel is exact
+        const bool bAscii = std::ranges::all_of(Folded, [](const char C) { return static_cast<unsigned char>(C) < 0x80; });
+        if (bAscii && Folded.find_first_of("ks") == std::string::npos)
+        {
+            return FinderI(Folded).Find(Haystack, Pos);
+        }
+
+        // Candidates are the bytes that can start the first folded character: its ASCII letter
+        // (plus any non ASCII character for 'k'/'s') or else any non ASCII character.
+        // Comparing a run with itself stops at its first non ASCII byte
+        const char        First        = Folded[0];
+        const bool        bAsciiFirst  = static_cast<unsigned char>(First) < 0x80;
+        const bool        bAnyNonAscii = !bAsciiFirst || First == 'k' || First == 's';
+        const char*       pHay         = Haystack.data();
+        for (std::size_t i = Pos; i < Haystack.size(); )
+        {
+            std::size_t Next = Haystack.size();
+            if (bAsciiFirst)     Next = std::min(Next, Kernels.m_pFindI(Haystack, std::string_view(&First, 1), i, 0, 0));
+            if (bAnyNonAscii)    Next = std::min(Next, i + Kernels.m_pMismatchAsciiI(pHay + i, pHay + i, Haystack.size() - i));
+            if (Next == Haystack.size()) break;
+
+            if (StartsWithFoldedU8(Haystack, Next, Folded)) return Next;
+
+            std::uint32_t CP;
+            i = Next + DecodeU8(pHay + Next, Haystack.size() - Next, CP);
+        }
+        return std::string::npos;
+    }
+
+    //--------------------------------------------------------------------------------
+    CaseMapper::CaseMapper(const std::locale& Loc)
+        : m_Locale{ Loc }
+        , m_pCtype{ &std::use_facet<std::ctype<wchar_t>>(m_Locale) }
+        , m_Lower(0x10000)
+        , m_Upper(0x10000)
+    {
+        // The range overloads of the facet fill each table with a single virtual call
+        std::vector<wchar_t> Lower(0x10000), Upper(0x10000);
+        for (std::size_t i = 0; i < Lower.size(); ++i) Lower[i] = Upper[i] = static_cast<wchar_t>(i);
+        m_pCtype->tolower(Lower.data(), Lower.data() + Lower.size());
+        m_pCtype->toupper(Upper.data(), Upper.data() + Upper.size());
+
+        // A mapping that leaves the BMP can not be stored, those characters are kept as they are
+        for (std::size_t i = 0; i < Lower.size(); ++i)
+        {
+            m_Lower[i] = static_cast<std::uint32_t>(Lower[i]) <= 0xFFFF ? static_cast<char16_t>(Lower[i]) : static_cast<char16_t>(i);
+            m_Upper[i] = static_cast<std::uint32_t>(Upper[i]) <= 0xFFFF ? static_cast<char16_t>(Upper[i]) : static_cast<char16_t>(i);
+        }
+
+        // Locales such as Turkish map 'I' somewhere else, then the ASCII runs have to use the tables too
+        m_bPlainAscii = true;
+        for (wchar_t C = 0; C < 0x80; ++C)
+        {
+            if (m_Lower[C] != static_cast<char16_t>(xstrtool::ToLower(C)) || m_Upper[C] != static_cast<char16_t>(xstrtool::ToUpper(C))) m_bPlainAscii = false;
+        }
+    }
+
+    //--------------------------------------------------------------------------------
+    const CaseMapper& CaseMapper::System()
+    {
+        static const CaseMapper Mapper{ std::locale("") };
+        return Mapper;
+    }
+
+    //--------------------------------------------------------------------------------
+    template< bool T_TO_UPPER_V >
+    void CaseMapper::Convert(wchar_t* pDest, const wchar_t* pSrc, const std::size_t Len) const noexcept
+    {
+        const auto pAsciiKernel = T_TO_UPPER_V ? ActiveKernels().m_pUpperAsciiW : ActiveKernels().m_pLowerAsciiW;
+        std::size_t i = 0;
+        while (i < Len)
+        {
+            // The kernel stops at the first vector with a non ASCII character, a short table run
+            // takes over from there before the kernel gets another go
+            std::size_t End = Len;
+            if (m_bPlainAscii)
+            {
+                i  += pAsciiKernel(pDest + i, pSrc + i, Len - i);
+                End = std::min(Len, i + 32);
+            }
+
+            for (; i < End; ++i) pDest[i] = T_TO_UPPER_V ? ToUpper(pSrc[i]) : ToLower(pSrc[i]);
+        }
+    }
+
+    //--------------------------------------------------------------------------------
+    void CaseMapper::ToLower(wchar_t* pDest, const wchar_t* pSrc, const std::size_t Len) const noexcept
+    {
+        Convert<false>(pDest, pSrc, Len);
+    }
+
+    //--------------------------------------------------------------------------------
+    void CaseMapper::ToUpper(wchar_t* pDest, const wchar_t* pSrc, const std::size_t Len) const noexcept
+    {
+        Convert<true>(pDest, pSrc, Len);
+    }
+
     //--------------------------------------------------------------------------------
     std::wstring ToLowerLocale(const std::wstring_view InputView, const std::locale& Loc) noexcept
     {
@@ -1979,10 +7152,7 @@ namespace xstrtool
     void ToLowerLocale(std::wstring& Str, const std::locale& Loc) noexcept
     {
         const auto& Ctype = std::use_facet<std::ctype<wchar_t>>(Loc);
-        for (wchar_t& C : Str)
-        {
-            C = Ctype.tolower(C);
-        }
+        Ctype.tolower(Str.data(), Str.data() + Str.size());
     }
 
     //--------------------------------------------------------------------------------
@@ -1997,10 +7167,41 @@ namespace xstrtool
     void ToUpperLocale(std::wstring& Str, const std::locale& Loc) noexcept
     {
         const auto& Ctype = std::use_facet<std::ctype<wchar_t>>(Loc);
-        for (wchar_t& C : Str)
+        Ctype.toupper(Str.data(), Str.data() + Str.size());
+    }
+
+    //--------------------------------------------------------------------------------
+    std::wstring ToLowerLocale(const std::wstring_view InputView, const CaseMapper& Mapper) noexcept
+    {
+        std::wstring Result;
+        ResizeAndOverwrite(Result, InputView.size(), [&](wchar_t* pData, const std::size_t Len) noexcept
         {
-            C = Ctype.toupper(C);
-        }
+            Mapper.ToLower(pData, InputView.data(), Len);
+        });
+        return Result;
+    }
+
+    //--------------------------------------------------------------------------------
+    void ToLowerLocale(std::wstring& Str, const CaseMapper& Mapper) noexcept
+    {
+        Mapper.ToLower(Str.data(), Str.data(), Str.size());
+    }
+
+    //--------------------------------------------------------------------------------
+    std::wstring ToUpperLocale(const std::wstring_view InputView, const CaseMapper& Mapper) noexcept
+    {
+        std::wstring Result;
+        ResizeAndOverwrite(Result, InputView.size(), [&](wchar_t* pData, const std::size_t Len) noexcept
+        {
+            Mapper.ToUpper(pData, InputView.data(), Len);
+        });
+        return Result;
+    }
+
+    //--------------------------------------------------------------------------------
+    void ToUpperLocale(std::wstring& Str, const CaseMapper& Mapper) noexcept
+    {
+        Mapper.ToUpper(Str.data(), Str.data(), Str.size());
     }
 
     //--------------------------------------------------------------------------------
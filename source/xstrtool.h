@@ -2,15 +2,26 @@
 #define XSTRTOOL_H
 
 #include <chrono>
+#include <cstdint>
 #include <locale>   // For locale-aware case
 #include <string>
 #include <string_view>
 #include <vector>
 #include <span>
+#include <iterator> // For std::default_sentinel_t
+#include <bit>      // For std::countr_zero
+#include <memory>   // For std::shared_ptr
+#include <atomic>
+#include <functional> // For the sink of SplitLinesParallel
 #include <cassert>
 
 namespace xstrtool
 {
+    // Thread safety: the compiled objects (BasicFinder, BasicReverseFinder, BasicMultiFinder, BasicAffixSetI,
+    // BasicGlob, CharSet and CaseMapper) are immutable after construction, so one object can be used by any
+    // number of threads at once without locks. Objects that keep state between calls (BasicStreamFinder,
+    // CsvReader) need one object per thread.
+
     // Always-failing static_assert (dependent on T, C++20-compatible, works pre-C++20 too)
     template <typename T>
     constexpr bool always_false_v = false;
@@ -99,6 +110,36 @@ namespace xstrtool
         return str.substr(pos + 1);               // View from last newline to end
     }
 
+    // SIMD instruction set tiers used by the runtime kernel dispatcher (ordered from narrowest to widest).
+    // The CPU is detected once on first use and the widest supported tier is selected, unless the
+    // XSTRTOOL_SIMD_TIER environment variable (scalar, sse2, sse42, avx2, avx512bw) asks for a narrower one.
+    enum class simd_tier : std::uint8_t
+    {   SCALAR
+    ,   SSE2
+    ,   SSE42
+    ,   AVX2
+    ,   AVX512BW
+    ,   COUNT
+    };
+
+    // Gets the widest SIMD tier supported by the CPU and the OS.
+    // @return Widest supported tier.
+    simd_tier GetSupportedSimdTier() noexcept;
+
+    // Gets the SIMD tier currently used by the dispatched functions.
+    // @return Active tier.
+    simd_tier GetSimdTier() noexcept;
+
+    // Forces the SIMD tier used by the dispatched functions (useful for benchmarking the tiers against each other).
+    // @param Tier Requested tier; it is clamped to GetSupportedSimdTier().
+    // @return The tier actually selected.
+    simd_tier SetSimdTier(const simd_tier Tier) noexcept;
+
+    // Gets the printable name of a SIMD tier (same names accepted by XSTRTOOL_SIMD_TIER).
+    // @param Tier The tier.
+    // @return Name of the tier.
+    std::string_view GetSimdTierName(const simd_tier Tier) noexcept;
+
     // Converts a single char to lowercase (English ASCII only).
     // @param Char The character to convert.
     // @return The lowercase equivalent if uppercase letter; otherwise unchanged.
@@ -195,6 +236,12 @@ namespace xstrtool
     // @param Str Narrow string to modify.
     void ToLower(std::string& Str) noexcept;
 
+    // Writes a lowercase copy of the narrow string_view into a null-terminated buffer, without allocating (English ASCII).
+    // @param Dest a span of chars where the converted string will be written (must not partially overlap Source)
+    // @param Source Input string view.
+    // @return Number of converted characters
+    std::size_t ToLowerInto(std::span<char> Dest, const std::string_view Source) noexcept;
+
     // Creates a lowercase copy of the wide string_view (English ASCII).
     // @param InputView Input wide string view.
     // @return Lowercase wide string copy.
@@ -209,6 +256,12 @@ namespace xstrtool
     // @param Str Wide string to modify.
     void ToLower(std::wstring& Str) noexcept;
 
+    // Writes a lowercase copy of the wide string_view into a null-terminated buffer, without allocating (English ASCII).
+    // @param Dest a span of wchar_t where the converted string will be written (must not partially overlap Source)
+    // @param Source Input wide string view.
+    // @return Number of converted characters
+    std::size_t ToLowerInto(std::span<wchar_t> Dest, const std::wstring_view Source) noexcept;
+
     // Creates an uppercase copy of the narrow string_view (English ASCII).
     // @param InputView Input string view.
     // @return Uppercase string copy.
@@ -223,6 +276,12 @@ namespace xstrtool
     // @param Str Narrow string to modify.
     void ToUpper(std::string& Str) noexcept;
 
+    // Writes an uppercase copy of the narrow string_view into a null-terminated buffer, without allocating (English ASCII).
+    // @param Dest a span of chars where the converted string will be written (must not partially overlap Source)
+    // @param Source Input string view.
+    // @return Number of converted characters
+    std::size_t ToUpperInto(std::span<char> Dest, const std::string_view Source) noexcept;
+
     // Creates an uppercase copy of the wide string_view (English ASCII).
     // @param InputView Input wide string view.
     // @return Uppercase wide string copy.
@@ -237,6 +296,12 @@ namespace xstrtool
     // @param Str Wide string to modify.
     void ToUpper(std::wstring& Str) noexcept;
 
+    // Writes an uppercase copy of the wide string_view into a null-terminated buffer, without allocating (English ASCII).
+    // @param Dest a span of wchar_t where the converted string will be written (must not partially overlap Source)
+    // @param Source Input wide string view.
+    // @return Number of converted characters
+    std::size_t ToUpperInto(std::span<wchar_t> Dest, const std::wstring_view Source) noexcept;
+
     // Compares two narrow strings case-insensitively (English ASCII).
     // @param A First string view.
     // @param B Second string view.
@@ -261,6 +326,52 @@ namespace xstrtool
     // @return Negative if A < B, positive if A > B, zero if equal (lexicographical).
     int CompareI(const wchar_t* A, const wchar_t* B) noexcept;
 
+    // Compares two strings case-insensitively (English ASCII) in natural order: runs of digits compare by
+    // their value, so "file2" < "File10". Numbers of any length work (they are not converted), and equal
+    // numbers with more leading zeros only sort after when the strings are otherwise equal ("a1" < "a01").
+    // @param A First string view.
+    // @param B Second string view.
+    // @return -1 if A < B, 0 if equal, 1 if A > B.
+    int CompareNaturalI(const std::string_view A, const std::string_view B) noexcept;
+
+    // Compares two null-terminated strings case-insensitively in natural order (see the string_view overload).
+    // @param A First null-terminated string.
+    // @param B Second null-terminated string.
+    // @return -1 if A < B, 0 if equal, 1 if A > B.
+    int CompareNaturalI(const char* A, const char* B) noexcept;
+
+    // Compares two wide strings case-insensitively in natural order (see the string_view overload).
+    // @param A First wide string view.
+    // @param B Second wide string view.
+    // @return -1 if A < B, 0 if equal, 1 if A > B.
+    int CompareNaturalI(const std::wstring_view A, const std::wstring_view B) noexcept;
+
+    // Compares two null-terminated wide strings case-insensitively in natural order (see the string_view overload).
+    // @param A First null-terminated wide string.
+    // @param B Second null-terminated wide string.
+    // @return -1 if A < B, 0 if equal, 1 if A > B.
+    int CompareNaturalI(const wchar_t* A, const wchar_t* B) noexcept;
+
+    // Creates a sort key for CompareI: comparing two keys as byte strings (memcmp, std::string::compare or operator<)
+    // gives the same order as CompareI on the original strings, so a big sort only folds the case once per string.
+    // @param Str String view.
+    // @return Binary key (the same length as Str).
+    std::string MakeSortKeyI(const std::string_view Str) noexcept;
+
+    // Creates a sort key for CompareNaturalI (see MakeSortKeyI), the digit runs are encoded by their length and value.
+    // @param Str String view.
+    // @return Binary key.
+    std::string MakeSortKeyNaturalI(const std::string_view Str) noexcept;
+
+    // Sorts string views case-insensitively (the CompareI order). The keys of MakeSortKeyI are built once and then
+    // sorted with an MSD radix sort, both on worker threads for large inputs. The sort is stable.
+    // @param Strings Views to sort in-place.
+    void SortI(std::span<std::string_view> Strings) noexcept;
+
+    // Sorts string views case-insensitively in natural order (the CompareNaturalI order, see SortI).
+    // @param Strings Views to sort in-place.
+    void SortNaturalI(std::span<std::string_view> Strings) noexcept;
+
     // Finds substring position in narrow haystack case-insensitively (English ASCII).
     // @param Haystack Haystack string view.
     // @param Needle Needle string view to find.
@@ -289,7 +400,421 @@ namespace xstrtool
     // @return Position if found; std::wstring::npos otherwise.
     std::size_t findI(const wchar_t* Haystack, const wchar_t* Needle, const std::size_t Pos = 0) noexcept;
 
-    // Finds last substring position in haystack case-insensitively (English ASCII).
+    // How FindAll and Count go on after a match.
+    enum class match_mode : std::uint8_t
+    {   NON_OVERLAPPING         // The next match starts after the end of the previous one
+    ,   OVERLAPPING             // The next match can start one position after the previous one
+    };
+
+    // Substring searcher built once per needle and reused for many haystacks, see Finder and FinderI.
+    // It keeps the needle (folded when ignoring case) and two of its rarest bytes as anchors, the SIMD kernels
+    // compare a whole block of positions against both anchors at once and only verify the positions where both
+    // match. Needles longer than 64 bytes use the Two-Way algorithm (with the anchors as a prefilter) so the search
+    // stays linear.
+    template< bool T_IGNORE_CASE_V >
+    class BasicFinder
+    {
+    public:
+        // Creates a finder with an empty needle, which never matches.
+        BasicFinder() noexcept = default;
+
+        // Copies (and folds) the needle and prepares the search.
+        // @param Needle Needle string view to find.
+        explicit BasicFinder(const std::string_view Needle) noexcept;
+
+        // Finds the needle in a haystack, the same result as Find/findI.
+        // @param Haystack Haystack string view.
+        // @param Pos Starting position (default 0).
+        // @return Position if found; std::string::npos otherwise (or if the needle is empty).
+        std::size_t Find(const std::string_view Haystack, const std::size_t Pos = 0) const noexcept;
+
+        // Checks whether a haystack contains the needle, the same result as Contains/ContainsI.
+        // @param Haystack Haystack string view.
+        // @return True if found (or if the needle is empty).
+        bool Contains(const std::string_view Haystack) const noexcept
+        {
+            return m_Needle.empty() || Find(Haystack) != std::string::npos;
+        }
+
+        // Counts the matches in a haystack. Needles of one or two bytes are counted with a popcount of the SIMD
+        // match masks, longer ones count the candidates that verify (the non overlapping count falls back to
+        // a Find loop only when the needle can overlap itself).
+        // @param Haystack Haystack string view.
+        // @param Mode Whether matches can overlap (default NON_OVERLAPPING).
+        // @return Number of matches, 0 for an empty needle.
+        std::size_t Count(const std::string_view Haystack, const match_mode Mode = match_mode::NON_OVERLAPPING) const noexcept;
+
+        // @return The needle, lowercase when ignoring case.
+        const std::string& Needle() const noexcept { return m_Needle; }
+
+        // @return Length of the needle.
+        std::size_t size() const noexcept { return m_Needle.size(); }
+
+    private:
+        std::string     m_Needle;           // Folded when ignoring case
+        std::size_t     m_Anchor1 = 0;      // Offset of the rarest byte
+        std::size_t     m_Anchor2 = 0;      // Offset of the second anchor
+        std::size_t     m_Split   = 0;      // Two-Way critical factorization, only for long needles
+        std::size_t     m_Period  = 0;      // Two-Way shift after the right half matched
+        std::size_t     m_Memory  = 0;      // Two-Way prefix known to match after that shift (periodic needles)
+    };
+
+    // Case-sensitive precompiled searcher.
+    using Finder = BasicFinder<false>;
+
+    // Case-insensitive precompiled searcher (English ASCII).
+    using FinderI = BasicFinder<true>;
+
+    // Finds substring position in narrow haystack (case-sensitive), with the SIMD anchor search of Finder.
+    // Prefer a Finder when the same needle is searched many times.
+    // @param Haystack Haystack string view.
+    // @param Needle Needle string view to find.
+    // @param Pos Starting position (default 0).
+    // @return Position if found; std::string::npos otherwise (or if Needle is empty).
+    std::size_t Find(const std::string_view Haystack, const std::string_view Needle, const std::size_t Pos = 0) noexcept;
+
+    // Lazy range of the match positions of a needle, see FindAll and FindAllI. It owns its finder and views the
+    // haystack (which must outlive the range), every increment runs the SIMD search from the previous match,
+    // so the matches are produced as they are consumed. It works with range-for and std::ranges.
+    template< bool T_IGNORE_CASE_V >
+    class BasicMatchRange
+    {
+    public:
+        class iterator
+        {
+        public:
+            using iterator_concept  = std::forward_iterator_tag;
+            using iterator_category = std::forward_iterator_tag;
+            using value_type        = std::size_t;
+            using difference_type   = std::ptrdiff_t;
+
+            iterator() noexcept = default;
+
+            // @return Position of the current match.
+            std::size_t operator*() const noexcept { return m_Pos; }
+
+            iterator& operator++() noexcept
+            {
+                m_Pos = m_pRange->Next(m_Pos);
+                return *this;
+            }
+
+            iterator operator++(int) noexcept
+            {
+                const iterator Old = *this;
+                ++*this;
+                return Old;
+            }
+
+            bool operator==(const iterator& Other) const noexcept { return m_Pos == Other.m_Pos; }
+            bool operator==(std::default_sentinel_t) const noexcept { return m_Pos == std::string::npos; }
+
+        private:
+            friend class BasicMatchRange;
+            iterator(const BasicMatchRange* pRange, const std::size_t Pos) noexcept : m_pRange{ pRange }, m_Pos{ Pos } {}
+
+            const BasicMatchRange*  m_pRange = nullptr;
+            std::size_t             m_Pos    = std::string::npos;
+        };
+
+        // @param Haystack Haystack string view.
+        // @param Finder Prepared needle (it is copied).
+        // @param Mode Whether matches can overlap.
+        BasicMatchRange(const std::string_view Haystack, const BasicFinder<T_IGNORE_CASE_V>& Finder, const match_mode Mode) noexcept
+            : m_Finder{ Finder }, m_Haystack{ Haystack }, m_Mode{ Mode } {}
+
+        // @param Haystack Haystack string view.
+        // @param Needle Needle string view to find.
+        // @param Mode Whether matches can overlap.
+        BasicMatchRange(const std::string_view Haystack, const std::string_view Needle, const match_mode Mode) noexcept
+            : m_Finder{ Needle }, m_Haystack{ Haystack }, m_Mode{ Mode } {}
+
+        // Finds the first match.
+        iterator begin() const noexcept { return { this, m_Finder.Find(m_Haystack) }; }
+
+        std::default_sentinel_t end() const noexcept { return {}; }
+
+    private:
+        std::size_t Next(const std::size_t Pos) const noexcept
+        {
+            const std::size_t Step = (m_Mode == match_mode::OVERLAPPING) ? 1 : m_Finder.size();
+            return (Pos + Step <= m_Haystack.size()) ? m_Finder.Find(m_Haystack, Pos + Step) : std::string::npos;
+        }
+
+        BasicFinder<T_IGNORE_CASE_V>    m_Finder;
+        std::string_view                m_Haystack;
+        match_mode                      m_Mode;
+    };
+
+    // Case-sensitive lazy match range.
+    using MatchRange = BasicMatchRange<false>;
+
+    // Case-insensitive lazy match range (English ASCII).
+    using MatchRangeI = BasicMatchRange<true>;
+
+    // Lazily finds every position of a needle in a haystack (case-sensitive).
+    // @param Haystack Haystack string view, it must outlive the range.
+    // @param Needle Needle string view to find (an empty needle has no matches).
+    // @param Mode Whether matches can overlap (default NON_OVERLAPPING).
+    // @return Range of the match positions.
+    inline MatchRange FindAll(const std::string_view Haystack, const std::string_view Needle, const match_mode Mode = match_mode::NON_OVERLAPPING) noexcept
+    {
+        return MatchRange(Haystack, Needle, Mode);
+    }
+
+    // Lazily finds every position of a needle in a haystack case-insensitively (English ASCII).
+    // @param Haystack Haystack string view, it must outlive the range.
+    // @param Needle Needle string view to find (an empty needle has no matches).
+    // @param Mode Whether matches can overlap (default NON_OVERLAPPING).
+    // @return Range of the match positions.
+    inline MatchRangeI FindAllI(const std::string_view Haystack, const std::string_view Needle, const match_mode Mode = match_mode::NON_OVERLAPPING) noexcept
+    {
+        return MatchRangeI(Haystack, Needle, Mode);
+    }
+
+    // Counts the matches of a needle in a haystack (case-sensitive), see BasicFinder::Count.
+    // @param Haystack Haystack string view.
+    // @param Needle Needle string view to count.
+    // @param Mode Whether matches can overlap (default NON_OVERLAPPING).
+    // @return Number of matches, 0 for an empty needle.
+    std::size_t Count(const std::string_view Haystack, const std::string_view Needle, const match_mode Mode = match_mode::NON_OVERLAPPING) noexcept;
+
+    // Counts the matches of a needle in a haystack case-insensitively (English ASCII), see BasicFinder::Count.
+    // @param Haystack Haystack string view.
+    // @param Needle Needle string view to count.
+    // @param Mode Whether matches can overlap (default NON_OVERLAPPING).
+    // @return Number of matches, 0 for an empty needle.
+    std::size_t CountI(const std::string_view Haystack, const std::string_view Needle, const match_mode Mode = match_mode::NON_OVERLAPPING) noexcept;
+
+    // Backward counterpart of BasicFinder: finds the last match at or before a position, see ReverseFinder
+    // and ReverseFinderI. The SIMD kernels walk the haystack from its end one block at a time and visit the
+    // candidates of a block from the highest lane down, so the first candidate that verifies is the answer.
+    // Needles longer than 64 bytes use Two-Way on the reversed needle, with the anchors of its last 32 bytes
+    // as a prefilter.
+    template< bool T_IGNORE_CASE_V >
+    class BasicReverseFinder
+    {
+    public:
+        // Creates a reverse finder with an empty needle, which never matches.
+        BasicReverseFinder() noexcept = default;
+
+        // Copies (and folds) the needle and prepares the search.
+        // @param Needle Needle string view to find.
+        explicit BasicReverseFinder(const std::string_view Needle) noexcept;
+
+        // Finds the last occurrence of the needle that starts at or before Pos.
+        // @param Haystack Haystack string view.
+        // @param Pos Last starting position to consider (default std::string::npos, end of Haystack).
+        // @return Position if found; std::string::npos otherwise (or if the needle is empty).
+        std::size_t Find(const std::string_view Haystack, const std::size_t Pos = std::string::npos) const noexcept;
+
+        // Checks whether a haystack contains the needle.
+        // @param Haystack Haystack string view.
+        // @return True if found (or if the needle is empty).
+        bool Contains(const std::string_view Haystack) const noexcept
+        {
+            return m_Needle.empty() || Find(Haystack) != std::string::npos;
+        }
+
+        // @return The needle, lowercase when ignoring case.
+        const std::string& Needle() const noexcept { return m_Needle; }
+
+        // @return Length of the needle.
+        std::size_t size() const noexcept { return m_Needle.size(); }
+
+    private:
+        std::string     m_Needle;           // Folded when ignoring case
+        std::size_t     m_Anchor1 = 0;      // Offset of the rarest byte (in the last 32 bytes for long needles)
+        std::size_t     m_Anchor2 = 0;      // Offset of the second anchor
+        std::size_t     m_Split   = 0;      // Two-Way factorization of the reversed needle, only for long needles
+        std::size_t     m_Period  = 0;      // Two-Way shift after the right half matched
+        std::size_t     m_Memory  = 0;      // Two-Way prefix known to match after that shift (periodic needles)
+    };
+
+    // Case-sensitive precompiled backward searcher.
+    using ReverseFinder = BasicReverseFinder<false>;
+
+    // Case-insensitive precompiled backward searcher (English ASCII), the same result as rfindI.
+    using ReverseFinderI = BasicReverseFinder<true>;
+
+    // A match of a multi-pattern search.
+    struct pattern_match
+    {
+        std::size_t     m_Offset    = std::string::npos;    // Position in the haystack, npos when nothing matched
+        std::size_t     m_PatternId = 0;                    // Index of the pattern in the list the matcher was built from
+    };
+
+    // Multi-pattern searcher, built once for a list of patterns and reused for many haystacks, see MultiFinder
+    // and MultiFinderI. Every haystack is read once whatever the number of patterns. Up to 32 patterns are
+    // searched with a Teddy front end: SIMD nibble tables of the first (up to) three pattern bytes give the
+    // candidate positions and the patterns of each candidate bucket are verified. Larger sets use an Aho-Corasick
+    // automaton with the transitions stored per byte class (only the bytes that appear in the patterns get a class)
+    // to keep the table small. Empty patterns never match.
+    template< bool T_IGNORE_CASE_V >
+    class BasicMultiFinder
+    {
+    public:
+        // Creates a matcher without patterns, which never matches.
+        BasicMultiFinder() noexcept = default;
+
+        // Copies (and folds) the patterns and builds the matcher.
+        // @param Patterns Patterns to find, their index is the pattern id of a match.
+        explicit BasicMultiFinder(std::span<const std::string_view> Patterns) noexcept;
+
+        // Finds the leftmost match, the longest pattern when several start there (then the lowest id).
+        // @param Haystack Haystack string view.
+        // @param Pos Starting position (default 0).
+        // @return The match; its m_Offset is std::string::npos if nothing matched.
+        pattern_match Find(const std::string_view Haystack, const std::size_t Pos = 0) const noexcept;
+
+        // Checks whether any pattern occurs in a haystack.
+        // @param Haystack Haystack string view.
+        // @return True if a pattern was found.
+        bool Contains(const std::string_view Haystack) const noexcept
+        {
+            return Find(Haystack).m_Offset != std::string::npos;
+        }
+
+        // Finds every occurrence of every pattern (they may overlap).
+        // @param Haystack Haystack string view.
+        // @param Matches Output, cleared first, sorted by offset then by pattern id.
+        void FindAll(const std::string_view Haystack, std::vector<pattern_match>& Matches) const noexcept;
+
+        // @param Id Pattern id.
+        // @return The pattern, lowercase when ignoring case.
+        const std::string& Pattern(const std::size_t Id) const noexcept { return m_Patterns[Id]; }
+
+        // @return Number of patterns.
+        std::size_t size() const noexcept { return m_Patterns.size(); }
+
+    private:
+        std::vector<std::string>    m_Patterns;                 // Folded when ignoring case
+        std::size_t                 m_MaxLen        = 0;
+        bool                        m_bTeddy        = false;
+
+        // Teddy
+        std::uint8_t                m_TeddyMasks[96]  = {};     // Low and high nibble tables (16 + 16 entries) of each fingerprint byte, one bit per bucket
+        std::size_t                 m_FingerprintLen  = 0;      // 1 to 3 bytes
+        std::uint32_t               m_BucketBegin[9]  = {};     // Bucket b has the ids m_BucketIds[m_BucketBegin[b], m_BucketBegin[b + 1])
+        std::vector<std::uint32_t>  m_BucketIds;
+
+        // Aho-Corasick
+        std::uint8_t                m_ByteClass[256]  = {};     // Class 0 is every byte that is in no pattern
+        std::size_t                 m_ClassCount      = 1;
+        std::vector<std::uint32_t>  m_Transitions;              // [State * m_ClassCount + Class], a complete DFA
+        std::vector<std::uint32_t>  m_OutputBegin;              // State s matches m_Outputs[m_OutputBegin[s], m_OutputBegin[s + 1])
+        std::vector<std::uint32_t>  m_Outputs;                  // Pattern ids, longest first
+    };
+
+    // Case-sensitive multi-pattern searcher.
+    using MultiFinder = BasicMultiFinder<false>;
+
+    // Case-insensitive multi-pattern searcher (English ASCII).
+    using MultiFinderI = BasicMultiFinder<true>;
+
+    // Finds the leftmost occurrence of any of the patterns (case-sensitive), see BasicMultiFinder::Find.
+    // It builds a matcher on every call, prefer a MultiFinder when the same patterns are searched many times.
+    // @param Haystack Haystack string view.
+    // @param Patterns Patterns to find.
+    // @param Pos Starting position (default 0).
+    // @return The match (pattern id and offset); its m_Offset is std::string::npos if nothing matched.
+    pattern_match FindAny(const std::string_view Haystack, std::span<const std::string_view> Patterns, const std::size_t Pos = 0) noexcept;
+
+    // Finds the leftmost occurrence of any of the patterns case-insensitively (English ASCII), see FindAny.
+    // @param Haystack Haystack string view.
+    // @param Patterns Patterns to find.
+    // @param Pos Starting position (default 0).
+    // @return The match (pattern id and offset); its m_Offset is std::string::npos if nothing matched.
+    pattern_match FindAnyI(const std::string_view Haystack, std::span<const std::string_view> Patterns, const std::size_t Pos = 0) noexcept;
+
+    // Searches a stream that arrives in chunks (file reads, socket packets) without buffering it, see StreamFinder
+    // and StreamFinderI. It searches for one needle (a Finder) or a set of patterns (a MultiFinder), and reports
+    // every occurrence (they may overlap) once, in the call that receives its last byte, at its offset from the
+    // start of the stream (so a long match can come after shorter ones that start later). Only the last
+    // longest-pattern-minus-one bytes of the stream are kept between chunks: a match that straddles a boundary is
+    // found in those bytes plus the start of the next chunk, everything else is searched in place in the caller's chunk.
+    template< bool T_IGNORE_CASE_V >
+    class BasicStreamFinder
+    {
+    public:
+        // Creates a stream finder without patterns, which never matches.
+        BasicStreamFinder() noexcept = default;
+
+        // Searches the stream for a single needle, the pattern id of its matches is 0.
+        // @param Needle Needle string view to find.
+        explicit BasicStreamFinder(const std::string_view Needle) noexcept;
+
+        // Searches the stream for any of the patterns.
+        // @param Patterns Patterns to find, their index is the pattern id of a match.
+        explicit BasicStreamFinder(std::span<const std::string_view> Patterns) noexcept;
+
+        // Searches the next chunk of the stream.
+        // @param Chunk Next bytes of the stream, the finder does not keep a reference to it.
+        // @param Matches Output, cleared first, the matches that end in this chunk sorted by offset then by pattern id.
+        //                Offsets are from the start of the stream.
+        void Feed(const std::string_view Chunk, std::vector<pattern_match>& Matches) noexcept;
+
+        // Forgets the stream so the next Feed starts a new one at offset 0.
+        void Reset() noexcept;
+
+        // @return Number of stream bytes fed so far.
+        std::size_t Offset() const noexcept { return m_Offset; }
+
+    private:
+        BasicFinder<T_IGNORE_CASE_V>        m_Finder;
+        BasicMultiFinder<T_IGNORE_CASE_V>   m_MultiFinder;
+        bool                                m_bMulti    = false;
+        std::size_t                         m_Keep      = 0;        // Longest pattern minus one, bytes kept between chunks
+        std::size_t                         m_Offset    = 0;        // Stream offset of the end of the last chunk
+        std::string                         m_Tail;                 // Last m_Keep bytes of the stream (fewer at its start)
+        std::vector<pattern_match>          m_Scratch;              // Matches around the chunk boundary
+    };
+
+    // Case-sensitive stream searcher.
+    using StreamFinder = BasicStreamFinder<false>;
+
+    // Case-insensitive stream searcher (English ASCII).
+    using StreamFinderI = BasicStreamFinder<true>;
+
+    // Options of SearchFile.
+    struct search_options
+    {
+        std::size_t                 m_MaxMatches    = 0;        // Stop after this many matches (the first ones in the file), 0 for no limit
+        bool                        m_bIgnoreCase   = true;     // Search like findI (English ASCII), otherwise like Find
+        const std::atomic<bool>*    m_pStop         = nullptr;  // Optional, another thread can set it to stop the search early
+    };
+
+    // A match of SearchFile.
+    struct file_match
+    {
+        std::size_t                 m_Line          = 0;        // Line number, starting at 1
+        std::size_t                 m_Column        = 0;        // Offset of the match in its line
+        std::string_view            m_LineView;                 // The line without its end of line ("\n" or "\r\n")
+    };
+
+    // Result of SearchFile. The line views point into the mapped file, which stays mapped as long as
+    // the result (or a copy of it) is alive.
+    struct file_search_result
+    {
+        std::vector<file_match>     m_Matches;                  // Ordered by line, then by column
+        bool                        m_bOpened       = false;    // False if the file could not be opened or mapped
+        bool                        m_bStopped      = false;    // True if m_pStop ended the search, the matches are the ones found before the first shard that did not finish
+        std::shared_ptr<const char> m_pData;                    // The mapped file
+    };
+
+    // Searches a file for a needle, grep style. The file is memory mapped (never read into a string) and split in
+    // line aligned shards of about 1 MB, which are searched by all the cores with the SIMD anchor search of
+    // Finder/FinderI. Matches are the non overlapping occurrences inside a line (a needle with a new line never
+    // matches) and each shard also counts its lines, so the line numbers come from a prefix sum of those counts.
+    // When m_MaxMatches is reached by a shard the shards after it are abandoned.
+    // @param Path Path of the file.
+    // @param Needle Needle string view to find.
+    // @param Options Case, match limit and stop flag.
+    // @return The matches, and the mapping that their line views point into.
+    file_search_result SearchFile(const std::string_view Path, const std::string_view Needle, const search_options& Options = {}) noexcept;
+
+    // Finds last substring position in haystack case-insensitively (English ASCII), with the backward SIMD
+    // anchor search of ReverseFinderI. Prefer a ReverseFinderI when the same needle is searched many times.
     // @param Haystack Haystack string view.
     // @param Needle Needle string view to find.
     // @param Pos Starting position for reverse search (default std::string::npos, end of Haystack).
@@ -365,6 +890,74 @@ namespace xstrtool
     // @return True if ends with; false otherwise.
     bool EndsWithI(const wchar_t* Haystack, const wchar_t* Needle) noexcept;
 
+    // A set of prefixes (or suffixes) compiled into a trie so that finding the ones a string starts (ends) with
+    // costs O(length of the string) whatever the number of entries, see PrefixSetI and SuffixSetI. Entries are
+    // folded (English ASCII) and suffixes are stored reversed. The nodes are laid out breadth first with the
+    // children of a node next to each other, so a node is three words and its child labels are one contiguous
+    // run of bytes that the SIMD kernels compare 16 at a time.
+    template< bool T_SUFFIX_V >
+    class BasicAffixSetI
+    {
+    public:
+        // Creates an empty set, which never matches.
+        BasicAffixSetI() noexcept = default;
+
+        // Builds the trie.
+        // @param Entries Prefixes (suffixes), their index is the id returned by Match. An empty entry matches every string.
+        explicit BasicAffixSetI(std::span<const std::string_view> Entries) noexcept;
+
+        // Finds the longest entry that is a prefix (suffix) of a string case-insensitively (English ASCII).
+        // @param Str String view to test.
+        // @return Id of the longest matching entry (the lowest id when entries only differ by case); std::string::npos if none.
+        std::size_t Match(const std::string_view Str) const noexcept;
+
+        // @return Number of entries.
+        std::size_t size() const noexcept { return m_Count; }
+
+    private:
+        std::vector<std::uint32_t>  m_Nodes;            // 3 words per node: first child, child count, entry id (~0u for none)
+        std::vector<char>           m_Labels;           // Folded byte that leads to each node, padded for whole SIMD loads
+        std::size_t                 m_Count = 0;
+    };
+
+    // Compiled case-insensitive prefix set.
+    using PrefixSetI = BasicAffixSetI<false>;
+
+    // Compiled case-insensitive suffix set.
+    using SuffixSetI = BasicAffixSetI<true>;
+
+    // Finds the longest prefix of a set that a string starts with case-insensitively (English ASCII), see BasicAffixSetI.
+    // @param Str String view to test.
+    // @param Prefixes Compiled prefixes.
+    // @return Id of the longest matching prefix; std::string::npos if none.
+    inline std::size_t StartsWithAnyI(const std::string_view Str, const PrefixSetI& Prefixes) noexcept
+    {
+        return Prefixes.Match(Str);
+    }
+
+    // Finds the longest prefix of a list that a string starts with case-insensitively (English ASCII).
+    // It builds a PrefixSetI on every call, prefer one when the same prefixes are tested many times.
+    // @param Str String view to test.
+    // @param Prefixes Prefixes to test.
+    // @return Index of the longest matching prefix; std::string::npos if none.
+    std::size_t StartsWithAnyI(const std::string_view Str, std::span<const std::string_view> Prefixes) noexcept;
+
+    // Finds the longest suffix of a set that a string ends with case-insensitively (English ASCII), see BasicAffixSetI.
+    // @param Str String view to test.
+    // @param Suffixes Compiled suffixes.
+    // @return Id of the longest matching suffix; std::string::npos if none.
+    inline std::size_t EndsWithAnyI(const std::string_view Str, const SuffixSetI& Suffixes) noexcept
+    {
+        return Suffixes.Match(Str);
+    }
+
+    // Finds the longest suffix of a list that a string ends with case-insensitively (English ASCII).
+    // It builds a SuffixSetI on every call, prefer one when the same suffixes are tested many times.
+    // @param Str String view to test.
+    // @param Suffixes Suffixes to test.
+    // @return Index of the longest matching suffix; std::string::npos if none.
+    std::size_t EndsWithAnyI(const std::string_view Str, std::span<const std::string_view> Suffixes) noexcept;
+
     // Checks if narrow haystack contains needle case-insensitively (English ASCII).
     // @param Haystack Haystack string view.
     // @param Needle Needle string view.
@@ -377,6 +970,29 @@ namespace xstrtool
     // @return True if contains; false otherwise.
     bool ContainsI(const char* Haystack, const char* Needle) noexcept;
 
+    // Haystacks smaller than this are searched on the calling thread by ParallelFindI/ParallelContainsI.
+    constexpr std::size_t ParallelSearchThreshold_v = 4 * 1024 * 1024;
+
+    // Finds substring position in a large narrow haystack case-insensitively (English ASCII) with all the cores.
+    // The haystack is split in blocks of candidate positions that the threads take in order, each block is searched
+    // together with the needle length minus one bytes after it so a match across two blocks is not missed. Once a
+    // match is found the blocks after it are skipped (the ones before still finish), so the result is the first
+    // match, the same as findI.
+    // @param Haystack Haystack string view.
+    // @param Needle Needle string view to find.
+    // @param Pos Starting position (default 0).
+    // @param Threshold Haystacks (from Pos) smaller than this use findI directly (default ParallelSearchThreshold_v).
+    // @return Position if found; std::string::npos otherwise.
+    std::size_t ParallelFindI(const std::string_view Haystack, const std::string_view Needle, const std::size_t Pos = 0, const std::size_t Threshold = ParallelSearchThreshold_v) noexcept;
+
+    // Checks if a large narrow haystack contains needle case-insensitively (English ASCII) with all the cores,
+    // see ParallelFindI. Every thread stops as soon as any of them finds a match.
+    // @param Haystack Haystack string view.
+    // @param Needle Needle string view.
+    // @param Threshold Haystacks smaller than this use ContainsI directly (default ParallelSearchThreshold_v).
+    // @return True if contains; false otherwise.
+    bool ParallelContainsI(const std::string_view Haystack, const std::string_view Needle, const std::size_t Threshold = ParallelSearchThreshold_v) noexcept;
+
     // Checks if wide haystack contains needle case-insensitively (English ASCII).
     // @param Haystack Haystack wide string view.
     // @param Needle Needle wide string view.
@@ -521,6 +1137,416 @@ namespace xstrtool
     // @return Vector of wide string views (no copies).
     std::vector<std::wstring_view> Split(const wchar_t* Input, const wchar_t* Delim) noexcept;
 
+    // Lazy view over the parts of a string split by a delimiter, see SplitRange and SplitRangeW. It produces the same
+    // parts as Split without building a vector. The iterator keeps the delimiter bit mask of a 64-character window
+    // (built by the SIMD kernels), so the parts inside one window only cost a bit scan; a string delimiter uses the
+    // window mask of its first character and verifies the rest. The input (and a string delimiter) must outlive the
+    // range. It works with range-for and std::ranges.
+    template< typename T_CHAR >
+    class BasicSplitRange
+    {
+    public:
+        using view = std::basic_string_view<T_CHAR>;
+
+        class iterator
+        {
+        public:
+            using iterator_concept  = std::forward_iterator_tag;
+            using iterator_category = std::forward_iterator_tag;
+            using value_type        = view;
+            using difference_type   = std::ptrdiff_t;
+
+            iterator() noexcept = default;
+
+            // @return Current part (no copy).
+            view operator*() const noexcept { return m_pRange->m_Input.substr(m_Start, m_End - m_Start); }
+
+            iterator& operator++() noexcept
+            {
+                // The last part is the only one that ends at the end of the input
+                if (m_End == m_pRange->m_Input.size())
+                {
+                    m_Start = std::string::npos;
+                }
+                else
+                {
+                    m_Start = m_End + 1 + m_pRange->m_Tail.size();
+                    m_End   = NextDelimiter(m_Start);
+                }
+                return *this;
+            }
+
+            iterator operator++(int) noexcept
+            {
+                const iterator Old = *this;
+                ++*this;
+                return Old;
+            }
+
+            bool operator==(const iterator& Other) const noexcept { return m_Start == Other.m_Start; }
+            bool operator==(std::default_sentinel_t) const noexcept { return m_Start == std::string::npos; }
+
+        private:
+            friend class BasicSplitRange;
+            explicit iterator(const BasicSplitRange* pRange) noexcept : m_pRange{ pRange }, m_Start{ 0 } { m_End = NextDelimiter(0); }
+
+            // Takes the next delimiter at or after From from the window mask (npos when the window has no more)
+            std::size_t PopDelimiter(const std::size_t From) noexcept
+            {
+                while (m_Mask)
+                {
+                    const std::size_t Pos = m_Base + static_cast<std::size_t>(std::countr_zero(m_Mask));
+                    m_Mask &= m_Mask - 1;
+                    if (Pos >= From && m_pRange->IsDelimiterAt(Pos)) return Pos;
+                }
+                return std::string::npos;
+            }
+
+            // @return Position of the next delimiter at or after From, or the size of the input.
+            std::size_t NextDelimiter(const std::size_t From) noexcept
+            {
+                const std::size_t Pos = PopDelimiter(From);
+                return (Pos != std::string::npos) ? Pos : ScanDelimiter(From);
+            }
+
+            // Loads the masks of the next windows until one has a delimiter at or after From
+            std::size_t ScanDelimiter(const std::size_t From) noexcept;
+
+            const BasicSplitRange*  m_pRange = nullptr;
+            std::size_t             m_Start  = std::string::npos;   // Current part, npos past the last one
+            std::size_t             m_End    = 0;
+            std::size_t             m_Base   = 0;                   // Window of m_Mask
+            std::size_t             m_Next   = 0;                   // End of the scanned windows
+            std::uint64_t           m_Mask   = 0;                   // Delimiters of the window not taken yet
+        };
+
+        BasicSplitRange() noexcept = default;
+
+        // @param Input Input string view.
+        // @param Delim Delimiter character.
+        BasicSplitRange(const view Input, const T_CHAR Delim) noexcept
+            : m_Input{ Input }, m_First{ Delim } {}
+
+        // @param Input Input string view.
+        // @param Delim Delimiter string view (must not be empty).
+        BasicSplitRange(const view Input, const view Delim) noexcept
+            : m_Input{ Input }, m_Tail{ Delim.substr(Delim.empty() ? 0 : 1) }, m_First{ Delim.empty() ? T_CHAR{} : Delim[0] }
+        {
+            assert(!Delim.empty() && "Delimiter string is empty");
+        }
+
+        // Finds the end of the first part.
+        iterator begin() const noexcept { return iterator{ this }; }
+
+        std::default_sentinel_t end() const noexcept { return {}; }
+
+    private:
+        bool IsDelimiterAt(const std::size_t Pos) const noexcept
+        {
+            return m_Tail.empty() || (m_Input.size() - Pos > m_Tail.size() && m_Input.substr(Pos + 1, m_Tail.size()) == m_Tail);
+        }
+
+        view    m_Input;
+        view    m_Tail;     // Delimiter after its first character
+        T_CHAR  m_First{};
+    };
+
+    // Lazily splits narrow string_view by char delimiter (same parts as Split).
+    // @param InputView Input string view, it must outlive the range.
+    // @param Delim Delimiter character.
+    // @return Range of string views (no copies, no allocation).
+    inline BasicSplitRange<char> SplitRange(const std::string_view InputView, const char Delim) noexcept
+    {
+        return { InputView, Delim };
+    }
+
+    // Lazily splits narrow string_view by string delimiter (same parts as Split).
+    // @param InputView Input string view, it must outlive the range.
+    // @param Delim Delimiter string view (must not be empty), it must outlive the range.
+    // @return Range of string views (no copies, no allocation).
+    inline BasicSplitRange<char> SplitRange(const std::string_view InputView, const std::string_view Delim) noexcept
+    {
+        return { InputView, Delim };
+    }
+
+    // Lazily splits wide string_view by wchar_t delimiter (same parts as Split).
+    // @param InputView Input wide string view, it must outlive the range.
+    // @param Delim Delimiter wide character.
+    // @return Range of wide string views (no copies, no allocation).
+    inline BasicSplitRange<wchar_t> SplitRangeW(const std::wstring_view InputView, const wchar_t Delim) noexcept
+    {
+        return { InputView, Delim };
+    }
+
+    // Lazily splits wide string_view by wide string delimiter (same parts as Split).
+    // @param InputView Input wide string view, it must outlive the range.
+    // @param Delim Delimiter wide string view (must not be empty), it must outlive the range.
+    // @return Range of wide string views (no copies, no allocation).
+    inline BasicSplitRange<wchar_t> SplitRangeW(const std::wstring_view InputView, const std::wstring_view Delim) noexcept
+    {
+        return { InputView, Delim };
+    }
+
+    // Counts the parts Split would return (the delimiters plus one) with a popcount of the SIMD delimiter masks.
+    // @param InputView Input string view.
+    // @param Delim Delimiter character.
+    // @return Number of parts, at least 1.
+    std::size_t CountSplits(const std::string_view InputView, const char Delim) noexcept;
+
+    // Counts the parts Split would return for a string delimiter (non overlapping delimiters plus one).
+    // @param InputView Input string view.
+    // @param Delim Delimiter string view (must not be empty).
+    // @return Number of parts, at least 1.
+    std::size_t CountSplits(const std::string_view InputView, const std::string_view Delim) noexcept;
+
+    // Counts the parts Split would return (the delimiters plus one) with a popcount of the SIMD delimiter masks.
+    // @param InputView Input wide string view.
+    // @param Delim Delimiter wide character.
+    // @return Number of parts, at least 1.
+    std::size_t CountSplits(const std::wstring_view InputView, const wchar_t Delim) noexcept;
+
+    // Counts the parts Split would return for a wide string delimiter (non overlapping delimiters plus one).
+    // @param InputView Input wide string view.
+    // @param Delim Delimiter wide string view (must not be empty).
+    // @return Number of parts, at least 1.
+    std::size_t CountSplits(const std::wstring_view InputView, const std::wstring_view Delim) noexcept;
+
+    // Splits narrow string_view by char delimiter into caller storage (same parts as Split, nothing is allocated).
+    // When the span is too small it gets the first Parts.size() parts and the result is the number of parts it
+    // needed, so a result larger than Parts.size() flags the overflow (as with CountSplits, the storage can be sized first).
+    // @param Parts Storage for the parts.
+    // @param InputView Input string view.
+    // @param Delim Delimiter character.
+    // @return Number of parts of the input, larger than Parts.size() if they did not fit.
+    std::size_t SplitInto(const std::span<std::string_view> Parts, const std::string_view InputView, const char Delim) noexcept;
+
+    // Splits narrow string_view by string delimiter into caller storage, see SplitInto for char delimiters.
+    // @param Parts Storage for the parts.
+    // @param InputView Input string view.
+    // @param Delim Delimiter string view (must not be empty).
+    // @return Number of parts of the input, larger than Parts.size() if they did not fit.
+    std::size_t SplitInto(const std::span<std::string_view> Parts, const std::string_view InputView, const std::string_view Delim) noexcept;
+
+    // Splits wide string_view by wchar_t delimiter into caller storage, see SplitInto for char delimiters.
+    // @param Parts Storage for the parts.
+    // @param InputView Input wide string view.
+    // @param Delim Delimiter wide character.
+    // @return Number of parts of the input, larger than Parts.size() if they did not fit.
+    std::size_t SplitInto(const std::span<std::wstring_view> Parts, const std::wstring_view InputView, const wchar_t Delim) noexcept;
+
+    // Splits wide string_view by wide string delimiter into caller storage, see SplitInto for char delimiters.
+    // @param Parts Storage for the parts.
+    // @param InputView Input wide string view.
+    // @param Delim Delimiter wide string view (must not be empty).
+    // @return Number of parts of the input, larger than Parts.size() if they did not fit.
+    std::size_t SplitInto(const std::span<std::wstring_view> Parts, const std::wstring_view InputView, const std::wstring_view Delim) noexcept;
+
+    class CharSet;
+
+    // Splits narrow string_view at every character of a set (same parts as Split with each of the characters).
+    // @param InputView Input string view.
+    // @param Delims Delimiter characters.
+    // @return Vector of string views (no copies).
+    std::vector<std::string_view> SplitAny(const std::string_view InputView, const CharSet& Delims) noexcept;
+
+    // Splits wide string_view at every character of a set (same parts as Split with each of the characters).
+    // @param InputView Input wide string view.
+    // @param Delims Delimiter characters.
+    // @return Vector of wide string views (no copies).
+    std::vector<std::wstring_view> SplitAny(const std::wstring_view InputView, const CharSet& Delims) noexcept;
+
+    // Set of characters compiled for the SIMD set search of FindFirstOf, FindLastOf, FindFirstNotOf and SplitAny.
+    // The 256 possible bytes are kept as two 16 byte PSHUFB tables indexed by the low nibble (one for the bytes
+    // below 0x80 and one for the others) whose bits select the high nibble, so any set of bytes costs three
+    // shuffles per block, the same as a single character. Wide searches use the tables for U+0000-U+00FF, a set
+    // with wider characters keeps them in a list and its wide searches take the scalar path.
+    class CharSet
+    {
+    public:
+        // Creates an empty set.
+        CharSet() noexcept = default;
+
+        // @param Chars Characters of the set (bytes, duplicates are fine).
+        explicit CharSet(const std::string_view Chars) noexcept;
+
+        // @param Chars Wide characters of the set (duplicates are fine).
+        explicit CharSet(const std::wstring_view Chars) noexcept;
+
+        // @return True if the character is in the set.
+        bool Contains(const char C) const noexcept;
+
+        // @return True if the wide character is in the set.
+        bool Contains(const wchar_t C) const noexcept;
+
+        // @param Str String view to search.
+        // @param Pos Position to start from.
+        // @return Position of the first character of the set at or after Pos, or npos.
+        std::size_t Find(const std::string_view Str, const std::size_t Pos = 0) const noexcept;
+
+        // @param Str Wide string view to search.
+        // @param Pos Position to start from.
+        // @return Position of the first character of the set at or after Pos, or npos.
+        std::size_t Find(const std::wstring_view Str, const std::size_t Pos = 0) const noexcept;
+
+        // @param Str String view to search.
+        // @param Pos Position to start from.
+        // @return Position of the first character not in the set at or after Pos, or npos.
+        std::size_t FindNot(const std::string_view Str, const std::size_t Pos = 0) const noexcept;
+
+        // @param Str Wide string view to search.
+        // @param Pos Position to start from.
+        // @return Position of the first character not in the set at or after Pos, or npos.
+        std::size_t FindNot(const std::wstring_view Str, const std::size_t Pos = 0) const noexcept;
+
+        // @param Str String view to search.
+        // @param Pos Last position to consider (default npos for the whole string).
+        // @return Position of the last character of the set at or before Pos, or npos.
+        std::size_t RFind(const std::string_view Str, const std::size_t Pos = std::string::npos) const noexcept;
+
+        // @param Str Wide string view to search.
+        // @param Pos Last position to consider (default npos for the whole string).
+        // @return Position of the last character of the set at or before Pos, or npos.
+        std::size_t RFind(const std::wstring_view Str, const std::size_t Pos = std::string::npos) const noexcept;
+
+    private:
+        friend std::vector<std::string_view>  SplitAny(const std::string_view InputView, const CharSet& Delims) noexcept;
+        friend std::vector<std::wstring_view> SplitAny(const std::wstring_view InputView, const CharSet& Delims) noexcept;
+
+        std::uint8_t            m_Tables[32] = {};      // Byte B is bit (B >> 4) & 7 of m_Tables[(B >> 7) * 16 + (B & 15)]
+        std::vector<wchar_t>    m_Wide;                 // Characters above U+00FF
+    };
+
+    // Finds the first character of a set (narrow).
+    // @param Str String view to search.
+    // @param Set Characters to find.
+    // @param Pos Position to start from (default 0).
+    // @return Position of the first character of the set at or after Pos, or npos.
+    inline std::size_t FindFirstOf(const std::string_view Str, const CharSet& Set, const std::size_t Pos = 0) noexcept
+    {
+        return Set.Find(Str, Pos);
+    }
+
+    // Finds the first character of a set (wide).
+    // @param Str Wide string view to search.
+    // @param Set Characters to find.
+    // @param Pos Position to start from (default 0).
+    // @return Position of the first character of the set at or after Pos, or npos.
+    inline std::size_t FindFirstOf(const std::wstring_view Str, const CharSet& Set, const std::size_t Pos = 0) noexcept
+    {
+        return Set.Find(Str, Pos);
+    }
+
+    // Finds the last character of a set (narrow).
+    // @param Str String view to search.
+    // @param Set Characters to find.
+    // @param Pos Last position to consider (default npos for the whole string).
+    // @return Position of the last character of the set at or before Pos, or npos.
+    inline std::size_t FindLastOf(const std::string_view Str, const CharSet& Set, const std::size_t Pos = std::string::npos) noexcept
+    {
+        return Set.RFind(Str, Pos);
+    }
+
+    // Finds the last character of a set (wide).
+    // @param Str Wide string view to search.
+    // @param Set Characters to find.
+    // @param Pos Last position to consider (default npos for the whole string).
+    // @return Position of the last character of the set at or before Pos, or npos.
+    inline std::size_t FindLastOf(const std::wstring_view Str, const CharSet& Set, const std::size_t Pos = std::string::npos) noexcept
+    {
+        return Set.RFind(Str, Pos);
+    }
+
+    // Finds the first character that is not in a set (narrow).
+    // @param Str String view to search.
+    // @param Set Characters to skip.
+    // @param Pos Position to start from (default 0).
+    // @return Position of the first character not in the set at or after Pos, or npos.
+    inline std::size_t FindFirstNotOf(const std::string_view Str, const CharSet& Set, const std::size_t Pos = 0) noexcept
+    {
+        return Set.FindNot(Str, Pos);
+    }
+
+    // Finds the first character that is not in a set (wide).
+    // @param Str Wide string view to search.
+    // @param Set Characters to skip.
+    // @param Pos Position to start from (default 0).
+    // @return Position of the first character not in the set at or after Pos, or npos.
+    inline std::size_t FindFirstNotOf(const std::wstring_view Str, const CharSet& Set, const std::size_t Pos = 0) noexcept
+    {
+        return Set.FindNot(Str, Pos);
+    }
+
+    // A field of a CsvReader record, a view into the source buffer.
+    struct csv_field
+    {
+        std::string_view            m_Raw;                      // Without its surrounding quotes, "" pairs are still doubled
+        bool                        m_bQuoted       = false;    // The field was in quotes
+        bool                        m_bEscaped      = false;    // m_Raw has "" pairs, Value must unescape it
+
+        // Gives the value of the field, unescaping it only when it has "" pairs.
+        // @param Scratch Storage for the unescaped value (only touched when the field is escaped).
+        // @return m_Raw, or a view of Scratch with every "" turned into ".
+        std::string_view Value(std::string& Scratch) const noexcept;
+    };
+
+    // CSV/TSV reader for a whole memory buffer (RFC 4180 style: '"' quotes, "" escapes a quote, quoted fields can
+    // hold delimiters and newlines). The SIMD kernels classify 64 bytes at a time: the quote bits become a mask of
+    // the quoted bytes with a carry-less prefix XOR (carried from one window to the next) and only the delimiters
+    // and newlines outside of it remain, so the records and fields are found by bit scans without splitting the
+    // buffer into lines first. Records end at '\n' (a "\r\n" end drops the '\r') and a blank line is a record with
+    // one empty field. As in other SIMD CSV parsers, every quote toggles the quoted state, so a stray quote inside
+    // an unquoted field starts a quoted run. The buffer must outlive the reader and the fields.
+    class CsvReader
+    {
+    public:
+        // @param Buffer Whole CSV/TSV text.
+        // @param Delimiter Field delimiter (default ',', '\t' for TSV).
+        explicit CsvReader(const std::string_view Buffer, const char Delimiter = ',') noexcept
+            : m_Buffer{ Buffer }, m_Delimiter{ Delimiter } {}
+
+        // Reads the next record. The fields are kept in the reader, so the span is valid until the next call and
+        // reading does not allocate once the field storage has grown to the widest record.
+        // @param Record Set to the fields of the record.
+        // @return False when there are no more records.
+        bool Next(std::span<const csv_field>& Record) noexcept;
+
+        // @return Offset in the buffer of the next record.
+        std::size_t Offset() const noexcept { return m_Pos; }
+
+    private:
+        std::size_t NextStructural() noexcept;
+
+        std::string_view            m_Buffer;
+        char                        m_Delimiter;
+        std::size_t                 m_Pos       = 0;    // Start of the next record
+        std::size_t                 m_Base      = 0;    // Window of m_Mask
+        std::size_t                 m_Next      = 0;    // End of the scanned windows
+        std::uint64_t               m_Mask      = 0;    // Delimiters and newlines outside quotes not taken yet
+        std::uint64_t               m_Inside    = 0;    // All ones when m_Next is inside quotes
+        std::vector<csv_field>      m_Fields;
+    };
+
+    // Lines of one chunk given to the sink of SplitLinesParallel.
+    struct line_batch
+    {
+        std::size_t                         m_Worker    = 0;    // Thread that found the lines, below max(1, std::thread::hardware_concurrency())
+        std::size_t                         m_FirstLine = 0;    // Line number of m_Lines[0], starting at 1
+        std::span<const std::string_view>   m_Lines;            // Consecutive lines without their end of line ("\n" or "\r\n")
+    };
+
+    // Splits a large buffer into lines with all the cores, without building a vector of all the lines. The buffer
+    // is cut into chunks small enough for a worker's slice (and its line views) to stay in cache. A first parallel
+    // pass counts the new lines of every chunk and their prefix sum gives the number of the first line of each
+    // chunk. A second pass gives each chunk the lines that start in it: the line that crosses the end of a chunk is
+    // finished by reading into the next one, which skips it. A final "\n" does not start an empty line.
+    // @param Buffer Text to split, the line views point into it.
+    // @param Sink Called with the lines of each chunk, from several threads at once (m_Worker tells which, so
+    // per thread state needs no lock). The batches of one worker come in line order, the batches of different
+    // workers in any order. The views of a batch are only valid during the call and the sink must not throw.
+    // @return Number of lines, all of them given to the sink. It throws std::bad_alloc (before any batch is given)
+    // when the line storage of the workers can not be allocated.
+    std::size_t SplitLinesParallel(const std::string_view Buffer, const std::function<void(const line_batch& Batch)>& Sink);
+
     // Joins a range of narrow string-like parts with delimiter.
     // @param T_RANGE Container of string_view compatible types.
     // @param Parts Range to join.
@@ -900,6 +1926,74 @@ namespace xstrtool
     // @param Str Wide path string to modify.
     void PathNormalize(std::wstring& Str) noexcept;
 
+    // Wildcard pattern compiled once and matched against many paths, see Glob and GlobI. The pattern and the paths
+    // are split in components at '/' or '\\' (both are separators, so a path only needs PathNormalizeCopy when it has
+    // "." or ".." parts and a file name from PathBaseName is matched as it is). Inside a component '*' matches any
+    // run of characters, '?' any one character and "[abc]", "[a-z]", "[!a-z]" (or "[^a-z]") one character of the class;
+    // a whole "**" component matches any number of components, including none. The literal runs of a component are
+    // located with the SIMD anchor search of Finder/FinderI, and every '*' or "**" keeps the leftmost placement of
+    // what follows it (which is always a valid choice), so matching never backtracks.
+    template< bool T_IGNORE_CASE_V >
+    class BasicGlob
+    {
+    public:
+        // Creates a pattern without components, which never matches.
+        BasicGlob() noexcept = default;
+
+        // Compiles the pattern. A '[' without a closing ']' is a literal character, an empty pattern only matches an empty path.
+        // @param Pattern Wildcard pattern, such as "**/cache/*.bin".
+        explicit BasicGlob(const std::string_view Pattern) noexcept;
+
+        // Matches a whole path against the pattern.
+        // @param Path Path to test (not modified, nothing is allocated).
+        // @return True if the path matches.
+        bool Match(const std::string_view Path) const noexcept;
+
+    private:
+        // One character of the pattern
+        struct element
+        {
+            enum kind : std::uint8_t { LITERAL, ANY, CLASS };
+            kind            m_Kind;
+            char            m_Char;             // LITERAL, folded when ignoring case
+            std::uint16_t   m_Class;            // CLASS, index of its 256 bits in m_Classes
+        };
+
+        // A run of elements between two '*' of a component
+        struct piece
+        {
+            std::uint32_t                   m_First;            // In m_Elements
+            std::uint32_t                   m_Count;
+            std::uint32_t                   m_LiteralOffset;    // Longest run of literals, found with m_Finder
+            BasicFinder<T_IGNORE_CASE_V>    m_Finder;           // Empty if the piece has no literal
+        };
+
+        struct component
+        {
+            std::uint32_t   m_FirstPiece;
+            std::uint32_t   m_PieceCount;
+            bool            m_bLeadingStar;
+            bool            m_bTrailingStar;
+            bool            m_bGlobStar;        // A "**" component
+        };
+
+        bool        PieceAt         (const piece& Piece, const std::string_view Str, const std::size_t Pos) const noexcept;
+        std::size_t FindPiece       (const piece& Piece, const std::string_view Str, const std::size_t Pos) const noexcept;
+        bool        MatchComponent  (const component& Component, const std::string_view Str) const noexcept;
+        bool        MatchRun        (std::size_t First, const std::size_t Last, const std::string_view Path, std::size_t& Pos) const noexcept;
+
+        std::vector<element>        m_Elements;
+        std::vector<std::uint64_t>  m_Classes;              // 4 words per class
+        std::vector<piece>          m_Pieces;
+        std::vector<component>      m_Components;
+    };
+
+    // Case-sensitive compiled wildcard pattern.
+    using Glob = BasicGlob<false>;
+
+    // Case-insensitive compiled wildcard pattern (English ASCII).
+    using GlobI = BasicGlob<true>;
+
     // Formats a time point to string using std::format.
     // @param Tp Time point.
     // @param Fmt Format string (default "%Y-%m-%d %H:%M:%S").
@@ -963,6 +2057,45 @@ namespace xstrtool
     // @return Hash value.
     std::size_t Hash(const std::string_view Sv) noexcept;
 
+    // Case-insensitive hash functor (English ASCII only, the same folding as CompareI). The case is folded
+    // on the fly inside the SIMD hash loop so no lowered copy is made, and the value does not depend on the SIMD tier.
+    // It is transparent, so together with EqualI a std::unordered_map<std::string, T, xstrtool::HashI, xstrtool::EqualI>
+    // can be probed with a string_view or a const char* without building a std::string.
+    struct HashI
+    {
+        using is_transparent = void;
+
+        // @param Sv String view.
+        // @return Hash value, equal for strings that only differ in case.
+        std::size_t operator()(const std::string_view Sv) const noexcept;
+
+        // @param Sv Wide string view.
+        // @return Hash value, equal for strings that only differ in case.
+        std::size_t operator()(const std::wstring_view Sv) const noexcept;
+    };
+
+    // Case-insensitive equality functor that pairs with HashI (see HashI).
+    struct EqualI
+    {
+        using is_transparent = void;
+
+        // @param A First string view.
+        // @param B Second string view.
+        // @return True if A and B only differ in case.
+        bool operator()(const std::string_view A, const std::string_view B) const noexcept
+        {
+            return A.size() == B.size() && CompareI(A, B) == 0;
+        }
+
+        // @param A First wide string view.
+        // @param B Second wide string view.
+        // @return True if A and B only differ in case.
+        bool operator()(const std::wstring_view A, const std::wstring_view B) const noexcept
+        {
+            return A.size() == B.size() && CompareI(A, B) == 0;
+        }
+    };
+
     // Converts double to string with precision.
     // @param Num Number.
     // @param Precision Decimal places (default 6).
@@ -1009,6 +2142,48 @@ namespace xstrtool
     // @return Hex string representation of SHA256 hash.
     std::string SHA256(const std::string_view Sv) noexcept;
 
+    // Converts every string of a batch to lowercase in-place (English ASCII only).
+    // Large batches are split across worker threads (see BatchHash for the grain size).
+    // @param Strings Strings to modify.
+    void BatchToLower(std::span<std::string> Strings) noexcept;
+
+    // Writes a lowercase copy of every string of a batch (English ASCII only), reusing the capacity of the outputs.
+    // @param Input Strings to convert.
+    // @param Output One string per input.
+    void BatchToLower(std::span<const std::string_view> Input, std::span<std::string> Output) noexcept;
+
+    // Trims the whitespace of both ends of every string of a batch in-place.
+    // @param Strings Strings to modify.
+    void BatchTrim(std::span<std::string> Strings) noexcept;
+
+    // Trims the whitespace of both ends of every view of a batch.
+    // @param Input Views to trim.
+    // @param Output One trimmed view per input (may be the same memory as Input).
+    void BatchTrim(std::span<const std::string_view> Input, std::span<std::string_view> Output) noexcept;
+
+    // Hashes every string of a batch (the same values as Hash).
+    // Batches are cut in chunks of roughly 256KB of work (each string also counts for its call overhead),
+    // so small batches run on the calling thread and large ones on up to one thread per core.
+    // @param Input Strings to hash.
+    // @param Output One hash per input.
+    void BatchHash(std::span<const std::string_view> Input, std::span<std::size_t> Output) noexcept;
+
+    // Hashes every string of a batch (the same values as Hash).
+    // @param Input Strings to hash.
+    // @param Output One hash per input.
+    void BatchHash(std::span<const std::string> Input, std::span<std::size_t> Output) noexcept;
+
+    // Computes the CRC32 of every string of a batch (the same values as CRC32).
+    // Four strings are processed at a time so their table lookups overlap.
+    // @param Input Strings to hash.
+    // @param Output One CRC32 per input.
+    void BatchCRC32(std::span<const std::string_view> Input, std::span<std::uint32_t> Output) noexcept;
+
+    // Computes the CRC32 of every string of a batch (the same values as CRC32).
+    // @param Input Strings to hash.
+    // @param Output One CRC32 per input.
+    void BatchCRC32(std::span<const std::string> Input, std::span<std::uint32_t> Output) noexcept;
+
     // Converts UTF-8 string to UTF-16 (wide string).
     // @param Utf8 UTF-8 string view.
     // @return UTF-16 wide string.
@@ -1019,27 +2194,125 @@ namespace xstrtool
     // @return UTF-8 string.
     std::string UTF16ToUTF8(const std::wstring_view Utf16) noexcept;
 
+    // Creates a case folded copy of a UTF-8 string (Unicode simple case folding, so "\xC3\x84RGER" becomes "\xC3\xA4rger").
+    // ASCII goes through the SIMD kernels; invalid bytes are copied as they are.
+    // @param Utf8 UTF-8 string view.
+    // @return Folded UTF-8 string (it can be shorter or longer than the input).
+    std::string FoldCaseU8Copy(const std::string_view Utf8) noexcept;
+
+    // Case-insensitive comparison of UTF-8 strings using Unicode simple case folding.
+    // @param A First UTF-8 string view.
+    // @param B Second UTF-8 string view.
+    // @return -1 if A < B, 0 if equal, 1 if A > B (ordered by folded code point).
+    int CompareIU8(const std::string_view A, const std::string_view B) noexcept;
+
+    // Case-insensitive find of a UTF-8 needle using Unicode simple case folding.
+    // Note that the matched part of the haystack may have a different byte length than the needle.
+    // @param Haystack UTF-8 string to search in.
+    // @param Needle UTF-8 string to find.
+    // @param Pos Starting byte position (default 0), must be at the start of a character.
+    // @return Byte position of the first match, or npos if not found (or Needle is empty).
+    std::size_t FindIU8(const std::string_view Haystack, const std::string_view Needle, const std::size_t Pos = 0) noexcept;
+
+    // Case mapping of a locale, built once and reused for many conversions. Converting with it does
+    // not touch the locale: the BMP goes through flat tables and ASCII runs through the SIMD kernels
+    // (characters above the BMP, only possible when wchar_t is 32 bits, still ask the locale).
+    class CaseMapper
+    {
+    public:
+        // Builds the case tables of a locale (two 64K entry tables), throws std::bad_alloc when they can not be allocated.
+        // @param Loc Locale for case conversion.
+        explicit CaseMapper(const std::locale& Loc);
+
+        // Gets the mapper of the system locale (std::locale("")), built on first use. Like std::locale("") it throws
+        // std::runtime_error when the system locale is not supported (the next call tries again).
+        // @return Shared mapper.
+        static const CaseMapper& System();
+
+        // Converts a single wide character to lowercase.
+        // @param Char The wide character to convert.
+        // @return The lowercase equivalent in the mapper's locale.
+        wchar_t ToLower(const wchar_t Char) const noexcept
+        {
+            return (static_cast<std::uint32_t>(Char) <= 0xFFFF) ? static_cast<wchar_t>(m_Lower[static_cast<std::uint32_t>(Char)]) : m_pCtype->tolower(Char);
+        }
+
+        // Converts a single wide character to uppercase.
+        // @param Char The wide character to convert.
+        // @return The uppercase equivalent in the mapper's locale.
+        wchar_t ToUpper(const wchar_t Char) const noexcept
+        {
+            return (static_cast<std::uint32_t>(Char) <= 0xFFFF) ? static_cast<wchar_t>(m_Upper[static_cast<std::uint32_t>(Char)]) : m_pCtype->toupper(Char);
+        }
+
+        // Converts Len wide characters to lowercase.
+        // @param pDest Output buffer of at least Len characters (may be pSrc).
+        // @param pSrc Input characters.
+        // @param Len Number of characters.
+        void ToLower(wchar_t* pDest, const wchar_t* pSrc, const std::size_t Len) const noexcept;
+
+        // Converts Len wide characters to uppercase.
+        // @param pDest Output buffer of at least Len characters (may be pSrc).
+        // @param pSrc Input characters.
+        // @param Len Number of characters.
+        void ToUpper(wchar_t* pDest, const wchar_t* pSrc, const std::size_t Len) const noexcept;
+
+    private:
+        template< bool T_TO_UPPER_V >
+        void Convert(wchar_t* pDest, const wchar_t* pSrc, const std::size_t Len) const noexcept;
+
+        std::locale                 m_Locale;           // Keeps m_pCtype alive
+        const std::ctype<wchar_t>*  m_pCtype;
+        std::vector<char16_t>       m_Lower;            // Indexed by BMP code point
+        std::vector<char16_t>       m_Upper;            // Indexed by BMP code point
+        bool                        m_bPlainAscii;      // ASCII maps like ToLower/ToUpper, so the SIMD kernels can do the ASCII runs
+    };
+
     // Creates a lowercase copy of the wide string_view using locale.
+    // Note that it looks up the ctype facet on every call, prefer the CaseMapper overload for repeated conversions.
     // @param InputView Input wide string view.
-    // @param Loc Locale for case conversion (default system locale).
+    // @param Loc Locale for case conversion.
     // @return Lowercase wide string copy.
-    std::wstring ToLowerLocale(const std::wstring_view InputView, const std::locale& Loc = std::locale("")) noexcept;
+    std::wstring ToLowerLocale(const std::wstring_view InputView, const std::locale& Loc) noexcept;
 
     // Converts wide string to lowercase in-place using locale.
     // @param Str Wide string to modify.
-    // @param Loc Locale for case conversion (default system locale).
-    void ToLowerLocale(std::wstring& Str, const std::locale& Loc = std::locale("")) noexcept;
+    // @param Loc Locale for case conversion.
+    void ToLowerLocale(std::wstring& Str, const std::locale& Loc) noexcept;
 
     // Creates an uppercase copy of the wide string_view using locale.
+    // Note that it looks up the ctype facet on every call, prefer the CaseMapper overload for repeated conversions.
     // @param InputView Input wide string view.
-    // @param Loc Locale for case conversion (default system locale).
+    // @param Loc Locale for case conversion.
     // @return Uppercase wide string copy.
-    std::wstring ToUpperLocale(const std::wstring_view InputView, const std::locale& Loc = std::locale("")) noexcept;
+    std::wstring ToUpperLocale(const std::wstring_view InputView, const std::locale& Loc) noexcept;
 
     // Converts wide string to uppercase in-place using locale.
     // @param Str Wide string to modify.
-    // @param Loc Locale for case conversion (default system locale).
-    void ToUpperLocale(std::wstring& Str, const std::locale& Loc = std::locale("")) noexcept;
+    // @param Loc Locale for case conversion.
+    void ToUpperLocale(std::wstring& Str, const std::locale& Loc) noexcept;
+
+    // Creates a lowercase copy of the wide string_view using a cached case mapper.
+    // @param InputView Input wide string view.
+    // @param Mapper Case mapper (default the system locale one).
+    // @return Lowercase wide string copy.
+    std::wstring ToLowerLocale(const std::wstring_view InputView, const CaseMapper& Mapper = CaseMapper::System()) noexcept;
+
+    // Converts wide string to lowercase in-place using a cached case mapper.
+    // @param Str Wide string to modify.
+    // @param Mapper Case mapper (default the system locale one).
+    void ToLowerLocale(std::wstring& Str, const CaseMapper& Mapper = CaseMapper::System()) noexcept;
+
+    // Creates an uppercase copy of the wide string_view using a cached case mapper.
+    // @param InputView Input wide string view.
+    // @param Mapper Case mapper (default the system locale one).
+    // @return Uppercase wide string copy.
+    std::wstring ToUpperLocale(const std::wstring_view InputView, const CaseMapper& Mapper = CaseMapper::System()) noexcept;
+
+    // Converts wide string to uppercase in-place using a cached case mapper.
+    // @param Str Wide string to modify.
+    // @param Mapper Case mapper (default the system locale one).
+    void ToUpperLocale(std::wstring& Str, const CaseMapper& Mapper = CaseMapper::System()) noexcept;
 
     // Converts string to double (fast, using std::from_chars).
     // @param Sv String view.